@@ -789,6 +789,20 @@ void hotConvert(hotCtx g);
 #define HOT_ADD_STUB_DSIG             (1 << 10)
 #define HOT_CONVERT_VERBOSE           (1 << 11)
 #define HOT_CONVERT_FINAL_NAMES       (1 << 12) /* When showing error messages, use final names rather than source names. */
+#define HOT_PROFILE                   (1 << 13) /* Record wall time and memory use per conversion phase, table, and lookup. See hotGetProfile(). */
+
+char *hotGetProfile(hotCtx g);
+
+/* hotGetProfile() returns the profile recorded by the last hotConvert() call
+   as a null-terminated JSON document, or NULL if the HOT_PROFILE convert flag
+   was not set. The document is a list of entries in the order they were
+   begun; each entry has a kind ("phase", "table", "write", or "lookup"), a
+   name, the index of its enclosing entry ("parent", -1 for the outermost),
+   the wall time in milliseconds, and the number of allocations, the bytes
+   allocated, and the peak bytes in use above the level at the start of the
+   entry, all counted through the library's memory functions. Child entries
+   are included in their parent's figures. The string remains valid until the
+   next call to hotConvert() or hotFree(). */
 
 /* hotFree() destroys the library context and all the resources allocated to
    it. It must be the last function called by a client of the library. */
@@ -454,13 +454,30 @@ static int glyphInClass(GID gid, GNode **cl, GNode ***lastClass) {
     return 0;
 }
 
+/* Copy a node's fields. Only the used part of lookupLabels is copied, */
+/* as the full array accounts for most of the size of a GNode.         */
+static inline void copyNode(GNode *dst, const GNode *src) {
+    dst->flags = src->flags;
+    dst->gid = src->gid;
+    dst->nextSeq = src->nextSeq;
+    dst->nextCl = src->nextCl;
+    dst->aaltIndex = src->aaltIndex;
+    dst->metricsInfo = src->metricsInfo;
+    dst->lookupLabelCount = src->lookupLabelCount;
+    if (src->lookupLabelCount > 0)
+        memcpy(dst->lookupLabels, src->lookupLabels,
+               sizeof(src->lookupLabels[0]) * src->lookupLabelCount);
+    dst->markClassName = src->markClassName;
+    dst->markClassAnchorInfo = src->markClassAnchorInfo;
+}
+
 /* Return address of last nextCl. Preserves everything */
 /* but sets nextSeq of each copied GNode to NULL       */
 GNode **FeatCtx::copyGlyphClass(GNode **dst, GNode *src) {
     GNode **newDst = dst;
     for (; src != NULL; src = src->nextCl) {
         *newDst = newNode();
-        **newDst = *src;
+        copyNode(*newDst, src);
         (*newDst)->nextSeq = NULL;
         newDst = &(*newDst)->nextCl;
     }
@@ -484,15 +501,43 @@ void FeatCtx::sortGlyphClass(GNode **list, bool unique, bool reportDups) {
     p->flags = 0;
 
     /* Copy over pointers */
-    std::vector<GNode *> sortTmp;
-
+    sortTmp.clear();
     for (; p != NULL; p = p->nextCl)
         sortTmp.push_back(p);
 
+    /* Classes are frequently already in GID order (ranges, and classes */
+    /* that have been sorted before) so check before sorting.           */
     struct {
         bool operator()(GNode *a, GNode *b) const { return a->gid < b->gid; }
     } cmpNode;
-    std::sort(sortTmp.begin(), sortTmp.end(), cmpNode);
+    if (!std::is_sorted(sortTmp.begin(), sortTmp.end(), cmpNode))
+        std::sort(sortTmp.begin(), sortTmp.end(), cmpNode);
+
+    /* Remove duplicates while the nodes are still in the vector */
+    if (unique && !g->hadError) {
+        size_t j = 0;
+        for (i = 0; i < sortTmp.size(); i++) {
+            GNode *tmp = sortTmp[i];
+            if (j == 0 || tmp->gid != sortTmp[j - 1]->gid) {
+                sortTmp[j++] = tmp;
+                continue;
+            }
+            tmp->nextCl = NULL;
+            tmp->nextSeq = NULL;
+
+            /* If current_visitor is null we are being called after the
+             * feature files have been closed. In this case, we are
+             * sorting GDEF classes, and duplicates don't need a
+             * warning. */
+            if ( current_visitor != nullptr && reportDups ) {
+                dumpGlyph(tmp->gid, '\0', 0);
+                featMsg(hotNOTE, "Removing duplicate glyph <%s>",
+                        g->note.array);
+            }
+            recycleNodes(tmp);
+        }
+        sortTmp.resize(j);
+    }
 
     /* Move pointers around */
     for (i = 0; i < sortTmp.size() - 1; i++)
@@ -501,32 +546,6 @@ void FeatCtx::sortGlyphClass(GNode **list, bool unique, bool reportDups) {
 
     *list = sortTmp[0];
 
-    /* Check for duplicates */
-    if (unique && !g->hadError) {
-        for (p = *list; p->nextCl != NULL;) {
-            if (p->gid == p->nextCl->gid) {
-                GNode *tmp = p->nextCl;
-
-                p->nextCl = tmp->nextCl;
-                tmp->nextCl = NULL;
-                tmp->nextSeq = NULL;
-
-                /* If current_visitor is null we are being called after the
-                 * feature files have been closed. In this case, we are
-                 * sorting GDEF classes, and duplicates don't need a
-                 * warning. */
-                if ( current_visitor != nullptr && reportDups ) {
-                    dumpGlyph(tmp->gid, '\0', 0);
-                    featMsg(hotNOTE, "Removing duplicate glyph <%s>",
-                            g->note.array);
-                }
-                recycleNodes(tmp);
-            } else {
-                p = p->nextCl;
-            }
-        }
-    }
-
     /*restore head node values to the new head node.*/
     p = *list;
     p->flags = flags;
@@ -381,6 +381,8 @@ class FeatCtx {
 
     // Temporary for cross product
     std::vector<GNode *> prod;
+    // Temporary for sortGlyphClass
+    std::vector<GNode *> sortTmp;
 
     hotCtx g;
     FeatVisitor *root_visitor {nullptr}, *current_visitor {nullptr};
@@ -15,6 +15,7 @@
 #include "STAT.h"
 #include "vhea.h"
 
+#include <iterator>
 #include <limits>
 #include <math.h>
 
@@ -56,10 +57,77 @@ FeatVisitor::~FeatVisitor() {
     // The tree pointer itself is managed by the parser
     delete parser;
     delete tokens;
+    delete cached_source;
     delete lexer;
     delete input;
 }
 
+// ------------------------------ Token Cache ---------------------------------
+
+std::mutex FeatVisitor::token_cache_mutex;
+std::unordered_map<size_t, std::shared_ptr<const FeatVisitor::CachedTokens>> FeatVisitor::token_cache;
+
+/* Replays a token snapshot. The tokens carry their own text so there is
+ * no input stream behind them. */
+class FeatVisitor::CachedTokenSource : public antlr4::TokenSource {
+ public:
+    CachedTokenSource(std::shared_ptr<const CachedTokens> ct,
+                      const std::string &name) : ct(ct), name(name) {}
+
+    std::unique_ptr<antlr4::Token> nextToken() override {
+        // The snapshot always ends with EOF, which is repeated as needed
+        const CachedToken &t = ct->tokens[i];
+        if ( i + 1 < ct->tokens.size() )
+            i++;
+        auto tok = std::make_unique<antlr4::CommonToken>(
+            std::make_pair(this, (antlr4::CharStream *) nullptr),
+            t.type, t.channel, t.start, t.stop);
+        tok->setText(t.text);
+        tok->setLine(t.line);
+        tok->setCharPositionInLine(t.charPos);
+        return tok;
+    }
+    size_t getLine() const override { return ct->tokens[i].line; }
+    size_t getCharPositionInLine() override { return ct->tokens[i].charPos; }
+    antlr4::CharStream *getInputStream() override { return nullptr; }
+    std::string getSourceName() override { return name; }
+    antlr4::TokenFactory<antlr4::CommonToken> *getTokenFactory() override {
+        return antlr4::CommonTokenFactory::DEFAULT.get();
+    }
+
+ private:
+    std::shared_ptr<const CachedTokens> ct;
+    std::string name;
+    size_t i {0};
+};
+
+std::shared_ptr<const FeatVisitor::CachedTokens> FeatVisitor::lookupTokens(const std::string &content,
+                                                                           size_t hash) {
+    std::lock_guard<std::mutex> lock(token_cache_mutex);
+    auto i = token_cache.find(hash);
+    if ( i == token_cache.end() || i->second->content != content )
+        return nullptr;
+    return i->second;
+}
+
+void FeatVisitor::storeTokens(std::string &content, size_t hash,
+                              antlr4::CommonTokenStream *ts) {
+    auto ct = std::make_shared<CachedTokens>();
+
+    ts->fill();
+    for (auto t : ts->getTokens()) {
+        ct->tokens.push_back({t->getType(), t->getChannel(), t->getStartIndex(),
+                              t->getStopIndex(), t->getLine(),
+                              t->getCharPositionInLine(), t->getText()});
+    }
+    if ( ct->tokens.empty() || ct->tokens.back().type != antlr4::Token::EOF )
+        return;
+    ct->content.swap(content);
+
+    std::lock_guard<std::mutex> lock(token_cache_mutex);
+    token_cache[hash] = ct;
+}
+
 // ----------------------------- Entry Points --------------------------------
 
 void FeatVisitor::Parse(bool do_includes) {
@@ -109,9 +177,19 @@ void FeatVisitor::Parse(bool do_includes) {
         assignDirName(fullname, dirname);
     }
 
-    input = new antlr4::ANTLRInputStream(stream);
-    lexer = new FeatLexer(input);
-    tokens = new antlr4::CommonTokenStream(lexer);
+    std::string content {std::istreambuf_iterator<char>(stream),
+                         std::istreambuf_iterator<char>()};
+    size_t hash = std::hash<std::string>{}(content);
+    auto ct = lookupTokens(content, hash);
+
+    if ( ct != nullptr ) {
+        cached_source = new CachedTokenSource(ct, pathname);
+        tokens = new antlr4::CommonTokenStream(cached_source);
+    } else {
+        input = new antlr4::ANTLRInputStream(content);
+        lexer = new FeatLexer(input);
+        tokens = new antlr4::CommonTokenStream(lexer);
+    }
     parser = new FeatParser(tokens);
     parser->removeErrorListeners();
     FeatErrorListener el{*this};
@@ -123,6 +201,11 @@ void FeatVisitor::Parse(bool do_includes) {
 
     parser->removeErrorListeners();
 
+    // Only remember token streams that lexed and parsed cleanly
+    if ( ct == nullptr && lexer->getNumberOfSyntaxErrors() == 0 &&
+         parser->getNumberOfSyntaxErrors() == 0 )
+        storeTokens(content, hash, tokens);
+
     if ( tree == nullptr || !do_includes ) {
         fc->current_visitor = nullptr;
         return;
@@ -140,6 +223,9 @@ void FeatVisitor::Translate() {
     fc->current_visitor = this;
     stage = vExtract;  // This will still parse includes if not already done
     include_ep = top_ep;
+    // Revisit the include visitors created by Parse() rather than parsing
+    // the included files again
+    current_include = 0;
     tree->accept(this);
     fc->current_visitor = nullptr;
 }
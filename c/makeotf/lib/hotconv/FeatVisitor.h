@@ -16,6 +16,9 @@
 #include <functional>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 /* Include handling:
  *
@@ -26,6 +29,17 @@
  * time.
  */
 
+/* Token caching:
+ *
+ * Families commonly share large included files (classes, kerning) across
+ * many masters. When more than one font is built in the same process the
+ * token stream of each file is remembered, keyed by a hash of the file
+ * contents, and replayed through a CachedTokenSource instead of re-lexing
+ * unchanged content. (Antlr's prediction DFA is already held in the
+ * generated parser's static data and so stays warm across builds in one
+ * process.)
+ */
+
 typedef antlr4::ParserRuleContext *(FeatParser::*FeatParsingEntry)();
 
 class FeatVisitor : public FeatParserBaseVisitor {
@@ -63,6 +77,23 @@ class FeatVisitor : public FeatParserBaseVisitor {
     // the tree
     enum Stage { vInclude = 1, vExtract } stage;
 
+    // Token stream snapshot and cache, see note above
+    struct CachedToken {
+        size_t type, channel, start, stop, line, charPos;
+        std::string text;
+    };
+    struct CachedTokens {
+        std::string content;
+        std::vector<CachedToken> tokens;
+    };
+    class CachedTokenSource;
+    static std::shared_ptr<const CachedTokens> lookupTokens(const std::string &content,
+                                                           size_t hash);
+    static void storeTokens(std::string &content, size_t hash,
+                            antlr4::CommonTokenStream *ts);
+    static std::mutex token_cache_mutex;
+    static std::unordered_map<size_t, std::shared_ptr<const CachedTokens>> token_cache;
+
     // Antlr 4 error reporting class
     struct FeatErrorListener : public antlr4::BaseErrorListener {
         FeatErrorListener() = delete;
@@ -240,6 +271,7 @@ class FeatVisitor : public FeatParserBaseVisitor {
      */
     antlr4::ANTLRInputStream *input {nullptr};
     FeatLexer *lexer {nullptr};
+    antlr4::TokenSource *cached_source {nullptr};
     antlr4::CommonTokenStream *tokens {nullptr};
     FeatParser *parser {nullptr};
     antlr4::tree::ParseTree *tree {nullptr};
@@ -812,6 +812,7 @@ void GPOSLookupEnd(hotCtx g, Tag feature) {
         h->otl = otlTableNew(g);
     }
 
+    hotProfBeg(g, "lookup", "GPOS %s", g->error_id_text);
     switch (h->new.lkpType) {
         case GPOSSingle:
             /* No need to test that at least one GPOSSingle rule exists. Can't get here if that is the case */
@@ -869,6 +870,7 @@ void GPOSLookupEnd(hotCtx g, Tag feature) {
     if (h->startNewPairPosSubtbl != 0) {
         h->startNewPairPosSubtbl = 0;
     }
+    hotProfEnd(g);
 }
 
 /* Performs no action but brackets feature calls */
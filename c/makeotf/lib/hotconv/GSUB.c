@@ -732,6 +732,7 @@ void GSUBLookupEnd(hotCtx g, Tag feature) {
         h->otl = otlTableNew(g);
     }
 
+    hotProfBeg(g, "lookup", "GSUB %s", g->error_id_text);
     switch (h->new.lkpType) {
         case GSUBSingle:
             fillSingle(g, h);
@@ -782,6 +783,7 @@ void GSUBLookupEnd(hotCtx g, Tag feature) {
     /* case where an empty GSUB feature is called for; because it is      */
     /* empty, the table type doesn't get correctly assigned, and the code */
     /* comes through here.                                                */
+    hotProfEnd(g);
 }
 
 /* Performs no action but brackets feature calls */
@@ -1020,10 +1022,17 @@ static void checkAndSortSingle(hotCtx g, GSUBCtx h) {
     }
 
     if (nDuplicates > 0) {
-        /* Duplicates sink to the bottom */
-        qsort(h->new.rules.array, h->new.rules.cnt, sizeof(SubstRule),
-              cmpSingle);
-        h->new.rules.cnt -= nDuplicates;
+        /* Squeeze out recycled duplicates; remaining rules stay sorted */
+        long j = 0;
+        for (i = 0; i < h->new.rules.cnt; i++) {
+            if (h->new.rules.array[i].targ != NULL) {
+                if (i != j) {
+                    h->new.rules.array[j] = h->new.rules.array[i];
+                }
+                j++;
+            }
+        }
+        h->new.rules.cnt = j;
     }
 }
 
@@ -400,12 +400,20 @@ struct hotCtx_ {
     char error_id_text[ID_TEXT_SIZE]; /* buffer for text identifying class and feature of error */
     short hadError;        /* Flags if error occurred */
     uint32_t convertFlags; /* flags for building final OTF. */
+    struct hotProfile_ *prof; /* Build profile (HOT_PROFILE), else NULL */
 };
 
 /* Functions */
 void CDECL hotMsg(hotCtx g, int level, const char *fmt, ...);
 void hotQuitOnError(hotCtx g);
 
+/* Profiling. hotProfBeg() opens a nested profile entry of the given kind
+   ("phase", "table", "write", "lookup") whose name is formatted from fmt;
+   hotProfEnd() closes the innermost entry. Both do nothing unless the
+   HOT_PROFILE convert flag is set. */
+void CDECL hotProfBeg(hotCtx g, const char *kind, const char *fmt, ...);
+void hotProfEnd(hotCtx g);
+
 void hotOut2(hotCtx g, short value);
 void hotOut3(hotCtx g, int32_t value);
 void hotOut4(hotCtx g, int32_t value);
@@ -21,6 +21,20 @@
 #include <math.h>
 #include <stdarg.h>
 
+/* Allocated size of a block, used for profiling peak memory */
+#if defined(_WIN32)
+#include <malloc.h>
+#define MEM_SIZE(p) _msize(p)
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#define MEM_SIZE(p) malloc_size(p)
+#elif defined(__GLIBC__)
+#include <malloc.h>
+#define MEM_SIZE(p) malloc_usable_size(p)
+#else
+#define MEM_SIZE(p) 0
+#endif
+
 /* Windows-specific macros */
 #define FAMILY_UNSET 255 /* Flags unset Windows Family field */
 #define ANSI_CHARSET 0
@@ -87,6 +101,7 @@ hotCtx hotNew(hotCallbacks *hotcb) {
 
     g->hadError = 0;
     g->convertFlags = 0;
+    g->prof = NULL;
 
     /* Set version numbers. The hot library version serves to identify the      */
     /* software version that built an OTF font and is saved in the Version name */
@@ -966,27 +981,56 @@ void patch_cff_fontbbox(hotCtx g) {
     data[offset + 11] = (g->font.bbox.top & 0xFF);
 }
 
+static void profNew(hotCtx g);
+static void profFree(hotCtx g);
+static void profMakeJSON(hotCtx g);
+
 /* Convert to OTF */
 void hotConvert(hotCtx g) {
     BBox old_bbox;
 
+    profFree(g);
+    if (g->convertFlags & HOT_PROFILE) {
+        profNew(g);
+    }
+    hotProfBeg(g, "phase", "hotConvert");
+
     old_bbox = g->font.bbox;
+    hotProfBeg(g, "phase", "setBounds");
     setBounds(g);
     if (bbox_changed(&old_bbox, &g->font.bbox)) {
         patch_cff_fontbbox(g);
     }
+    hotProfEnd(g);
+    hotProfBeg(g, "phase", "mapFill");
     mapFill(g);
+    hotProfEnd(g);
+    hotProfBeg(g, "phase", "featFill");
     featFill(g);
+    hotProfEnd(g);
 
+    hotProfBeg(g, "phase", "prepWinData");
     prepWinData(g);
+    hotProfEnd(g);
 
+    hotProfBeg(g, "phase", "setVBounds");
     setVBounds(g);
+    hotProfEnd(g);
 
     if (g->convertFlags & HOT_ADD_STUB_DSIG)
         hotAddAnonTable(g, TAG('D', 'S', 'I', 'G'), refillDSIG);
 
+    hotProfBeg(g, "phase", "sfntFill");
     sfntFill(g);
+    hotProfEnd(g);
+    hotProfBeg(g, "phase", "sfntWrite");
     sfntWrite(g);
+    hotProfEnd(g);
+
+    hotProfEnd(g);
+    if (g->prof != NULL) {
+        profMakeJSON(g);
+    }
 
 #if HOT_DEBUG
     if (g->font.debug & HOT_DB_AFM) {
@@ -1002,6 +1046,7 @@ void hotConvert(hotCtx g) {
 void hotFree(hotCtx g) {
     int i;
 
+    profFree(g);
     tcFree(g->ctx.tc);
     sfntFree(g);
     mapFree(g);
@@ -1409,24 +1454,240 @@ void hotAddAnonTable(hotCtx g, unsigned long tag, hotAnonRefill refill) {
 
 /* ---------------------------- Utility Functions --------------------------- */
 
+static void profAccount(hotCtx g, size_t oldSize, size_t newSize);
+
 void *hotMemNew(hotCtx g, size_t size) {
     void *ptr = malloc(size);
     if ( ptr == NULL )
         hotMsg(g, hotFATAL, "out of memory");
+    if (g->prof != NULL)
+        profAccount(g, 0, MEM_SIZE(ptr));
     return ptr;
 }
 
 void *hotMemResize(hotCtx g, void *old, size_t size) {
-    void *ptr = realloc(old, size);
+    size_t oldSize = 0;
+    void *ptr;
+    if (g->prof != NULL && old != NULL)
+        oldSize = MEM_SIZE(old);
+    ptr = realloc(old, size);
     if ( ptr == NULL )
         hotMsg(g, hotFATAL, "out of memory");
+    if (g->prof != NULL)
+        profAccount(g, oldSize, MEM_SIZE(ptr));
     return ptr;
 }
 
 void hotMemFree(hotCtx g, void *ptr) {
+    if (g->prof != NULL && ptr != NULL)
+        profAccount(g, MEM_SIZE(ptr), 0);
     free(ptr);
 }
 
+/* ------------------------------- Profiling ------------------------------- */
+
+/* The profile's own storage uses malloc() directly so that it neither shows
+   up in the figures nor moves while an allocation is being accounted. */
+
+#define PROF_NAME_SIZE 128
+
+typedef struct {
+    const char *kind;
+    char name[PROF_NAME_SIZE];
+    long parent;        /* Index of enclosing entry, or -1 */
+    double start;       /* Start time (seconds) */
+    double wall;        /* Elapsed time (seconds) */
+    long nAllocs;       /* Allocation and resize calls */
+    long long nBytes;   /* Bytes allocated */
+    long long base;     /* Live bytes at start */
+    long long peak;     /* High water mark of live bytes */
+} ProfEntry;
+
+struct hotProfile_ {
+    struct {
+        ProfEntry *array;
+        long cnt;
+        long size;
+    } entries;
+    long current;    /* Innermost open entry, or -1 */
+    long long live;  /* Bytes in use through hotMem*(), relative to start */
+    struct {
+        char *array;
+        long cnt;
+        long size;
+    } json;
+};
+
+static double profNow(void) {
+#if defined(_WIN32)
+    /* clock() measures wall time with the Microsoft C runtime */
+    return (double)clock() / CLOCKS_PER_SEC;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+#endif
+}
+
+static void profNew(hotCtx g) {
+    struct hotProfile_ *p = calloc(1, sizeof(struct hotProfile_));
+    if (p == NULL) {
+        hotMsg(g, hotFATAL, "out of memory");
+    }
+    p->current = -1;
+    g->prof = p;
+}
+
+static void profFree(hotCtx g) {
+    struct hotProfile_ *p = g->prof;
+    if (p == NULL) {
+        return;
+    }
+    g->prof = NULL;
+    free(p->entries.array);
+    free(p->json.array);
+    free(p);
+}
+
+static void profAccount(hotCtx g, size_t oldSize, size_t newSize) {
+    struct hotProfile_ *p = g->prof;
+    ProfEntry *e;
+
+    p->live += (long long)newSize - (long long)oldSize;
+    if (p->current < 0) {
+        return;
+    }
+    e = &p->entries.array[p->current];
+    if (newSize > 0) {
+        e->nAllocs++;
+        if (newSize > oldSize) {
+            e->nBytes += newSize - oldSize;
+        }
+    }
+    if (p->live > e->peak) {
+        e->peak = p->live;
+    }
+}
+
+void CDECL hotProfBeg(hotCtx g, const char *kind, const char *fmt, ...) {
+    struct hotProfile_ *p = g->prof;
+    ProfEntry *e;
+    va_list ap;
+
+    if (p == NULL) {
+        return;
+    }
+    if (p->entries.cnt == p->entries.size) {
+        long size = p->entries.size + 100;
+        ProfEntry *array = realloc(p->entries.array, size * sizeof(ProfEntry));
+        if (array == NULL) {
+            hotMsg(g, hotFATAL, "out of memory");
+        }
+        p->entries.array = array;
+        p->entries.size = size;
+    }
+    e = &p->entries.array[p->entries.cnt];
+    e->kind = kind;
+    va_start(ap, fmt);
+    vsnprintf(e->name, PROF_NAME_SIZE, fmt, ap);
+    va_end(ap);
+    e->parent = p->current;
+    e->wall = 0;
+    e->nAllocs = 0;
+    e->nBytes = 0;
+    e->base = e->peak = p->live;
+    p->current = p->entries.cnt++;
+    e->start = profNow();
+}
+
+void hotProfEnd(hotCtx g) {
+    struct hotProfile_ *p = g->prof;
+    ProfEntry *e;
+
+    if (p == NULL || p->current < 0) {
+        return;
+    }
+    e = &p->entries.array[p->current];
+    e->wall = profNow() - e->start;
+    p->current = e->parent;
+    if (e->parent >= 0) {
+        /* Roll up into enclosing entry */
+        ProfEntry *parent = &p->entries.array[e->parent];
+        parent->nAllocs += e->nAllocs;
+        parent->nBytes += e->nBytes;
+        if (e->peak > parent->peak) {
+            parent->peak = e->peak;
+        }
+    }
+}
+
+/* Append formatted text to the JSON buffer */
+static void CDECL profPrintf(hotCtx g, const char *fmt, ...) {
+    struct hotProfile_ *p = g->prof;
+    va_list ap;
+    int len;
+
+    va_start(ap, fmt);
+    len = vsnprintf(NULL, 0, fmt, ap);
+    va_end(ap);
+    if (p->json.cnt + len + 1 > p->json.size) {
+        long size = p->json.size + len + 4096;
+        char *array = realloc(p->json.array, size);
+        if (array == NULL) {
+            hotMsg(g, hotFATAL, "out of memory");
+        }
+        p->json.array = array;
+        p->json.size = size;
+    }
+    va_start(ap, fmt);
+    vsnprintf(p->json.array + p->json.cnt, len + 1, fmt, ap);
+    va_end(ap);
+    p->json.cnt += len;
+}
+
+/* Append JSON string literal */
+static void profPrintString(hotCtx g, const char *str) {
+    profPrintf(g, "\"");
+    for (; *str != '\0'; str++) {
+        unsigned char c = *str;
+        if (c == '"' || c == '\\') {
+            profPrintf(g, "\\%c", c);
+        } else if (c < 0x20) {
+            profPrintf(g, "\\u%04x", c);
+        } else {
+            profPrintf(g, "%c", c);
+        }
+    }
+    profPrintf(g, "\"");
+}
+
+static void profMakeJSON(hotCtx g) {
+    struct hotProfile_ *p = g->prof;
+    long i;
+
+    profPrintf(g, "{\n  \"version\": 1,\n  \"font\": ");
+    profPrintString(g, g->font.FontName.cnt > 0 ? g->font.FontName.array : "");
+    profPrintf(g, ",\n  \"entries\": [");
+    for (i = 0; i < p->entries.cnt; i++) {
+        ProfEntry *e = &p->entries.array[i];
+        profPrintf(g, "%s\n    {\"kind\": \"%s\", \"name\": ",
+                   i == 0 ? "" : ",", e->kind);
+        profPrintString(g, e->name);
+        profPrintf(g, ", \"parent\": %ld, \"wall_ms\": %.3f, \"allocs\": %ld, "
+                   "\"alloc_bytes\": %lld, \"peak_bytes\": %lld}",
+                   e->parent, e->wall * 1000, e->nAllocs, e->nBytes,
+                   e->peak - e->base);
+    }
+    profPrintf(g, "\n  ]\n}\n");
+}
+
+char *hotGetProfile(hotCtx g) {
+    if (g->prof == NULL || g->prof->json.array == NULL) {
+        return NULL;
+    }
+    return g->prof->json.array;
+}
+
 /* Call fatal if hadError is set (this is set by a hotMsg() hotERROR call) */
 void hotQuitOnError(hotCtx g) {
     if (g->hadError) {
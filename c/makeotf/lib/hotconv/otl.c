@@ -46,6 +46,7 @@ typedef struct {
 
 typedef struct {
     dnaDCL(GID, glyph); /* Covered glyph list */
+    uint32_t hash;      /* Hash of sorted glyph list, for matching tables */
     Offset offset;      /* Offset to coverage |=> start of coverage section */
     void *tbl;          /* Formatted table */
 } CoverageRecord;
@@ -91,6 +92,7 @@ typedef struct {
 
 typedef struct {
     dnaDCL(ClassMap, map); /* Class mappings */
+    uint32_t hash;         /* Hash of sorted mappings, for matching tables */
     Offset offset;         /* Offset to class |=> start of class section */
     void *tbl;             /* Formatted table */
 } ClassRecord;
@@ -653,24 +655,42 @@ static int CDECL cmpGlyphIds(const void *first, const void *second) {
     return 0;
 }
 
+/* FNV-1a hash step, used to match coverage and class tables */
+#define HASH_INIT 2166136261U
+#define HASH_STEP(h, v) (((h) ^ (uint32_t)(v)) * 16777619U)
+
 /* End coverage table; uniqueness of GIDs up to client. Sorting done here. */
 Offset otlCoverageEnd(hotCtx g, otlTbl t) {
     long i;
+    int sorted = 1;
+    uint32_t hash = HASH_INIT;
     CoverageRecord *new = t->coverage.new;
 
-    /* Sort glyph ids into increasing order */
-    qsort(new->glyph.array, new->glyph.cnt, sizeof(GID), cmpGlyphIds);
+    /* Sort glyph ids into increasing order. Clients usually supply them
+       sorted already. */
+    for (i = 1; i < new->glyph.cnt; i++) {
+        if (new->glyph.array[i - 1] > new->glyph.array[i]) {
+            sorted = 0;
+            break;
+        }
+    }
+    if (!sorted) {
+        qsort(new->glyph.array, new->glyph.cnt, sizeof(GID), cmpGlyphIds);
+    }
+
+    for (i = 0; i < new->glyph.cnt; i++) {
+        hash = HASH_STEP(hash, new->glyph.array[i]);
+    }
+    new->hash = hash;
 
     /* Check for matching table */
     for (i = 0; i < t->coverage.tables.cnt - 1; i++) {
         CoverageRecord *old = &t->coverage.tables.array[i];
 
-        if (new->glyph.cnt == old->glyph.cnt) {
-            long j;
-            for (j = 0; j < new->glyph.cnt; j++) {
-                if (new->glyph.array[j] != old->glyph.array[j]) {
-                    goto next;
-                }
+        if (new->hash == old->hash && new->glyph.cnt == old->glyph.cnt) {
+            if (memcmp(new->glyph.array, old->glyph.array,
+                       sizeof(GID) * new->glyph.cnt) != 0) {
+                continue;
             }
 
             /* Found match */
@@ -690,7 +710,6 @@ Offset otlCoverageEnd(hotCtx g, otlTbl t) {
             t->coverage.tables.cnt--; /* Remove new table */
             return old->offset;       /* Return matching table's offset */
         }
-    next:;
     }
 
     /* No match; fill table and return its offset  */
@@ -953,16 +972,32 @@ static int CDECL cmpClassMaps(const void *first, const void *second) {
 /* End class table */
 Offset otlClassEnd(hotCtx g, otlTbl t) {
     int i;
+    int sorted = 1;
+    uint32_t hash = HASH_INIT;
     ClassRecord *new = t->class.new;
 
     /* Sort glyph ids into increasing order */
-    qsort(new->map.array, new->map.cnt, sizeof(ClassMap), cmpClassMaps);
+    for (i = 1; i < new->map.cnt; i++) {
+        if (cmpClassMaps(&new->map.array[i - 1], &new->map.array[i]) > 0) {
+            sorted = 0;
+            break;
+        }
+    }
+    if (!sorted) {
+        qsort(new->map.array, new->map.cnt, sizeof(ClassMap), cmpClassMaps);
+    }
+
+    for (i = 0; i < new->map.cnt; i++) {
+        hash = HASH_STEP(hash, new->map.array[i].glyph);
+        hash = HASH_STEP(hash, new->map.array[i].class);
+    }
+    new->hash = hash;
 
     /* Check for matching table */
     for (i = 0; i < t->class.tables.cnt - 1; i++) {
         ClassRecord *old = &t->class.tables.array[i];
 
-        if (new->map.cnt == old->map.cnt) {
+        if (new->hash == old->hash && new->map.cnt == old->map.cnt) {
             int j;
             for (j = 0; j < new->map.cnt; j++) {
                 if (new->map.array[j].glyph != old->map.array[j].glyph ||
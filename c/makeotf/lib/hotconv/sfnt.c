@@ -151,10 +151,12 @@ void sfntFill(hotCtx g) {
     h->tbl.numTables = 0;
     for (i = 0; i < h->funcs.cnt; i++) {
         Funcs *funcs = &h->funcs.array[i];
+        hotProfBeg(g, "table", "%c%c%c%c", TAG_ARG(funcs->tag));
         if (funcs->fill(g)) {
             funcs->flags |= FUNC_WRITE;
             h->tbl.numTables++;
         }
+        hotProfEnd(g);
     }
 
     hotCalcSearchParams(ENTRY_SIZE, h->tbl.numTables, &h->tbl.searchRange,
@@ -199,7 +201,9 @@ static void writeTables(hotCtx g, unsigned long start) {
             unsigned long after;
             Entry *entry = dnaNEXT(h->tbl.directory);
 
+            hotProfBeg(g, "write", "%c%c%c%c", TAG_ARG(funcs->tag));
             funcs->write(g);
+            hotProfEnd(g);
             after = TELL();
 
             /* Pad to 4-byte boundary */
@@ -69,7 +69,7 @@ static struct {
     short fsSelectionMask_on;   /* mask for OR-ing with OS/2 table fsSelection.  */
     short fsSelectionMask_off;  /* mask for NAND-ing with OS/2 table fsSelection. */
     char *licenseID;
-} convert;
+} convert, familyConvert; /* familyConvert holds the options shared by family members */
 
 /* Script data */
 static struct {
@@ -77,8 +77,9 @@ static struct {
     dnaDCL(char *, args); /* Argument list */
 } script;
 
-/* Split font set file into arg list */
-static void makeArgs(char *filename) {
+/* Split font set file into arg list. If lineBreaks is set, a NULL entry
+   is added after the args of each non-empty line */
+static void makeArgs(char *filename, int lineBreaks) {
     int state;
     long i;
     long length;
@@ -104,6 +105,18 @@ static void makeArgs(char *filename) {
     state = 0;
     for (i = 0; i < length + 1; i++) {
         int c = script.buf[i];
+        if (lineBreaks && (c == '\n' || c == '\r') && state != 2 &&
+            (state == 3 || (script.args.cnt > 0 &&
+                            script.args.array[script.args.cnt - 1] != NULL))) {
+            /* End of member line; terminate any pending arg first */
+            if (state == 3) {
+                script.buf[i] = '\0';
+                *dnaNEXT(script.args) = start;
+            }
+            *dnaNEXT(script.args) = NULL;
+            state = 0;
+            continue;
+        }
         switch (state) {
             case 0:
                 switch (c) {
@@ -170,6 +183,11 @@ static void printUsage(void) {
         "-b : Specify that font has bold style.\n"
         "-i : Specify that font has italic style.\n"
         "-ff <path> : Specify path for feature file\n"
+        "-family <path> : Build several fonts in one process. Each line of the\n"
+        "    file holds the options for one font (at least -f, usually also -o and\n"
+        "    -ff). Options given before -family apply to every font; -family must\n"
+        "    be the last option. The FontMenuNameDB, GlyphOrderAndAliasDB and\n"
+        "    shared feature include files are only read once.\n"
         "-fs : If there are no GSUB rules, make a stub GSUB table.\n"
         "-mf <path> : Specify path for the FontMenuNameDB file. Required if the\n"
         "    '-r' option is used.\n"
@@ -243,6 +261,9 @@ static void printUsage(void) {
         "    non-zero left side kern classes. Using the optimization saves hundreds\n"
         "    to thousands of bytes and is the default behavior, but causes kerning to\n"
         "    not be seen by some applications.\n"
+        "-profile json : Record wall time, allocation count and peak memory for each\n"
+        "    conversion phase, table and lookup, and write them as JSON to\n"
+        "    <OTF path>.profile.json.\n"
         "-V : Show warnings about common, but usually not problematic, issues such as\n"
         "    a glyph having conflicting GDEF classes because it is used in more than\n"
         "    one class type in a layout table. Example: a glyph used as a base in one\n"
@@ -295,6 +316,35 @@ static void convFont(char *pfbfile, char *otffile) {
     }
 }
 
+static void parseArgs(int argc, char *argv[], int inScript);
+
+/* Convert a family of fonts in one process. Each line of the family file
+   holds the options for one member, at least -f and usually -o and -ff.
+   Options that precede -family are shared by all members. The callback and
+   library contexts (and with them the FontMenuNameDB, GlyphOrderAndAliasDB
+   and the feature file token cache) are reused for every member. */
+static void convFamily(char *filename) {
+    long i;
+    long beg = 0;
+
+    if (script.buf != NULL) {
+        cbFatal(cbctx, "can't have multiple scripts");
+    }
+    makeArgs(filename, 1);
+
+    familyConvert = convert;
+    for (i = 0; i < script.args.cnt; i++) {
+        if (script.args.array[i] != NULL) {
+            continue;
+        }
+        convert = familyConvert;
+        parseArgs(i - beg, &script.args.array[beg], 1);
+        beg = i + 1;
+    }
+    convert = familyConvert;
+    convert.fontDone = 1;
+}
+
 /* Parse argument list */
 static void parseArgs(int argc, char *argv[], int inScript) {
     int i;
@@ -459,6 +509,19 @@ static void parseArgs(int argc, char *argv[], int inScript) {
                                 convert.otherflags |= OTHERFLAGS_DO_ID2_GSUB_CHAIN_CONXT;
                                 break;
 
+                            case 'a': /* [-family] Process family file */
+                                if (strcmp(arg, "-family") != 0 || argsleft == 0) {
+                                    showUsage();
+                                }
+                                if (inScript) {
+                                    cbFatal(cbctx, "can't nest scripts");
+                                }
+                                if (argsleft > 1) {
+                                    cbFatal(cbctx, "-family must be the last option");
+                                }
+                                convFamily(argv[++i]);
+                                break;
+
                             case 'd': /* [-fd] Standard feature directory */
                                 if (arg[3] != '\0' || argsleft == 0) {
                                     showUsage();
@@ -603,6 +666,21 @@ static void parseArgs(int argc, char *argv[], int inScript) {
                         }
                         break;
 
+                    case 'p':
+                        if (!strcmp(arg, "-profile")) {
+                            if (argsleft == 0) {
+                                showUsage();
+                            }
+                            arg = argv[++i];
+                            if (strcmp(arg, "json") != 0) {
+                                cbFatal(cbctx, "unsupported profile format (%s)", arg);
+                            }
+                            convert.otherflags |= OTHERFLAGS_PROFILE;
+                        } else {
+                            cbFatal(cbctx, "unrecognized option (%s)", arg);
+                        }
+                        break;
+
                     case 'n': /* all the 'off' settings */
                         switch (arg[2]) {
                             case 'g': {
@@ -662,7 +740,7 @@ static void parseArgs(int argc, char *argv[], int inScript) {
                             if (script.buf != NULL) {
                                 cbFatal(cbctx, "can't have multiple scripts");
                             }
-                            makeArgs(argv[++i]);
+                            makeArgs(argv[++i], 0);
                             parseArgs(script.args.cnt, script.args.array, 1);
                         }
                         break;
@@ -1589,6 +1589,10 @@ void cbConvert(cbCtx h, int flags, char *clientVers,
         hotConvertFlags |= HOT_CONVERT_FINAL_NAMES;
     }
 
+    if (otherflags & OTHERFLAGS_PROFILE) {
+        hotConvertFlags |= HOT_PROFILE;
+    }
+
     hotSetConvertFlags(h->hot.ctx, hotConvertFlags);
 
     if (flags & HOT_RENAME) {
@@ -1679,6 +1683,22 @@ void cbConvert(cbCtx h, int flags, char *clientVers,
     fileOpen(&h->otf.file, h, otfpath, "w+b");
     hotConvert(h->hot.ctx);
     fileClose(&h->otf.file);
+
+    /* Write build profile next to the OTF file */
+    if (otherflags & OTHERFLAGS_PROFILE) {
+        char *profile = hotGetProfile(h->hot.ctx);
+        if (profile != NULL) {
+            char profpath[FILENAME_MAX + 1];
+            File file;
+            if (strlen(otfpath) + strlen(".profile.json") > FILENAME_MAX) {
+                cbFatal(h, "profile path too long [%s]", otfpath);
+            }
+            sprintf(profpath, "%s.profile.json", otfpath);
+            fileOpen(&file, h, profpath, "wb");
+            fileWriteN(&file, strlen(profile), profile);
+            fileClose(&file);
+        }
+    }
 }
 
 // Read font conversion database
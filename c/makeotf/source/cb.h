@@ -79,5 +79,6 @@ extern void message(void *ctx, int type, const char *text);
 #define OTHERFLAGS_ADD_STUB_DSIG (1 << 14)
 #define OTHERFLAGS_VERBOSE (1 << 15)
 #define OTHERFLAGS_FINAL_NAMES (1 << 16)
+#define OTHERFLAGS_PROFILE (1 << 17)
 
 #endif /* CB_H */
@@ -756,39 +756,62 @@ static void rotate_width(abfGlyphCallbacks *cb, float hAdv) {
     rotateInfo->savedGlyphCB.width(&rotateInfo->savedGlyphCB, hAdv);
 }
 
+/* Transform "cnt" points, stored as x,y pairs in "coords", in place. Each
+   point is computed exactly as TX() and TY() do, with the matrix held in
+   locals so the loop doesn't reload it for every coordinate. */
+static void transformPoints(RotateInfo *rotateInfo, int cnt, float *coords) {
+    float a = rotateInfo->curMatrix[0];
+    float b = rotateInfo->curMatrix[1];
+    float c = rotateInfo->curMatrix[2];
+    float d = rotateInfo->curMatrix[3];
+    float e = rotateInfo->curMatrix[4];
+    float f = rotateInfo->curMatrix[5];
+    int i;
+
+    for (i = 0; i < cnt * 2; i += 2) {
+        float x = coords[i];
+        float y = coords[i + 1];
+        coords[i] = RND(a * x + c * y + e);
+        coords[i + 1] = RND(b * x + d * y + f);
+    }
+}
+
 static void rotate_move(abfGlyphCallbacks *cb, float x0, float y0) {
-    float x, y;
+    float p[2];
     txCtx h = cb->indirect_ctx;
     RotateInfo *rotateInfo = (RotateInfo *)h->appSpecificInfo;
-    x = TX(x0, y0);
-    y = TY(x0, y0);
-    rotateInfo->savedGlyphCB.move(&rotateInfo->savedGlyphCB, x, y);
+    p[0] = x0;
+    p[1] = y0;
+    transformPoints(rotateInfo, 1, p);
+    rotateInfo->savedGlyphCB.move(&rotateInfo->savedGlyphCB, p[0], p[1]);
 }
 
 static void rotate_line(abfGlyphCallbacks *cb, float x1, float y1) {
-    float x, y;
+    float p[2];
     txCtx h = cb->indirect_ctx;
     RotateInfo *rotateInfo = (RotateInfo *)h->appSpecificInfo;
-    x = TX(x1, y1);
-    y = TY(x1, y1);
-    rotateInfo->savedGlyphCB.line(&rotateInfo->savedGlyphCB, x, y);
+    p[0] = x1;
+    p[1] = y1;
+    transformPoints(rotateInfo, 1, p);
+    rotateInfo->savedGlyphCB.line(&rotateInfo->savedGlyphCB, p[0], p[1]);
 }
 
 static void rotate_curve(abfGlyphCallbacks *cb,
                          float x1, float y1,
                          float x2, float y2,
                          float x3, float y3) {
-    float xn1, yn1, xn2, yn2, xn3, yn3;
+    float p[6];
     txCtx h = cb->indirect_ctx;
     RotateInfo *rotateInfo = (RotateInfo *)h->appSpecificInfo;
-    xn1 = TX(x1, y1);
-    yn1 = TY(x1, y1);
-    xn2 = TX(x2, y2);
-    yn2 = TY(x2, y2);
-    xn3 = TX(x3, y3);
-    yn3 = TY(x3, y3);
-
-    rotateInfo->savedGlyphCB.curve(&rotateInfo->savedGlyphCB, xn1, yn1, xn2, yn2, xn3, yn3);
+    p[0] = x1;
+    p[1] = y1;
+    p[2] = x2;
+    p[3] = y2;
+    p[4] = x3;
+    p[5] = y3;
+    transformPoints(rotateInfo, 3, p);
+
+    rotateInfo->savedGlyphCB.curve(&rotateInfo->savedGlyphCB, p[0], p[1], p[2], p[3], p[4], p[5]);
 }
 
 static void rotate_stem(abfGlyphCallbacks *cb,
@@ -886,29 +909,30 @@ static void rotate_flex(abfGlyphCallbacks *cb, float depth,
                         float x4, float y4,
                         float x5, float y5,
                         float x6, float y6) {
-    float xn1, yn1, xn2, yn2, xn3, yn3, xn4, yn4, xn5, yn5, xn6, yn6;
+    float p[12];
     txCtx h = cb->indirect_ctx;
     RotateInfo *rotateInfo = (RotateInfo *)h->appSpecificInfo;
-    xn1 = TX(x1, y1);
-    yn1 = TY(x1, y1);
-    xn2 = TX(x2, y2);
-    yn2 = TY(x2, y2);
-    xn3 = TX(x3, y3);
-    yn3 = TY(x3, y3);
-    xn4 = TX(x4, y4);
-    yn4 = TY(x4, y4);
-    xn5 = TX(x5, y5);
-    yn5 = TY(x5, y5);
-    xn6 = TX(x6, y6);
-    yn6 = TY(x6, y6);
+    p[0] = x1;
+    p[1] = y1;
+    p[2] = x2;
+    p[3] = y2;
+    p[4] = x3;
+    p[5] = y3;
+    p[6] = x4;
+    p[7] = y4;
+    p[8] = x5;
+    p[9] = y5;
+    p[10] = x6;
+    p[11] = y6;
+    transformPoints(rotateInfo, 6, p);
 
     rotateInfo->savedGlyphCB.flex(&rotateInfo->savedGlyphCB, depth,
-                                  xn1, yn1,
-                                  xn2, yn2,
-                                  xn3, yn3,
-                                  xn4, yn4,
-                                  xn5, yn5,
-                                  xn6, yn6);
+                                  p[0], p[1],
+                                  p[2], p[3],
+                                  p[4], p[5],
+                                  p[6], p[7],
+                                  p[8], p[9],
+                                  p[10], p[11]);
 }
 
 static void rotate_genop(abfGlyphCallbacks *cb, int cnt, float *args, int op) {
@@ -1016,6 +1040,12 @@ static void rotateLoadGlyphList(txCtx h, char *filePath) {
 
 static void setupRotationCallbacks(txCtx h) {
     RotateInfo *rotateInfo = (RotateInfo *)h->appSpecificInfo;
+
+    /* Already installed by an earlier font in the same file, e.g. a
+       collection; installing them again would make them call themselves. */
+    if (h->cb.glyph.beg == rotate_beg)
+        return;
+
     rotateInfo->savedGlyphCB = h->cb.glyph;
     h->cb.glyph.indirect_ctx = h;
     h->cb.glyph.beg = rotate_beg;
@@ -1036,7 +1066,7 @@ static void setupRotationCallbacks(txCtx h) {
     h->cb.glyph.end = rotate_end;
     rotateInfo->endfont = h->dst.endfont;
     h->dst.endfont = rotateEndFont;
-    if (rotateInfo->rtFile[0] != 0)
+    if (rotateInfo->rtFile[0] != 0 && rotateInfo->rotateGlyphEntries.cnt == 0)
         rotateLoadGlyphList(h, rotateInfo->rtFile);
 }
 
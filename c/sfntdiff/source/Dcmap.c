@@ -0,0 +1,433 @@
+/* Copyright 2014 Adobe Systems Incorporated (http://www.adobe.com/). All Rights Reserved.
+   This software is licensed as OpenSource, under the Apache License, Version 2.0.
+   This license is available at: http://opensource.org/licenses/Apache-2.0. */
+
+/*
+ * Each encoding subtable is decoded into a sorted list of code to glyph
+ * mappings so that fonts whose cmaps were built differently (segmentation,
+ * format, subtable sharing) but map the same characters compare equal, and
+ * differences are reported per code. Subtable formats that don't map single
+ * codes (2, 8, 10 and 14) are compared as raw bytes.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Dcmap.h"
+#include "sfnt_cmap.h"
+#include "Dsfnt.h"
+
+typedef struct
+{
+    Card32 code;
+    GlyphId glyphId;
+} Mapping;
+
+typedef struct
+{
+    Card16 platformId;
+    Card16 scriptId;
+    Card16 format;
+    Card32 languageId;
+    da_DCL(Mapping, map); /* Sorted by code; glyph 0 omitted */
+    Card32 length;        /* Raw subtable for unmapped formats */
+    Card8 *data;
+} Subtable;
+
+typedef struct
+{
+    Card16 version;
+    Card16 nEncodings;
+    Subtable *subtable; /* [nEncodings] */
+} cmapMaps;
+
+static cmapMaps cmap1;
+static cmapMaps cmap2;
+static IntX loaded1 = 0;
+static IntX loaded2 = 0;
+
+/* Add mapping */
+static void addMapping(Subtable *sub, Card32 code, GlyphId glyphId) {
+    Mapping *mapping;
+
+    if (glyphId == 0)
+        return;
+    mapping = da_NEXT(sub->map);
+    mapping->code = code;
+    mapping->glyphId = glyphId;
+}
+
+static void readFormat0(Card8 which, Subtable *sub) {
+    Card16 length;
+    Card16 languageId;
+    IntX i;
+
+    IN(which, length);
+    IN(which, languageId);
+    sub->languageId = languageId;
+    for (i = 0; i < 256; i++) {
+        Card8 glyphId;
+        IN(which, glyphId);
+        addMapping(sub, i, glyphId);
+    }
+}
+
+static void readFormat4(Card8 which, Subtable *sub) {
+    Card16 length;
+    Card16 languageId;
+    Card16 segCountX2;
+    Card16 segCount;
+    Card16 searchRange;
+    Card16 entrySelector;
+    Card16 rangeShift;
+    Card16 password;
+    Card16 *endCode;
+    Card16 *startCode;
+    Int16 *idDelta;
+    Card16 *idRangeOffset;
+    GlyphId *glyphId;
+    Int32 nGlyphIds;
+    IntX i;
+
+    IN(which, length);
+    IN(which, languageId);
+    sub->languageId = languageId;
+    IN(which, segCountX2);
+    IN(which, searchRange);
+    IN(which, entrySelector);
+    IN(which, rangeShift);
+
+    segCount = segCountX2 / 2;
+    nGlyphIds = ((Int32)length - 16 - segCount * 8) / 2;
+    if (nGlyphIds < 0)
+        nGlyphIds = 0;
+
+    endCode = memNew(sizeof(endCode[0]) * (segCount + 1));
+    startCode = memNew(sizeof(startCode[0]) * (segCount + 1));
+    idDelta = memNew(sizeof(idDelta[0]) * (segCount + 1));
+    idRangeOffset = memNew(sizeof(idRangeOffset[0]) * (segCount + 1));
+    glyphId = memNew(sizeof(glyphId[0]) * (nGlyphIds + 1));
+
+    for (i = 0; i < segCount; i++)
+        IN(which, endCode[i]);
+    IN(which, password);
+    for (i = 0; i < segCount; i++)
+        IN(which, startCode[i]);
+    for (i = 0; i < segCount; i++)
+        IN(which, idDelta[i]);
+    for (i = 0; i < segCount; i++)
+        IN(which, idRangeOffset[i]);
+    for (i = 0; i < nGlyphIds; i++)
+        IN(which, glyphId[i]);
+
+    for (i = 0; i < segCount; i++) {
+        Card32 code;
+
+        if (startCode[i] == 0xffff)
+            continue; /* Terminating segment */
+        for (code = startCode[i]; code <= endCode[i]; code++) {
+            GlyphId gid;
+
+            if (idRangeOffset[i] == 0)
+                gid = (GlyphId)(code + idDelta[i]);
+            else {
+                Int32 index = i + idRangeOffset[i] / 2 + (code - startCode[i]) - segCount;
+                if (index < 0 || index >= nGlyphIds)
+                    continue;
+                gid = glyphId[index];
+                if (gid != 0)
+                    gid = (GlyphId)(gid + idDelta[i]);
+            }
+            addMapping(sub, code, gid);
+        }
+    }
+
+    memFree(endCode);
+    memFree(startCode);
+    memFree(idDelta);
+    memFree(idRangeOffset);
+    memFree(glyphId);
+}
+
+static void readFormat6(Card8 which, Subtable *sub) {
+    Card16 length;
+    Card16 languageId;
+    Card16 firstCode;
+    Card16 entryCount;
+    IntX i;
+
+    IN(which, length);
+    IN(which, languageId);
+    sub->languageId = languageId;
+    IN(which, firstCode);
+    IN(which, entryCount);
+    for (i = 0; i < entryCount; i++) {
+        GlyphId glyphId;
+        IN(which, glyphId);
+        addMapping(sub, firstCode + i, glyphId);
+    }
+}
+
+/* Formats 12 and 13 only differ in whether glyphs step through a group */
+static void readFormat12(Card8 which, Subtable *sub) {
+    Card16 reserved;
+    Card32 length;
+    Card32 nGroups;
+    Card32 i;
+
+    IN(which, reserved);
+    IN(which, length);
+    IN(which, sub->languageId);
+    IN(which, nGroups);
+    for (i = 0; i < nGroups; i++) {
+        Card32 startCharCode;
+        Card32 endCharCode;
+        Card32 startGlyphId;
+        Card32 code;
+
+        IN(which, startCharCode);
+        IN(which, endCharCode);
+        IN(which, startGlyphId);
+        if (endCharCode > 0x10ffff)
+            endCharCode = 0x10ffff;
+        for (code = startCharCode; code <= endCharCode; code++)
+            addMapping(sub, code, (GlyphId)(sub->format == 12 ? startGlyphId + (code - startCharCode) : startGlyphId));
+    }
+}
+
+/* Read subtable that isn't decoded as raw bytes */
+static void readRaw(Card8 which, Subtable *sub, LongN start) {
+    Card16 length16;
+    Card32 length32;
+
+    switch (sub->format) {
+        case 8:
+        case 10:
+            IN(which, length16); /* Reserved */
+            IN(which, length32);
+            break;
+        case 14:
+            IN(which, length32);
+            break;
+        default:
+            IN(which, length16);
+            length32 = length16;
+            break;
+    }
+    sub->length = length32;
+    sub->data = memNew(length32);
+    SEEK_ABS(which, start);
+    IN_BYTES(which, length32, sub->data);
+}
+
+static int cmpMappings(const void *first, const void *second) {
+    const Mapping *a = first;
+    const Mapping *b = second;
+    if (a->code < b->code)
+        return -1;
+    else if (a->code > b->code)
+        return 1;
+    return 0;
+}
+
+void cmapRead(Card8 which, LongN start, Card32 length) {
+    cmapMaps *cmap = NULL;
+    IntX i;
+
+    if (which == 1) {
+        if (loaded1)
+            return;
+        else
+            cmap = &cmap1;
+    } else if (which == 2) {
+        if (loaded2)
+            return;
+        else
+            cmap = &cmap2;
+    }
+
+    SEEK_ABS(which, start);
+
+    IN(which, cmap->version);
+    IN(which, cmap->nEncodings);
+
+    cmap->subtable = memNew(sizeof(Subtable) * (cmap->nEncodings + 1));
+    for (i = 0; i < cmap->nEncodings; i++) {
+        Subtable *sub = &cmap->subtable[i];
+        Card32 offset;
+        Card32 save;
+
+        IN(which, sub->platformId);
+        IN(which, sub->scriptId);
+        IN(which, offset);
+        save = TELL(which);
+
+        da_INIT(sub->map, 256, 1024);
+        sub->languageId = 0;
+        sub->length = 0;
+        sub->data = NULL;
+
+        SEEK_ABS(which, start + offset);
+        IN(which, sub->format);
+        switch (sub->format) {
+            case 0:
+                readFormat0(which, sub);
+                break;
+            case 4:
+                readFormat4(which, sub);
+                break;
+            case 6:
+                readFormat6(which, sub);
+                break;
+            case 12:
+            case 13:
+                readFormat12(which, sub);
+                break;
+            default:
+                readRaw(which, sub, start + offset);
+                break;
+        }
+        if (sub->map.cnt > 1)
+            qsort(sub->map.array, sub->map.cnt, sizeof(Mapping), cmpMappings);
+
+        SEEK_ABS(which, save);
+    }
+
+    if (which == 1)
+        loaded1 = 1;
+    else if (which == 2)
+        loaded2 = 1;
+}
+
+/* Find matching encoding in other font */
+static Subtable *findSubtable(cmapMaps *cmap, Subtable *sub) {
+    IntX i;
+    for (i = 0; i < cmap->nEncodings; i++) {
+        Subtable *other = &cmap->subtable[i];
+        if (other->platformId == sub->platformId &&
+            other->scriptId == sub->scriptId &&
+            other->languageId == sub->languageId)
+            return other;
+    }
+    return NULL;
+}
+
+static void noteEncoding(Byte8 *side, Subtable *sub, Byte8 *state) {
+    note("%s cmap encoding={platId=%2hu, scriptId=%2hu, language=%lu} %s\n",
+         side, sub->platformId, sub->scriptId, sub->languageId, state);
+}
+
+static void noteMapping(Byte8 *side, Card8 which, Subtable *sub, Mapping *mapping,
+                        Card32 code) {
+    if (mapping == NULL)
+        note("%s cmap[%hu,%hu] 0x%04lx unmapped\n",
+             side, sub->platformId, sub->scriptId, code);
+    else
+        note("%s cmap[%hu,%hu] 0x%04lx=%s\n",
+             side, sub->platformId, sub->scriptId, code,
+             getGlyphName(which, mapping->glyphId));
+}
+
+/* Compare the code to glyph mappings of a pair of matching subtables */
+static void diffSubtables(Subtable *sub1, Subtable *sub2) {
+    long i = 0;
+    long j = 0;
+
+    if (sub1->data != NULL || sub2->data != NULL) {
+        if (sub1->format != sub2->format ||
+            sub1->length != sub2->length ||
+            memcmp(sub1->data, sub2->data, sub1->length) != 0) {
+            DiffExists++;
+            note("< cmap[%hu,%hu] format=%hu length=%lu\n",
+                 sub1->platformId, sub1->scriptId, sub1->format, sub1->length);
+            note("> cmap[%hu,%hu] format=%hu length=%lu\n",
+                 sub2->platformId, sub2->scriptId, sub2->format, sub2->length);
+        }
+        return;
+    }
+
+    while (i < sub1->map.cnt || j < sub2->map.cnt) {
+        Mapping *mapping1 = (i < sub1->map.cnt) ? &sub1->map.array[i] : NULL;
+        Mapping *mapping2 = (j < sub2->map.cnt) ? &sub2->map.array[j] : NULL;
+
+        if (mapping2 == NULL || (mapping1 != NULL && mapping1->code < mapping2->code)) {
+            DiffExists++;
+            noteMapping("<", 1, sub1, mapping1, mapping1->code);
+            noteMapping(">", 2, sub2, NULL, mapping1->code);
+            i++;
+        } else if (mapping1 == NULL || mapping2->code < mapping1->code) {
+            DiffExists++;
+            noteMapping("<", 1, sub1, NULL, mapping2->code);
+            noteMapping(">", 2, sub2, mapping2, mapping2->code);
+            j++;
+        } else {
+            if (mapping1->glyphId != mapping2->glyphId) {
+                DiffExists++;
+                noteMapping("<", 1, sub1, mapping1, mapping1->code);
+                noteMapping(">", 2, sub2, mapping2, mapping2->code);
+            }
+            i++;
+            j++;
+        }
+    }
+}
+
+void cmapDiff(LongN offset1, LongN offset2) {
+    IntX i;
+
+    if (!loaded1 || !loaded2)
+        return;
+
+    if (cmap1.version != cmap2.version) {
+        DiffExists++;
+        note("< cmap version=%hu\n", cmap1.version);
+        note("> cmap version=%hu\n", cmap2.version);
+    }
+
+    for (i = 0; i < cmap1.nEncodings; i++) {
+        Subtable *sub1 = &cmap1.subtable[i];
+        Subtable *sub2 = findSubtable(&cmap2, sub1);
+
+        if (sub2 == NULL) {
+            DiffExists++;
+            noteEncoding("<", sub1, "present");
+            noteEncoding(">", sub1, "missing");
+        } else
+            diffSubtables(sub1, sub2);
+    }
+
+    for (i = 0; i < cmap2.nEncodings; i++) {
+        Subtable *sub2 = &cmap2.subtable[i];
+
+        if (findSubtable(&cmap1, sub2) == NULL) {
+            DiffExists++;
+            noteEncoding("<", sub2, "missing");
+            noteEncoding(">", sub2, "present");
+        }
+    }
+}
+
+void cmapFree(Card8 which) {
+    cmapMaps *cmap = NULL;
+    IntX i;
+
+    if (which == 1) {
+        if (!loaded1)
+            return;
+        cmap = &cmap1;
+        loaded1 = 0;
+    } else if (which == 2) {
+        if (!loaded2)
+            return;
+        cmap = &cmap2;
+        loaded2 = 0;
+    }
+
+    for (i = 0; i < cmap->nEncodings; i++) {
+        Subtable *sub = &cmap->subtable[i];
+        da_FREE(sub->map);
+        if (sub->data != NULL)
+            memFree(sub->data);
+    }
+    memFree(cmap->subtable);
+}
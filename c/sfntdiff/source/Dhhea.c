@@ -0,0 +1,85 @@
+/* Copyright 2014 Adobe Systems Incorporated (http://www.adobe.com/). All Rights Reserved.
+   This software is licensed as OpenSource, under the Apache License, Version 2.0.
+   This license is available at: http://opensource.org/licenses/Apache-2.0. */
+
+#include "Dhhea.h"
+#include "sfnt_hhea.h"
+#include "Dsfnt.h"
+
+static hheaTbl hhea1;
+static hheaTbl hhea2;
+static IntX loaded1 = 0;
+static IntX loaded2 = 0;
+
+void hheaRead(Card8 which, LongN start, Card32 length) {
+    hheaTbl *hhea = NULL;
+
+    if (which == 1) {
+        if (loaded1)
+            return;
+        else
+            hhea = &hhea1;
+    } else if (which == 2) {
+        if (loaded2)
+            return;
+        else
+            hhea = &hhea2;
+    }
+
+    SEEK_ABS(which, start);
+
+    IN(which, hhea->version);
+    IN(which, hhea->ascender);
+    IN(which, hhea->descender);
+    IN(which, hhea->lineGap);
+    IN(which, hhea->advanceWidthMax);
+    IN(which, hhea->minLeftSideBearing);
+    IN(which, hhea->minRightSideBearing);
+    IN(which, hhea->xMaxExtent);
+    IN(which, hhea->caretSlopeRise);
+    IN(which, hhea->caretSlopeRun);
+    IN(which, hhea->caretOffset);
+    IN(which, hhea->reserved[0]);
+    IN(which, hhea->reserved[1]);
+    IN(which, hhea->reserved[2]);
+    IN(which, hhea->reserved[3]);
+    IN(which, hhea->metricDataFormat);
+    IN(which, hhea->numberOfLongHorMetrics);
+
+    if (which == 1)
+        loaded1 = 1;
+    else if (which == 2)
+        loaded2 = 1;
+}
+
+void hheaFree(Card8 which) {
+    if (which == 1)
+        loaded1 = 0;
+    else if (which == 2)
+        loaded2 = 0;
+}
+
+IntX hheaGetNLongHorMetrics(Card8 which, Card16 *nLongHorMetrics, Card32 client) {
+    hheaTbl *hhea = NULL;
+
+    if (which == 1) {
+        if (!loaded1) {
+            if (sfntReadATable(which, hhea_)) {
+                tableMissing(hhea_, client);
+                return 1;
+            }
+        }
+        hhea = &hhea1;
+    } else if (which == 2) {
+        if (!loaded2) {
+            if (sfntReadATable(which, hhea_)) {
+                tableMissing(hhea_, client);
+                return 1;
+            }
+        }
+        hhea = &hhea2;
+    }
+
+    *nLongHorMetrics = hhea->numberOfLongHorMetrics;
+    return 0;
+}
@@ -0,0 +1,19 @@
+/* Copyright 2014 Adobe Systems Incorporated (http://www.adobe.com/). All Rights Reserved.
+   This software is licensed as OpenSource, under the Apache License, Version 2.0.
+   This license is available at: http://opensource.org/licenses/Apache-2.0. */
+
+/*
+ * hhea table support.
+ */
+
+#ifndef DHHEA_H
+#define DHHEA_H
+
+#include "Dglobal.h"
+
+extern void hheaRead(Card8 which, LongN offset, Card32 length);
+extern void hheaFree(Card8 which);
+
+extern IntX hheaGetNLongHorMetrics(Card8 which, Card16 *nLongHorMetrics, Card32 client);
+
+#endif /* DHHEA_H */
@@ -0,0 +1,142 @@
+/* Copyright 2014 Adobe Systems Incorporated (http://www.adobe.com/). All Rights Reserved.
+   This software is licensed as OpenSource, under the Apache License, Version 2.0.
+   This license is available at: http://opensource.org/licenses/Apache-2.0. */
+
+#include "Dhmtx.h"
+#include "Dhhea.h"
+#include "Dmaxp.h"
+#include "sfnt_hmtx.h"
+#include "Dsfnt.h"
+
+/* Metrics are expanded to one LongHorMetrics record per glyph so that the
+   two fonts can be compared glyph by glyph whatever their number of long
+   metrics. Without an hhea table the metrics can't be decoded, and the
+   table is compared byte by byte instead. */
+typedef struct
+{
+    LongN start;
+    Card32 length;
+    Card16 nGlyphs;
+    LongHorMetrics *hMetrics; /* [nGlyphs]; NULL if not decoded */
+} Metrics;
+
+static Metrics hmtx1;
+static Metrics hmtx2;
+static IntX loaded1 = 0;
+static IntX loaded2 = 0;
+
+void hmtxRead(Card8 which, LongN start, Card32 length) {
+    Metrics *hmtx = NULL;
+    Card16 nLongHorMetrics;
+    Card16 numGlyphs;
+    Card32 nGlyphs;
+    IntX i;
+
+    if (which == 1) {
+        if (loaded1)
+            return;
+        else
+            hmtx = &hmtx1;
+    } else if (which == 2) {
+        if (loaded2)
+            return;
+        else
+            hmtx = &hmtx2;
+    }
+
+    hmtx->start = start;
+    hmtx->length = length;
+    hmtx->nGlyphs = 0;
+    hmtx->hMetrics = NULL;
+
+    if (hheaGetNLongHorMetrics(which, &nLongHorMetrics, hmtx_) == 0) {
+        if (length < nLongHorMetrics * (Card32)sizeof(LongHorMetrics)) {
+            warning("hmtx table is too short for %hu long metrics (ignored)\n",
+                    nLongHorMetrics);
+            nLongHorMetrics = (Card16)(length / sizeof(LongHorMetrics));
+        }
+
+        /* The glyph count comes from maxp; the table length, which may
+           include padding, is only used when maxp is missing */
+        nGlyphs = nLongHorMetrics +
+                  (length - nLongHorMetrics * sizeof(LongHorMetrics)) / sizeof(FWord);
+        if (maxpGetNGlyphs(which, &numGlyphs) == 0) {
+            if (numGlyphs < nLongHorMetrics)
+                numGlyphs = nLongHorMetrics;
+            if (numGlyphs > nGlyphs)
+                warning("hmtx table is too short for %hu glyphs (ignored)\n",
+                        numGlyphs);
+            else
+                nGlyphs = numGlyphs;
+        }
+        if (nGlyphs > 65535)
+            nGlyphs = 65535;
+
+        hmtx->nGlyphs = (Card16)nGlyphs;
+        hmtx->hMetrics = memNew(sizeof(LongHorMetrics) * (nGlyphs + 1));
+
+        SEEK_ABS(which, start);
+        for (i = 0; i < nLongHorMetrics; i++) {
+            IN(which, hmtx->hMetrics[i].advanceWidth);
+            IN(which, hmtx->hMetrics[i].lsb);
+        }
+        for (; i < (IntX)nGlyphs; i++) {
+            hmtx->hMetrics[i].advanceWidth =
+                (nLongHorMetrics > 0) ? hmtx->hMetrics[nLongHorMetrics - 1].advanceWidth : 0;
+            IN(which, hmtx->hMetrics[i].lsb);
+        }
+    }
+
+    if (which == 1)
+        loaded1 = 1;
+    else if (which == 2)
+        loaded2 = 1;
+}
+
+void hmtxDiff(LongN offset1, LongN offset2) {
+    IntX i;
+    Card16 nGlyphs;
+
+    if (!loaded1 || !loaded2)
+        return;
+
+    if (hmtx1.hMetrics == NULL || hmtx2.hMetrics == NULL) {
+        hexDiff(hmtx_, hmtx1.start, hmtx1.length, hmtx2.start, hmtx2.length);
+        return;
+    }
+
+    if (hmtx1.nGlyphs != hmtx2.nGlyphs) {
+        DiffExists++;
+        note("< hmtx nGlyphs=%hu\n", hmtx1.nGlyphs);
+        note("> hmtx nGlyphs=%hu\n", hmtx2.nGlyphs);
+    }
+
+    nGlyphs = (hmtx1.nGlyphs < hmtx2.nGlyphs) ? hmtx1.nGlyphs : hmtx2.nGlyphs;
+    for (i = 0; i < nGlyphs; i++) {
+        LongHorMetrics *metrics1 = &hmtx1.hMetrics[i];
+        LongHorMetrics *metrics2 = &hmtx2.hMetrics[i];
+
+        if (metrics1->advanceWidth != metrics2->advanceWidth ||
+            metrics1->lsb != metrics2->lsb) {
+            DiffExists++;
+            note("< hmtx[%d]={advanceWidth=%hu, lsb=%hd}\n",
+                 i, metrics1->advanceWidth, metrics1->lsb);
+            note("> hmtx[%d]={advanceWidth=%hu, lsb=%hd}\n",
+                 i, metrics2->advanceWidth, metrics2->lsb);
+        }
+    }
+}
+
+void hmtxFree(Card8 which) {
+    if (which == 1) {
+        if (!loaded1)
+            return;
+        memFree(hmtx1.hMetrics);
+        loaded1 = 0;
+    } else if (which == 2) {
+        if (!loaded2)
+            return;
+        memFree(hmtx2.hMetrics);
+        loaded2 = 0;
+    }
+}
@@ -0,0 +1,18 @@
+/* Copyright 2014 Adobe Systems Incorporated (http://www.adobe.com/). All Rights Reserved.
+   This software is licensed as OpenSource, under the Apache License, Version 2.0.
+   This license is available at: http://opensource.org/licenses/Apache-2.0. */
+
+/*
+ * hmtx table support.
+ */
+
+#ifndef DHMTX_H
+#define DHMTX_H
+
+#include "Dglobal.h"
+
+extern void hmtxRead(Card8 which, LongN offset, Card32 length);
+extern void hmtxDiff(LongN offset1, LongN offset2);
+extern void hmtxFree(Card8 which);
+
+#endif /* DHMTX_H */
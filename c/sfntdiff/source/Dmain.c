@@ -31,18 +31,21 @@ char *MakeFullPath(char *source) {
 /* Print usage information */
 static void printUsage(void) {
     printf(
-        "Usage: %s [-u|-h] [-T] [-d <level>] [-x<tags>|-i<tags>] "
+        "Usage: %s [-u|-h] [-T] [-d <level>|-q [-w <index>]] [-x<tags>|-i<tags>] "
         "<FONTS|DIRS>\n"
         "OR: %s  -X <scriptfile>\n\n"
         "where: <FONTS|DIRS> is:\n"
         "\t    <fontfile1> <fontfile2>\n"
         "\tOR: <fontfile> <otherfontdir>\n"
-        "\tOR: <fontdir1> <fontdir2>\n "
+        "\tOR: <fontdir1> <fontdir2>\n"
+        "\tOR: <index> <fontfile2>  (with -q)\n "
         "\nOptions:\n"
         "    -u  print usage information\n"
         "    -h  print usage and help information\n"
         "    -T  show time-stamp of font files\n"
         "    -d  set diff level of detail\n"
+        "    -q  quick comparison by table content hash\n"
+        "    -w  write first font's table hashes to index file (with -q)\n"
         "    -x  exclude table(s)   _OR_\n"
         "    -i  include table(s) e.g., -iname,head\n"
         "Version:\n"
@@ -85,6 +88,29 @@ static void showHelp(void) {
         "        e.g., -i cmap,name\n"
         "        will inspect/compare ONLY the 'cmap' and 'name' tables\n");
     printf("    -i and -x switches are exclusive of each other.\n");
+    printf(
+        "    -q  only report which tables differ, by comparing a hash of each\n"
+        "        table's contents. head.checkSumAdjustment, head.modified and\n"
+        "        the DSIG table are ignored, so two builds of the same sources\n"
+        "        compare equal. The time taken to hash each font is reported\n"
+        "        in milliseconds.\n"
+        "    -w <index>\n"
+        "        with -q, also write the first font's table hashes to <index>.\n"
+        "        The first font can't be a directory.\n"
+        "        The index can later be given in place of that font, e.g.,\n"
+        "        sfntdiff -q -w base.idx base.otf new.otf\n"
+        "        sfntdiff -q base.idx newer.otf\n");
+}
+
+/* Compare the open pair of fonts */
+static void diffFonts(void) {
+    if (opt_Present("-q"))
+        sfntQuickDiff(NULL);
+    else {
+        sfntRead(0, -1, 0, -1); /* Read plain sfnt file */
+        sfntDump();
+    }
+    sfntFree();
 }
 
 /* Main program */
@@ -97,6 +123,8 @@ IntN main(IntN argc, Byte8 *argv[]) {
             {"-x", sfntTagScan},
             {"-i", sfntTagScan},
             {"-d", opt_Int, &level, "0", 0, 4},
+            {"-q", opt_Flag},
+            {"-w", sfntIndexScan},
         };
 
     IntN argi;
@@ -120,6 +148,12 @@ IntN main(IntN argc, Byte8 *argv[]) {
         return 1;
     }
 
+    if (opt_Present("-w") && !opt_Present("-q")) {
+        printf("ERROR: '-w' switch requires the '-q' switch.\n");
+        showUsage();
+        return 1;
+    }
+
     if (level > 4) level = 4;
 
     if ((argc - argi) < 2) {
@@ -134,10 +168,34 @@ IntN main(IntN argc, Byte8 *argv[]) {
     name1isDir = sysIsDir(filename1);
     name2isDir = sysIsDir(filename2);
 
+    if (opt_Present("-w") && name1isDir) {
+        printf("ERROR: '-w' switch needs a single first font, not a directory.\n");
+        showUsage();
+        return 1;
+    }
+
     printf("%s\n", ourtime());
-    printf("%s (%s) (-d %d)  files:\n", global.progname, version, level);
+    if (opt_Present("-q"))
+        printf("%s (%s) (-q)  files:\n", global.progname, version);
+    else
+        printf("%s (%s) (-d %d)  files:\n", global.progname, version, level);
 
-    if (!name1isDir && !name2isDir) {
+    if (!name1isDir && !name2isDir && opt_Present("-q") && sfntIsHashIndex(filename1)) {
+        /* Compare against a table hash index */
+        fileOpen(2, filename2);
+
+        printf("< %s\n", filename1);
+        printf("> %s\n", filename2);
+
+        if (!isSupportedFontFormat(fileSniff(2), filename2)) {
+            fileClose(2);
+            quit(1);
+        }
+
+        sfntQuickDiff(filename1);
+        sfntFree();
+        fileClose(2);
+    } else if (!name1isDir && !name2isDir) {
         if (!fileIsOpened(1)) fileOpen(1, filename1);
         if (!fileIsOpened(2)) fileOpen(2, filename2);
 
@@ -159,9 +217,7 @@ IntN main(IntN argc, Byte8 *argv[]) {
             quit(1);
         }
 
-        sfntRead(0, -1, 0, -1); /* Read plain sfnt file */
-        sfntDump();
-        sfntFree();
+        diffFonts();
         fileClose(1);
         fileClose(2);
     } else if (name1isDir && name2isDir) {
@@ -201,9 +257,7 @@ IntN main(IntN argc, Byte8 *argv[]) {
                 continue;
             }
 
-            sfntRead(0, -1, 0, -1); /* Read plain sfnt file */
-            sfntDump();
-            sfntFree();
+            diffFonts();
             fileClose(1);
             fileClose(2);
         }
@@ -240,9 +294,7 @@ IntN main(IntN argc, Byte8 *argv[]) {
             quit(1);
         }
 
-        sfntRead(0, -1, 0, -1); /* Read plain sfnt file */
-        sfntDump();
-        sfntFree();
+        diffFonts();
         fileClose(1);
         fileClose(2);
     } else {
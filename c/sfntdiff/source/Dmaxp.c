@@ -0,0 +1,65 @@
+/* Copyright 2014 Adobe Systems Incorporated (http://www.adobe.com/). All Rights Reserved.
+   This software is licensed as OpenSource, under the Apache License, Version 2.0.
+   This license is available at: http://opensource.org/licenses/Apache-2.0. */
+
+#include "Dmaxp.h"
+#include "sfnt_maxp.h"
+#include "Dsfnt.h"
+
+/* Only the fields common to both maxp versions are read */
+static maxpTbl maxp1;
+static maxpTbl maxp2;
+static IntX loaded1 = 0;
+static IntX loaded2 = 0;
+
+void maxpRead(Card8 which, LongN start, Card32 length) {
+    maxpTbl *maxp = NULL;
+
+    if (which == 1) {
+        if (loaded1)
+            return;
+        else
+            maxp = &maxp1;
+    } else if (which == 2) {
+        if (loaded2)
+            return;
+        else
+            maxp = &maxp2;
+    }
+
+    SEEK_ABS(which, start);
+
+    IN(which, maxp->version);
+    IN(which, maxp->numGlyphs);
+
+    if (which == 1)
+        loaded1 = 1;
+    else if (which == 2)
+        loaded2 = 1;
+}
+
+void maxpFree(Card8 which) {
+    if (which == 1)
+        loaded1 = 0;
+    else if (which == 2)
+        loaded2 = 0;
+}
+
+/* Returns 1 without a warning if the font has no maxp table; callers fall
+   back to their own estimate of the glyph count. */
+IntX maxpGetNGlyphs(Card8 which, Card16 *nGlyphs) {
+    maxpTbl *maxp = NULL;
+
+    if (which == 1) {
+        if (!loaded1 && sfntReadATable(which, maxp_))
+            return 1;
+        maxp = &maxp1;
+    } else if (which == 2) {
+        if (!loaded2 && sfntReadATable(which, maxp_))
+            return 1;
+        maxp = &maxp2;
+    }
+
+    *nGlyphs = maxp->numGlyphs;
+    return 0;
+}
@@ -0,0 +1,19 @@
+/* Copyright 2014 Adobe Systems Incorporated (http://www.adobe.com/). All Rights Reserved.
+   This software is licensed as OpenSource, under the Apache License, Version 2.0.
+   This license is available at: http://opensource.org/licenses/Apache-2.0. */
+
+/*
+ * maxp table support.
+ */
+
+#ifndef DMAXP_H
+#define DMAXP_H
+
+#include "Dglobal.h"
+
+extern void maxpRead(Card8 which, LongN offset, Card32 length);
+extern void maxpFree(Card8 which);
+
+extern IntX maxpGetNGlyphs(Card8 which, Card16 *nGlyphs);
+
+#endif /* DMAXP_H */
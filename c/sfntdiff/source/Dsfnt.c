@@ -7,13 +7,19 @@
  */
 
 #include <ctype.h>
+#include <stdint.h>
 #include <string.h>
+#include <time.h>
 
 #include "Dsfnt.h"
 #include "sfnt_sfnt.h"
 
 #if 1
+#include "Dcmap.h"
 #include "Dhead.h"
+#include "Dhhea.h"
+#include "Dhmtx.h"
+#include "Dmaxp.h"
 #include "Dname.h"
 #else
 #include "DBASE.h"
@@ -86,7 +92,7 @@ static Function function[] =
         {TYP1_},
         {WDTH_},
         {bloc_},
-        {cmap_},
+        {cmap_, cmapRead, cmapDiff, cmapFree},
         {fdsc_},
         {feat_},
         {fvar_},
@@ -94,11 +100,11 @@ static Function function[] =
         {glyf_},
         {hdmx_},
         {head_, headRead, headDiff, headFree},
-        {hhea_},
-        {hmtx_},
+        {hhea_, hheaRead, NULL, hheaFree},
+        {hmtx_, hmtxRead, hmtxDiff, hmtxFree},
         {kern_},
         {loca_},
-        {maxp_},
+        {maxp_, maxpRead, NULL, maxpFree},
         {name_, nameRead, nameDiff, nameFree},
         {post_},
         {sfnt_},
@@ -565,12 +571,43 @@ void hexDump(Card8 which, Card32 tag, LongN start, Card32 length) {
     }
 }
 
+/* Dump one 16-byte line of a hex difference */
+static void hexDiffLine(Byte8 *side, Card32 addr, Int32 left, Card8 *data) {
+    IntX i;
+
+    /* Dump 8 hexadecimal words of data */
+    printf("%s %08x  ", side, addr);
+
+    for (i = 0; i < 16; i++) {
+        if (i < left)
+            printf("%02x", data[i]);
+        else
+            printf("  ");
+        if ((i + 1) % 2 == 0)
+            printf(" ");
+    }
+    /* Dump ascii interpretation of data */
+    printf(" |");
+    for (i = 0; i < 16; i++)
+        if (i < left)
+            printf("%c", isprint(data[i]) ? data[i] : data[i] ? '?' : '.');
+        else
+            printf(" ");
+    printf("|\n");
+}
+
+/* Compare tables a block at a time, only breaking a block down into 16-byte
+   lines when it differs. Levels other than 2 stop at the first difference
+   since they report no more than its position. */
+#define HEXDIFF_BLOCK 4096
+
 void hexDiff(Card32 tag,
              LongN start1, Card32 length1,
              LongN start2, Card32 length2) {
+    static Card8 block1[HEXDIFF_BLOCK];
+    static Card8 block2[HEXDIFF_BLOCK];
     Card32 addr = 0;
     Int32 left;
-    Int32 diffaddr = (-1);
     IntX noted = 0;
 
     if (length1 < length2)
@@ -581,81 +618,48 @@ void hexDiff(Card32 tag,
     SEEK_SURE(1, start1);
     SEEK_SURE(2, start2);
 
-    while (left > 0) { /* Dump one line */
-        IntX i;
-        Card8 data1[16];
-        Card8 data2[16];
-
-        IN_BYTES(1, (left < 16) ? left : 16, data1);
-        IN_BYTES(2, (left < 16) ? left : 16, data2);
+    while (left > 0) {
+        Int32 count = (left < HEXDIFF_BLOCK) ? left : HEXDIFF_BLOCK;
+        Int32 line;
 
-        for (i = 0; i < ((left < 16) ? left : 16); i++) {
-            if (data1[i] != data2[i]) {
-                diffaddr = addr + i;
-                DiffExists++;
-                break;
-            }
-        }
+        IN_BYTES(1, count, block1);
+        IN_BYTES(2, count, block2);
 
-        if (!noted && (diffaddr > 0)) {
-            note("'%c%c%c%c' differs.\n", TAG_ARG(tag));
-            noted = 1;
+        if (memcmp(block1, block2, count) == 0) {
+            addr += count;
+            left -= count;
+            continue;
         }
 
-        if (diffaddr > 0) {
-            if (level == 0) {
-                return;
-            } else if (level == 1) {
-                note("< %08lx+%08x=%08lx\n", start1, diffaddr, start1 + diffaddr);
-                note("> %08lx+%08x=%08lx\n", start2, diffaddr, start2 + diffaddr);
-                return;
-            } else if (level == 2) {
-                /* Dump 8 hexadecimal words of data */
-                printf("< %08x  ", addr);
-
-                for (i = 0; i < 16; i++) {
-                    if (i < left)
-                        printf("%02x", data1[i]);
-                    else
-                        printf("  ");
-                    if ((i + 1) % 2 == 0)
-                        printf(" ");
-                }
-                /* Dump ascii interpretation of data */
-                printf(" |");
-                for (i = 0; i < 16; i++)
-                    if (i < left)
-                        printf("%c", isprint(data1[i]) ? data1[i] : data1[i] ? '?' : '.');
-                    else
-                        printf(" ");
-                printf("|\n");
+        for (line = 0; line < count; line += 16, addr += 16, left -= 16) {
+            Card8 *data1 = &block1[line];
+            Card8 *data2 = &block2[line];
+            IntX n = (count - line < 16) ? count - line : 16;
+            IntX i;
 
-                /* Dump 8 hexadecimal words of data */
-                printf("> %08x  ", addr);
+            for (i = 0; i < n; i++)
+                if (data1[i] != data2[i])
+                    break;
+            if (i == n)
+                continue;
 
-                for (i = 0; i < 16; i++) {
-                    if (i < left)
-                        printf("%02x", data2[i]);
-                    else
-                        printf("  ");
-                    if ((i + 1) % 2 == 0)
-                        printf(" ");
-                }
-                /* Dump ascii interpretation of data */
-                printf(" |");
-                for (i = 0; i < 16; i++)
-                    if (i < left)
-                        printf("%c", isprint(data2[i]) ? data2[i] : data2[i] ? '?' : '.');
-                    else
-                        printf(" ");
-                printf("|\n");
+            DiffExists++;
+            if (!noted) {
+                note("'%c%c%c%c' differs.\n", TAG_ARG(tag));
+                noted = 1;
+            }
 
+            if (level == 1) {
+                note("< %08lx+%08x=%08lx\n", start1, addr + i, start1 + addr + i);
+                note("> %08lx+%08x=%08lx\n", start2, addr + i, start2 + addr + i);
+                return;
+            } else if (level == 2) {
+                hexDiffLine("<", addr, left, data1);
+                hexDiffLine(">", addr, left, data2);
                 printf("\n");
-            }
+            } else
+                return;
         }
-        addr += 16;
-        left -= 16;
-        diffaddr = (-1);
     }
 }
 
@@ -859,6 +863,10 @@ static void doTables(IntX read) {
         }
 
         if (read) {
+            /* cmap, hhea, hmtx, and maxp are only decoded for the level 3 diffs */
+            if (level < 3 &&
+                (tag == cmap_ || tag == hhea_ || tag == hmtx_ || tag == maxp_))
+                continue;
             if (func != NULL && func->read != NULL) {
                 func->read(1, start1, length1);
                 func->read(2, start2, length2);
@@ -952,6 +960,242 @@ IntX sfntReadATable(Card8 which, Card32 tag) {
     return 0;
 }
 
+/* --- Quick comparison by table content hash --- */
+
+/* The hash covers a table's bytes, with the fields that change on every
+   build (head.checkSumAdjustment and head.modified) zeroed; DSIG is skipped
+   altogether. A baseline font's hashes can be saved to an index file and
+   given in place of that font on later runs. */
+#define HASH_INDEX_MAGIC "sfntdiff table hash index 1"
+#define HASH_BLOCK       4096
+
+typedef struct
+{
+    Card32 tag;
+    Card32 length;
+    uint64_t hash; /* FNV-1a */
+} TableHash;
+
+typedef da_DCL(TableHash, TableHashList);
+
+static Byte8 *hashIndexArg = NULL; /* -w argument */
+
+static IntN cmpTableHashes(const void *first, const void *second) {
+    Card32 a = ((TableHash *)first)->tag;
+    Card32 b = ((TableHash *)second)->tag;
+    if (a < b)
+        return -1;
+    else if (a > b)
+        return 1;
+    else
+        return 0;
+}
+
+/* Return 1 if table is selected by the -i/-x options */
+static IntX tagSelected(Card32 tag) {
+    Dump *dmp = (Dump *)bsearch(&tag, dump.list.array, dump.list.cnt,
+                                sizeof(Dump), cmpDumpTags);
+    return dmp == NULL || dmp->level != EXCLUDED;
+}
+
+/* Hash table data, ignoring volatile head fields */
+static uint64_t hashTable(Card8 which, Card32 tag, LongN start, Card32 length) {
+    static Card8 block[HASH_BLOCK];
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    Card32 offset = 0;
+
+    SEEK_SURE(which, start);
+    while (offset < length) {
+        Card32 count = (length - offset < HASH_BLOCK) ? length - offset : HASH_BLOCK;
+        Card32 i;
+
+        IN_BYTES(which, count, block);
+        for (i = 0; i < count; i++) {
+            Card32 at = offset + i;
+            Card8 byte = block[i];
+
+            if (tag == head_ && ((at >= 8 && at < 12) || (at >= 28 && at < 36)))
+                byte = 0; /* checkSumAdjustment, modified */
+            hash ^= byte;
+            hash *= 0x100000001b3ULL;
+        }
+        offset += count;
+    }
+    return hash;
+}
+
+/* Compute table hashes for font */
+static void hashFont(Card8 which, TableHashList *list) {
+    sfntTbl *sfnt = (which == 1) ? &sfnt1 : &sfnt2;
+    _ttc_ *ttc = (which == 1) ? &ttc1 : &ttc2;
+    _dir_ *dir = (which == 1) ? &dir1 : &dir2;
+    IntX i;
+
+    for (i = 0; i < sfnt->numTables; i++) {
+        Entry *entry = &sfnt->directory[i];
+        TableHash *th;
+
+        if (entry->tag == DSIG_ || !tagSelected(entry->tag))
+            continue;
+
+        th = da_NEXT(*list);
+        th->tag = entry->tag;
+        th->length = entry->length;
+        th->hash = hashTable(which, entry->tag,
+                             (ttc->loaded ? ttc->offset : dir->offset) + entry->offset,
+                             entry->length);
+    }
+    qsort(list->array, list->cnt, sizeof(TableHash), cmpTableHashes);
+}
+
+/* Read hash index file; return 1 if it isn't one */
+static IntX readHashIndex(Byte8 *filename, TableHashList *list) {
+    FILE *fp = fopen(filename, "r");
+    Byte8 line[100];
+
+    if (fp == NULL)
+        return 1;
+    if (fgets(line, sizeof(line), fp) == NULL ||
+        strncmp(line, HASH_INDEX_MAGIC, strlen(HASH_INDEX_MAGIC)) != 0) {
+        fclose(fp);
+        return 1;
+    }
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        unsigned long tag, length;
+        unsigned long long hash;
+
+        if (sscanf(line, "%lx %lx %llx", &tag, &length, &hash) != 3) {
+            warning("bad line in hash index [%s] (ignored)\n", filename);
+            continue;
+        }
+        if (tag == DSIG_ || !tagSelected(tag))
+            continue;
+        {
+            TableHash *th = da_NEXT(*list);
+            th->tag = tag;
+            th->length = length;
+            th->hash = hash;
+        }
+    }
+    fclose(fp);
+    qsort(list->array, list->cnt, sizeof(TableHash), cmpTableHashes);
+    return 0;
+}
+
+static void writeHashIndex(Byte8 *filename, TableHashList *list) {
+    FILE *fp = fopen(filename, "w");
+    IntX i;
+
+    if (fp == NULL) {
+        warning("can't write hash index [%s]\n", filename);
+        return;
+    }
+    fprintf(fp, "%s\n", HASH_INDEX_MAGIC);
+    for (i = 0; i < list->cnt; i++)
+        fprintf(fp, "%08lx %08lx %016llx\n",
+                (unsigned long)list->array[i].tag,
+                (unsigned long)list->array[i].length,
+                (unsigned long long)list->array[i].hash);
+    fclose(fp);
+}
+
+/* Return 1 if file is a table hash index */
+IntX sfntIsHashIndex(Byte8 *filename) {
+    FILE *fp = fopen(filename, "r");
+    Byte8 line[100];
+    IntX result = 0;
+
+    if (fp == NULL)
+        return 0;
+    if (fgets(line, sizeof(line), fp) != NULL &&
+        strncmp(line, HASH_INDEX_MAGIC, strlen(HASH_INDEX_MAGIC)) == 0)
+        result = 1;
+    fclose(fp);
+    return result;
+}
+
+/* Return milliseconds of processor time since start */
+static double elapsedMs(clock_t start) {
+    return (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+}
+
+/* Compare fonts by table hashes. If index is non-NULL the first font's
+   hashes are taken from that index file and file 1 isn't read. The time
+   taken to hash (or read the index of) each font is reported first. */
+void sfntQuickDiff(Byte8 *index) {
+    TableHashList list1;
+    TableHashList list2;
+    clock_t start;
+    IntX i, j;
+
+    if (index != NULL) {
+        /* Only the second font has a directory to read */
+        sfnt1.numTables = 0;
+        sfnt1.directory = NULL;
+        loaded1 = 1;
+    }
+    dirRead(0, 0);
+    preMakeDump();
+    makeDump();
+
+    da_INIT(list1, 40, 10);
+    da_INIT(list2, 40, 10);
+    start = clock();
+    if (index != NULL) {
+        if (readHashIndex(index, &list1))
+            fatal("bad hash index [%s]\n", index);
+        note("< read index in %.1f ms\n", elapsedMs(start));
+    } else {
+        hashFont(1, &list1);
+        note("< hashed in %.1f ms\n", elapsedMs(start));
+    }
+    start = clock();
+    hashFont(2, &list2);
+    note("> hashed in %.1f ms\n", elapsedMs(start));
+
+    if (hashIndexArg != NULL && index == NULL)
+        writeHashIndex(hashIndexArg, &list1);
+
+    for (i = j = 0; i < list1.cnt || j < list2.cnt;) {
+        TableHash *th1 = (i < list1.cnt) ? &list1.array[i] : NULL;
+        TableHash *th2 = (j < list2.cnt) ? &list2.array[j] : NULL;
+
+        if (th2 == NULL || (th1 != NULL && th1->tag < th2->tag)) {
+            DiffExists++;
+            note("< 'sfnt' table has '%c%c%c%c'\n", TAG_ARG(th1->tag));
+            note("> 'sfnt' table missing '%c%c%c%c'\n", TAG_ARG(th1->tag));
+            i++;
+        } else if (th1 == NULL || th2->tag < th1->tag) {
+            DiffExists++;
+            note("< 'sfnt' table missing '%c%c%c%c'\n", TAG_ARG(th2->tag));
+            note("> 'sfnt' table has '%c%c%c%c'\n", TAG_ARG(th2->tag));
+            j++;
+        } else {
+            if (th1->length != th2->length || th1->hash != th2->hash) {
+                DiffExists++;
+                note("'%c%c%c%c' differs.\n", TAG_ARG(th1->tag));
+            }
+            i++;
+            j++;
+        }
+    }
+
+    da_FREE(list1);
+    da_FREE(list2);
+}
+
+/* Hash index output argument scanner */
+int sfntIndexScan(int argc, char *argv[], int argi, opt_Option *opt) {
+    if (argi == 0)
+        return 0; /* Initialization not required */
+
+    if (argi == argc)
+        opt_Error(opt_Missing, opt, NULL);
+    else
+        hashIndexArg = argv[argi++];
+    return argi;
+}
+
 /* Handle tag list argument */
 int sfntTagScan(int argc, char *argv[], int argi, opt_Option *opt) {
     if (argi == 0)
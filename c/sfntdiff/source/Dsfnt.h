@@ -18,9 +18,12 @@ extern void sfntDump(void);
 extern void sfntFree(void);
 extern IntX sfntReadTable(Card32 tag);
 extern IntX sfntReadATable(Card8 which, Card32 tag);
+extern void sfntQuickDiff(Byte8 *index);
+extern IntX sfntIsHashIndex(Byte8 *filename);
 
 extern opt_Scanner sfntTagScan;
 extern opt_Scanner sfntTTCScan;
+extern opt_Scanner sfntIndexScan;
 extern void sfntUsage(void);
 extern void sfntTableSpecificUsage(void);
 
@@ -31,6 +31,9 @@ void fatal(int msgfmtID, ...) {
     va_end(ap);
     /*longjmp(mark, -1);*/
 
+    if (global.recover)
+        longjmp(global.env, 1); /* Abandon this command and go on to the next */
+
     if (fileExists(tmpname)) {
         remove(tmpname);
     }
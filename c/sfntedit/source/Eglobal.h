@@ -21,6 +21,7 @@ typedef struct
 {
     jmp_buf env; /* Termination environment */
     char *progname;
+    volatile int recover; /* fatal() returns to env instead of exiting */
 } Global;
 extern Global global;
 
@@ -50,6 +50,8 @@ const char *EnglishMessages[] =
         "check failed [%s]\n",                                   /* SFED_MSG_CHECKFAILED */
         "check passed [%s]\n",                                   /* SFED_MSG_CHECKPASSED */
         "Done.\n",                                               /* SFED_MSG_DONE */
+        "command-line abandoned after fatal error [%s]\n",       /* SFED_MSG_CMDFAILED */
+        "%ld fonts, %ld tables stored, %ld shared [%s]\n",       /* SFED_MSG_TTCWRITTEN */
 };
 
 const char *sfntedMsg(int msgId) {
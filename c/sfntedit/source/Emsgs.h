@@ -51,6 +51,8 @@ extern const char *sfntedMsg(int msgId);
 #define SFED_MSG_CHECKFAILED        41
 #define SFED_MSG_CHECKPASSED        42
 #define SFED_MSG_DONE               43
+#define SFED_MSG_CMDFAILED          44
+#define SFED_MSG_TTCWRITTEN         45
 
-#define SFED_MSG_ENDSENTINEL        SFED_MSG_DONE
+#define SFED_MSG_ENDSENTINEL        SFED_MSG_TTCWRITTEN
 #endif
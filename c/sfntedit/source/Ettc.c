@@ -0,0 +1,338 @@
+/* Copyright 2014 Adobe Systems Incorporated (http://www.adobe.com/). All Rights Reserved.
+   This software is licensed as OpenSource, under the Apache License, Version 2.0.
+   This license is available at: http://opensource.org/licenses/Apache-2.0. */
+
+/*
+ * OpenType Collection building. The fonts of the source files (plain sfnts or
+ * collections) are written to a single collection in which identical tables
+ * are stored once. Only the sfnt directories are held in memory; table data
+ * is compared and copied in fixed-size blocks straight from the source files,
+ * so memory use doesn't depend on the size of the fonts.
+ */
+
+#include <string.h>
+#include "Eglobal.h"
+#include "Efile.h"
+#include "Ettc.h"
+
+#define TAG(a, b, c, d) ((Card32)(a) << 24 | (Card32)(b) << 16 | (c) << 8 | (d))
+
+#define TTC_HDR_SIZE (4 * 3) /* ttcf header without offset table */
+#define DIR_HDR_SIZE (4 + 2 * 4)
+#define ENTRY_SIZE   (4 * 4)
+#define COMPARE_SIZE 65536 /* Table comparison block size */
+
+typedef struct /* Table */
+{
+    Card32 tag;
+    Card32 checksum;
+    Card32 offset; /* Source file offset */
+    Card32 length;
+    int iFile;     /* Source file index */
+    long share;    /* Index of identical earlier table, or -1 if unique */
+    long next;     /* Next unique table in hash chain, or -1 */
+    Card32 dstOffset;
+} TTCTable;
+
+typedef struct /* Font */
+{
+    Card32 version;
+    Card16 numTables;
+    Card16 searchRange;
+    Card16 entrySelector;
+    Card16 rangeShift;
+    long iTable; /* Index of first table */
+} TTCFont;
+
+static struct
+{
+    da_DCL(File, files);
+    da_DCL(TTCFont, fonts);
+    da_DCL(TTCTable, tables);
+    da_DCL(Card32, groups); /* Table tags in the order their data is written */
+    da_DCL(long, buckets);  /* Unique table hash chain heads, or -1 */
+    File dst;
+} ttc;
+
+/* Read sfnt directory at offset */
+static void readFont(int iFile, Card32 offset) {
+    File *file = &ttc.files.array[iFile];
+    TTCFont *font = da_NEXT(ttc.fonts);
+    int i;
+
+    fileSeek(file, offset, SEEK_SET);
+    fileReadObject(file, 4, &font->version);
+    switch (font->version) {
+        case 0x00010000:
+        case TAG('t', 'r', 'u', 'e'):
+        case TAG('O', 'T', 'T', 'O'):
+            break;
+        default:
+            fatal(SFED_MSG_UNRECFILE, file->name);
+    }
+    fileReadObject(file, 2, &font->numTables);
+    fileReadObject(file, 2, &font->searchRange);
+    fileReadObject(file, 2, &font->entrySelector);
+    fileReadObject(file, 2, &font->rangeShift);
+
+    font->iTable = ttc.tables.cnt;
+    for (i = 0; i < font->numTables; i++) {
+        TTCTable *tbl = da_NEXT(ttc.tables);
+        fileReadObject(file, 4, &tbl->tag);
+        fileReadObject(file, 4, &tbl->checksum);
+        fileReadObject(file, 4, &tbl->offset);
+        fileReadObject(file, 4, &tbl->length);
+        tbl->iFile = iFile;
+        tbl->share = -1;
+        tbl->next = -1;
+    }
+}
+
+/* Read the directories of all fonts in source file */
+static void readFile(int iFile) {
+    File *file = &ttc.files.array[iFile];
+    Card32 tag;
+
+    fileReadObject(file, 4, &tag);
+    if (tag == TAG('t', 't', 'c', 'f')) {
+        Card32 version;
+        Card32 numFonts;
+        Card32 i;
+
+        fileReadObject(file, 4, &version);
+        fileReadObject(file, 4, &numFonts);
+        for (i = 0; i < numFonts; i++) {
+            Card32 offset;
+
+            fileSeek(file, TTC_HDR_SIZE + 4 * i, SEEK_SET);
+            fileReadObject(file, 4, &offset);
+            readFont(iFile, offset);
+        }
+    } else
+        readFont(iFile, 0);
+}
+
+/* Compare table data blockwise; return 1 if identical */
+static int sameData(TTCTable *a, TTCTable *b) {
+    static char bufa[COMPARE_SIZE];
+    static char bufb[COMPARE_SIZE];
+    File *filea = &ttc.files.array[a->iFile];
+    File *fileb = &ttc.files.array[b->iFile];
+    Card32 done;
+
+    if (a->iFile == b->iFile && a->offset == b->offset)
+        return 1; /* Already shared in a source collection */
+
+    for (done = 0; done < a->length; done += COMPARE_SIZE) {
+        size_t count = a->length - done;
+
+        if (count > COMPARE_SIZE)
+            count = COMPARE_SIZE;
+        fileSeek(filea, a->offset + done, SEEK_SET);
+        fileReadN(filea, count, bufa);
+        fileSeek(fileb, b->offset + done, SEEK_SET);
+        fileReadN(fileb, count, bufb);
+        if (memcmp(bufa, bufb, count) != 0)
+            return 0;
+    }
+    return 1;
+}
+
+/* Add tag to the table data groups at index unless already present. Tables
+   are written grouped by tag with groups placed where their tag first
+   appeared in a font directory, matching the layout written by otf2otc. */
+static void addGroup(Card32 tag, long index) {
+    long i;
+
+    for (i = 0; i < ttc.groups.cnt; i++)
+        if (ttc.groups.array[i] == tag)
+            return;
+
+    if (index > ttc.groups.cnt)
+        index = ttc.groups.cnt;
+    (void)da_NEXT(ttc.groups);
+    for (i = ttc.groups.cnt - 1; i > index; i--)
+        ttc.groups.array[i] = ttc.groups.array[i - 1];
+    ttc.groups.array[index] = tag;
+}
+
+/* Hash table directory entry */
+static unsigned long hashTable(TTCTable *tbl) {
+    unsigned long hash = tbl->tag;
+    hash = hash * 31 + tbl->length;
+    hash = hash * 31 + tbl->checksum;
+    return hash ^ (hash >> 15);
+}
+
+/* Find tables identical to earlier ones. Unique tables are chained in a hash
+   table keyed by directory tag, length, and checksum; candidates are
+   confirmed by comparing the data itself. */
+static long shareTables(void) {
+    long nShared = 0;
+    long nBuckets = 1;
+    long i;
+
+    while (nBuckets < ttc.tables.cnt * 2)
+        nBuckets *= 2;
+    ttc.buckets.cnt = 0;
+    (void)da_EXTEND(ttc.buckets, nBuckets);
+    for (i = 0; i < nBuckets; i++)
+        ttc.buckets.array[i] = -1;
+
+    for (i = 0; i < ttc.fonts.cnt; i++) {
+        TTCFont *font = &ttc.fonts.array[i];
+        int k;
+
+        for (k = 0; k < font->numTables; k++) {
+            long iTable = font->iTable + k;
+            TTCTable *tbl = &ttc.tables.array[iTable];
+            long *head = &ttc.buckets.array[hashTable(tbl) & (nBuckets - 1)];
+            long j;
+
+            for (j = *head; j != -1; j = ttc.tables.array[j].next) {
+                TTCTable *prev = &ttc.tables.array[j];
+                if (prev->tag == tbl->tag &&
+                    prev->length == tbl->length &&
+                    prev->checksum == tbl->checksum &&
+                    sameData(prev, tbl)) {
+                    tbl->share = j;
+                    nShared++;
+                    break;
+                }
+            }
+            if (tbl->share == -1) {
+                tbl->next = *head;
+                *head = iTable;
+                addGroup(tbl->tag, k);
+            }
+        }
+    }
+    return nShared;
+}
+
+/* Write collection */
+static void writeTTC(File *dst) {
+    static char zeros[4];
+    Card32 offset;
+    long g;
+    long i;
+
+    /* Assign offsets: header, sfnt directories, then unique tables */
+    offset = TTC_HDR_SIZE + 4 * ttc.fonts.cnt;
+    for (i = 0; i < ttc.fonts.cnt; i++)
+        offset += DIR_HDR_SIZE + ENTRY_SIZE * ttc.fonts.array[i].numTables;
+    for (g = 0; g < ttc.groups.cnt; g++)
+        for (i = 0; i < ttc.tables.cnt; i++) {
+            TTCTable *tbl = &ttc.tables.array[i];
+            if (tbl->share == -1 && tbl->tag == ttc.groups.array[g]) {
+                tbl->dstOffset = offset;
+                offset += (tbl->length + 3) & ~3;
+            }
+        }
+    for (i = 0; i < ttc.tables.cnt; i++) {
+        TTCTable *tbl = &ttc.tables.array[i];
+        if (tbl->share != -1)
+            tbl->dstOffset = ttc.tables.array[tbl->share].dstOffset;
+    }
+
+    /* Write ttcf header */
+    fileWriteObject(dst, 4, TAG('t', 't', 'c', 'f'));
+    fileWriteObject(dst, 4, 0x00010000);
+    fileWriteObject(dst, 4, ttc.fonts.cnt);
+    offset = TTC_HDR_SIZE + 4 * ttc.fonts.cnt;
+    for (i = 0; i < ttc.fonts.cnt; i++) {
+        fileWriteObject(dst, 4, offset);
+        offset += DIR_HDR_SIZE + ENTRY_SIZE * ttc.fonts.array[i].numTables;
+    }
+
+    /* Write sfnt directories */
+    for (i = 0; i < ttc.fonts.cnt; i++) {
+        TTCFont *font = &ttc.fonts.array[i];
+        int j;
+
+        fileWriteObject(dst, 4, font->version);
+        fileWriteObject(dst, 2, font->numTables);
+        fileWriteObject(dst, 2, font->searchRange);
+        fileWriteObject(dst, 2, font->entrySelector);
+        fileWriteObject(dst, 2, font->rangeShift);
+        for (j = 0; j < font->numTables; j++) {
+            TTCTable *tbl = &ttc.tables.array[font->iTable + j];
+            fileWriteObject(dst, 4, tbl->tag);
+            fileWriteObject(dst, 4, tbl->checksum);
+            fileWriteObject(dst, 4, tbl->dstOffset);
+            fileWriteObject(dst, 4, tbl->length);
+        }
+    }
+
+    /* Copy unique tables */
+    for (g = 0; g < ttc.groups.cnt; g++)
+        for (i = 0; i < ttc.tables.cnt; i++) {
+            TTCTable *tbl = &ttc.tables.array[i];
+            File *src = &ttc.files.array[tbl->iFile];
+
+            if (tbl->share != -1 || tbl->tag != ttc.groups.array[g])
+                continue;
+
+            fileSeek(src, tbl->offset, SEEK_SET);
+            fileCopy(src, dst, tbl->length);
+            fileWriteN(dst, (4 - (tbl->length & 3)) & 3, zeros);
+        }
+}
+
+/* Close the source files and free the collection data */
+static void freeTTC(void) {
+    long i;
+
+    for (i = 0; i < ttc.files.cnt; i++)
+        fileClose(&ttc.files.array[i]);
+
+    if (ttc.files.size > 0)
+        da_FREE(ttc.files);
+    if (ttc.fonts.size > 0)
+        da_FREE(ttc.fonts);
+    if (ttc.tables.size > 0)
+        da_FREE(ttc.tables);
+    if (ttc.groups.size > 0)
+        da_FREE(ttc.groups);
+    if (ttc.buckets.size > 0)
+        da_FREE(ttc.buckets);
+    memset(&ttc, 0, sizeof(ttc));
+}
+
+/* Build collection from the fonts in the source files */
+void ttcBuild(const char *dstname, int nFiles, char *filenames[]) {
+    long nShared;
+    int i;
+
+    da_INIT(ttc.files, 10, 10);
+    da_INIT(ttc.fonts, 10, 10);
+    da_INIT(ttc.tables, 200, 200);
+    da_INIT(ttc.groups, 50, 50);
+    da_INIT(ttc.buckets, 256, 256);
+
+    for (i = 0; i < nFiles; i++) {
+        fileOpenRead(filenames[i], da_NEXT(ttc.files));
+        readFile(i);
+    }
+
+    nShared = shareTables();
+
+    fileOpenWrite(dstname, &ttc.dst);
+    writeTTC(&ttc.dst);
+    fileClose(&ttc.dst);
+
+    message(SFED_MSG_TTCWRITTEN, ttc.fonts.cnt,
+            ttc.tables.cnt - nShared, nShared, ttc.dst.name);
+
+    freeTTC();
+}
+
+/* Release the files and memory of a collection build abandoned by fatal(),
+   removing its partial output */
+void ttcAbandon(void) {
+    if (ttc.dst.fp != NULL) {
+        fileClose(&ttc.dst);
+        (void)remove(ttc.dst.name);
+    }
+    freeTTC();
+}
@@ -0,0 +1,13 @@
+/* Copyright 2014 Adobe Systems Incorporated (http://www.adobe.com/). All Rights Reserved.
+   This software is licensed as OpenSource, under the Apache License, Version 2.0.
+   This license is available at: http://opensource.org/licenses/Apache-2.0. */
+
+/* OpenType Collection building. */
+
+#ifndef ETTC_H
+#define ETTC_H
+
+extern void ttcBuild(const char *dstname, int nFiles, char *filenames[]);
+extern void ttcAbandon(void);
+
+#endif /* ETTC_H */
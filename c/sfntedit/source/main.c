@@ -20,6 +20,7 @@
 #include "Eglobal.h"
 #include "Efile.h"
 #include "Esys.h"
+#include "Ettc.h"
 #include "otftableeditor.h"
 #include "setjmp.h"
 
@@ -130,6 +131,7 @@ static File srcfile;
 static File dstfile;
 char *tmpname = "sfntedit.tmp"; /* Temporary filename */
 #define BACKUPNAME "sfntedit.BAK"
+#define COPY_BLOCK_SIZE 65536 /* Table streaming block; multiple of 4 */
 
 static long options; /* Options seen */
 #define OPT_EXTRACT (1 << 0)
@@ -138,6 +140,14 @@ static long options; /* Options seen */
 #define OPT_LIST    (1 << 3)
 #define OPT_CHECK   (1 << 4)
 #define OPT_FIX     (1 << 5)
+#define OPT_COLLECT (1 << 6)
+
+static struct /* Collection (-C) arguments */
+{
+    char *dstname;
+    int nFiles;
+    char **filenames;
+} collect;
 
 volatile int doingScripting = 0;
 int foundXswitch = 0;
@@ -180,6 +190,20 @@ static void cleanup(int code) {
     longjmp(mark, 1);
 }
 
+/* Release the files of a script command-line abandoned by fatal(), removing
+   its partial output. Errors during the cleanup itself are not recoverable. */
+static void abandonCommand(void) {
+    global.recover = 0;
+    warning(SFED_MSG_CMDFAILED, srcfile.name != NULL ? srcfile.name : "");
+    fileClose(&srcfile);
+    if (dstfile.fp != NULL) {
+        fileClose(&dstfile);
+        (void)remove(dstfile.name);
+    }
+    ttcAbandon();
+    global.recover = 1;
+}
+
 
 /* ----------------------------- Portable Rename --------------------------- */
 int p_rename(const char *old_filename, const char *new_filename) {
@@ -187,6 +211,11 @@ int p_rename(const char *old_filename, const char *new_filename) {
     File dst;
     long srcsize;
 
+    /* Move the file without copying it when the system allows; fall back
+       to copying across devices or onto an existing file */
+    if (rename(old_filename, new_filename) == 0)
+        return 0;
+
     fileOpenRead(old_filename, &src);
     fileOpenWrite(new_filename, &dst);
 
@@ -210,6 +239,7 @@ static void printUsage(void) {
     printf(
             "Usage:\n"
             "    %s [options] <srcfile> [<dstfile>]\n"
+            "OR: %s  -C <ttcfile> <srcfile> [<srcfile>]+\n"
             "OR: %s  -X <scriptfile>\n"
             "\n"
             "Options:\n"
@@ -219,6 +249,7 @@ static void printUsage(void) {
             "    -l list sfnt directory (default)\n"
             "    -c check checksums\n"
             "    -f fix checksums (implies -c)\n"
+            "    -C build collection <ttcfile> from the source files\n"
             "    -u print usage\n"
             "    -h print help\n"
             "    -X execute command-lines from <scriptfile> [default: sfntedit.scr]\n"
@@ -228,6 +259,7 @@ static void printUsage(void) {
             "\n",
             global.progname,
             global.progname,
+            global.progname,
             VERSION);
 }
 
@@ -280,6 +312,10 @@ static void showHelp(void) {
         "table's checksum adjustment field and reports any errors. The fix checksum\n"
         "option (-f) fixes any checksum errors.\n"
         "\n"
+        "The collection option (-C) writes the fonts of all the source files, which may\n"
+        "themselves be collections, to a single OpenType Collection file. Tables that\n"
+        "are identical in more than one font are stored once and shared.\n"
+        "\n"
         "The -d, -a, and -f options create a new sfnt file by copying tables from the\n"
         "source file to the destination file. The tables are copied in the order\n"
         "recommended in the OpenType specification. A side effect of copying is that all\n"
@@ -545,6 +581,17 @@ static int parseArgs(int argc, char *argv[]) {
                     case 'f': /* Fix checksum */
                         options |= OPT_FIX;
                         break;
+                    case 'C': /* Build collection */
+                        if (arg[2] != '\0')
+                            fatal(SFED_MSG_BADOPTION, arg);
+                        else if (argsleft == 0)
+                            fatal(SFED_MSG_NOARG, arg[1]);
+                        if (sourcepath[0] != '\0')
+                            collect.dstname = MakeFullPath(argv[++i]);
+                        else
+                            collect.dstname = argv[++i];
+                        options |= OPT_COLLECT;
+                        break;
                     case 'u':
                         showUsage();
                         exit(0);
@@ -560,10 +607,21 @@ static int parseArgs(int argc, char *argv[]) {
                 int writefile = options & (OPT_DELETE | OPT_ADD | OPT_FIX);
 
                 /* Validate options */
-                if (options & (OPT_LIST | OPT_CHECK | OPT_FIX) &&
+                if (options & (OPT_LIST | OPT_CHECK | OPT_FIX | OPT_COLLECT) &&
                     countbits(options) > 1)
                     fatal(SFED_MSG_OPTCONFLICT);
 
+                if (options & OPT_COLLECT) {
+                    /* All remaining args are source files */
+                    int j;
+                    collect.nFiles = argsleft + 1;
+                    collect.filenames = argv + i;
+                    if (sourcepath[0] != '\0')
+                        for (j = 0; j < collect.nFiles; j++)
+                            collect.filenames[j] = MakeFullPath(argv[i + j]);
+                    return (argsleft + 1);
+                }
+
                 if (options == 0)
                     options |= OPT_LIST; /* No options set; apply default */
 
@@ -856,45 +914,40 @@ static int cmpOrder(const void *first, const void *second) {
         return 0;
 }
 
-/* Copy table and compute its checksum */
-static Card32 tableCopy(File *src, File *dst, long offset, long length) {
-    int i;
-    Card32 value;
+/* Stream a table from src to dst in large blocks, padding it to a 4-byte
+   boundary, and return its checksum. The head.checkSumAdjustment field is
+   left out of the sum when isHead is set. */
+static Card32 tableCopy(File *src, File *dst, long offset, long length,
+                        int isHead) {
+    static Card8 buf[COPY_BLOCK_SIZE];
     Card32 checksum = 0;
+    long done = 0;
 
     fileSeek(src, offset, SEEK_SET);
-    for (; length > 3; length -= 4) {
-        fileReadObject(src, 4, &value);
-        fileWriteObject(dst, 4, value);
-        checksum += value;
-    }
-
-    if (length == 0)
-        return checksum;
+    while (done < length) {
+        long i;
+        long padded;
+        long n = length - done;
+
+        if (n > COPY_BLOCK_SIZE)
+            n = COPY_BLOCK_SIZE;
+        fileReadN(src, n, buf);
+
+        /* Zero-pad the final block to a 4-byte boundary */
+        padded = (n + 3) & ~3L;
+        for (i = n; i < padded; i++)
+            buf[i] = 0;
+
+        for (i = 0; i < padded; i += 4) {
+            Card32 value = (Card32)buf[i] << 24 | (Card32)buf[i + 1] << 16 |
+                           (Card32)buf[i + 2] << 8 | buf[i + 3];
+            if (!isHead || done + i != HEAD_ADJUST_OFFSET)
+                checksum += value;
+        }
 
-    /* Read remaining bytes and pad to 4-byte boundary */
-    value = 0;
-    for (i = 0; i < length; i++) {
-        Card8 b;
-        fileReadN(src, 1, &b);
-        value = value << 8 | b;
+        fileWriteN(dst, padded, buf);
+        done += n;
     }
-    value <<= (4 - length) * 8;
-    fileWriteObject(dst, 4, value);
-
-    return checksum + value;
-}
-
-/* Add table from file */
-static Card32 addTable(Table *tbl, Card32 *length) {
-    File file;
-    Card32 checksum;
-
-    fileOpenRead(tbl->afilename, &file);
-    fileSeek(&file, 0, SEEK_END);
-    *length = fileTell(&file);
-    checksum = tableCopy(&file, &dstfile, 0, *length);
-    fileClose(&file);
 
     return checksum;
 }
@@ -912,34 +965,46 @@ static int cmpTags(const void *first, const void *second) {
 }
 
 /* Copy tables from source file to destination file applying (-d, -a, and -f)
-   options */
+   options. The destination layout is planned from the source directory and
+   the sizes of the added table files before anything is written, so nothing
+   is written when the font wouldn't change, every table is read and written
+   exactly once, and the directory is filled in afterwards from the planned
+   offsets and the checksums gathered while streaming. */
 static boolean sfntCopy(void) {
     int i;
-    int nLongs;
     Tag *tags;
     Card16 numDstTables;
-    Card32 checksum;
     Card32 offset;
-    Card32 length;
-    Card32 adjustOff;
+    Card32 adjustOff = 0;
     Card32 totalsum;
     int headSeen = 0;
-    char outputfilename[FILENAME_MAX];
-    const char *dstfilename = dstfile.name;
-    FILE *f;
     boolean changed = (options & OPT_FIX) ? 1: 0; /* write file only if we change it */
 
-    STRLCPY(outputfilename, dstfile.name, sizeof(outputfilename));
-    f = freopen(outputfilename, "r+b", dstfile.fp);
-    if (f == NULL) {
-        fatal(SFED_MSG_sysFERRORSTR, strerror(errno), dstfile.name);
+    /* Plan destination tables */
+    numDstTables = 0;
+    for (i = 0; i < sfnt.numTables; i++) {
+        Table *tbl = &sfnt.directory[i];
+
+        if (tbl->flags & OPT_ADD) {
+            File file;
+
+            fileOpenRead(tbl->afilename, &file);
+            tbl->length = fileLength(&file);
+            fileClose(&file);
+            changed = 1;
+        } else if (!(tbl->flags & TBL_SRC)) {
+            continue; /* Skip table that is not in source font */
+        } else if (tbl->flags & OPT_DELETE) {
+            changed = 1;
+            continue; /* Skip deleted table */
+        }
+
+        tbl->flags |= TBL_DST;
+        numDstTables++;
     }
 
-    /* Count destination tables */
-    numDstTables = 0;
-    for (i = 0; i < sfnt.numTables; i++)
-        if (!(sfnt.directory[i].flags & OPT_DELETE))
-            numDstTables++;
+    if (!changed)
+        return changed;
 
     /* Assign table order */
     tags = (sfnt.version == TAG('O', 'T', 'T', 'O')) ? otfOrder : ttfOrder;
@@ -961,56 +1026,40 @@ static boolean sfntCopy(void) {
     /* Sort tables into recommended order */
     qsort(sfnt.directory, sfnt.numTables, sizeof(Table), cmpOrder);
 
-    /* Skip directory */
-    fileSeek(&dstfile, DIR_HDR_SIZE + ENTRY_SIZE * numDstTables, SEEK_SET);
+    /* Stream tables after the space reserved for the directory */
+    offset = DIR_HDR_SIZE + ENTRY_SIZE * numDstTables;
+    fileSeek(&dstfile, offset, SEEK_SET);
 
     totalsum = 0;
     for (i = 0; i < sfnt.numTables; i++) {
         Table *tbl = &sfnt.directory[i];
+        int isHead = tbl->tag == TAG('h', 'e', 'a', 'd');
 
-        offset = fileTell(&dstfile);
-
-        if (tbl->flags & OPT_ADD) {
-            checksum = addTable(tbl, &length);
-            changed = 1;
-        } else {
-            if (!(tbl->flags & TBL_SRC)) {
-                continue; /* Skip table that is not in source font */
-            } else if (tbl->flags & OPT_DELETE) {
-                changed = 1;
-                continue; /* Skip deleted table */
-            } else {
-                length = tbl->length;
-                checksum =
-                    tableCopy(&srcfile, &dstfile, tbl->offset, length);
-            }
-        }
-
-        if (tbl->tag == TAG('h', 'e', 'a', 'd')) {
-            Card32 b;
-            /* Adjust sum to ignore head.checkSumAdjustment field */
+        if (!(tbl->flags & TBL_DST))
+            continue;
 
+        if (isHead) {
             adjustOff = offset + HEAD_ADJUST_OFFSET;
-            fileSeek(&dstfile, adjustOff, SEEK_SET);
-            fileReadObject(&dstfile, 4, &b);
-            checksum -= b;
-
-            fileSeek(&dstfile, 0, SEEK_END);
             headSeen = 1;
         }
 
-        /* Update table entry */
-        tbl->checksum = checksum;
+        if (tbl->flags & OPT_ADD) {
+            File file;
+
+            fileOpenRead(tbl->afilename, &file);
+            tbl->checksum = tableCopy(&file, &dstfile, 0, tbl->length,
+                                      isHead);
+            fileClose(&file);
+        } else
+            tbl->checksum = tableCopy(&srcfile, &dstfile, tbl->offset,
+                                      tbl->length, isHead);
+
         tbl->offset = offset;
-        tbl->length = length;
-        tbl->flags |= TBL_DST;
+        offset += (tbl->length + 3) & ~3;
 
-        totalsum += checksum;
+        totalsum += tbl->checksum;
     }
 
-    if (!changed)
-        return changed;
-
     /* Initialize sfnt header */
     calcSearchParams(numDstTables, &sfnt.searchRange,
                      &sfnt.entrySelector, &sfnt.rangeShift);
@@ -1024,10 +1073,14 @@ static boolean sfntCopy(void) {
     fileWriteObject(&dstfile, 2, sfnt.entrySelector);
     fileWriteObject(&dstfile, 2, sfnt.rangeShift);
 
+    totalsum += sfnt.version;
+    totalsum += (Card32)numDstTables << 16 | sfnt.searchRange;
+    totalsum += (Card32)sfnt.entrySelector << 16 | sfnt.rangeShift;
+
     /* Sort directory into tag order */
     qsort(sfnt.directory, sfnt.numTables, sizeof(Table), cmpTags);
 
-    /* Write sfnt directory */
+    /* Write sfnt directory, summing it as we go */
     for (i = 0; i < sfnt.numTables; i++) {
         Table *tbl = &sfnt.directory[i];
 
@@ -1036,18 +1089,9 @@ static boolean sfntCopy(void) {
             fileWriteObject(&dstfile, 4, tbl->checksum);
             fileWriteObject(&dstfile, 4, tbl->offset);
             fileWriteObject(&dstfile, 4, tbl->length);
-        }
-    }
 
-    /* Checksum sfnt header */
-
-    fileSeek(&dstfile, 0, SEEK_SET);
-
-    nLongs = (DIR_HDR_SIZE + ENTRY_SIZE * numDstTables) / 4;
-    for (i = 0; i < nLongs; i++) {
-        Card32 b;
-        fileReadObject(&dstfile, 4, &b);
-        totalsum += b;
+            totalsum += tbl->tag + tbl->checksum + tbl->offset + tbl->length;
+        }
     }
 
     if (headSeen) {
@@ -1055,15 +1099,15 @@ static boolean sfntCopy(void) {
         fileSeek(&dstfile, adjustOff, SEEK_SET);
         fileWriteObject(&dstfile, 4, 0xb1b0afba - totalsum);
     }
-    dstfile.name = dstfilename;
     return changed;
 }
 
 int main(int argc, char *argv[]) {
     int argi;
     volatile int i;
+    volatile int failed = 0;
     cmdlinetype *cmdl;
-    boolean changed = 0;
+    volatile boolean changed = 0;
     /* Set signal handler */
     if (signal(SIGINT, SIG_IGN) != SIG_IGN)
         signal(SIGINT, cleanup);
@@ -1121,6 +1165,10 @@ int main(int argc, char *argv[]) {
                 goto execscript;
             }
         }
+        if ((options & OPT_COLLECT) && argi != 0) {
+            ttcBuild(collect.dstname, collect.nFiles, collect.filenames);
+            return 0;
+        }
         if ((srcfile.name == NULL) &&
             (argc > 1)
 
@@ -1207,6 +1255,9 @@ int main(int argc, char *argv[]) {
         }
     }
 
+        /* A fatal error abandons only the command-line that caused it */
+        global.recover = 1;
+
         for (i = 0; i < script.cmdline.cnt; i++) {
             int j;
             /* Initialize */
@@ -1234,12 +1285,23 @@ int main(int argc, char *argv[]) {
                 inform(SFED_MSG_EOLN);
             }
 
+            if (setjmp(global.env)) {
+                abandonCommand();
+                failed = 1;
+                continue;
+            }
+
             argi = parseArgs(cmdl->args.cnt - 1, cmdl->args.array + 1);
             if (argi == 0) {
                 fatal(SFED_MSG_MISSINGFILENAME);
                 showUsage();
             }
 
+            if (options & OPT_COLLECT) {
+                ttcBuild(collect.dstname, collect.nFiles, collect.filenames);
+                continue;
+            }
+
             fileOpenRead(srcfile.name, &srcfile);
 
             if (dstfile.name != NULL) /* Open destination file */
@@ -1282,6 +1344,7 @@ int main(int argc, char *argv[]) {
         }
 
         doingScripting = 0;
+        global.recover = 0;
     }
-    return 0;
+    return failed;
 }
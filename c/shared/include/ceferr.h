@@ -33,3 +33,4 @@ CTL_DCL_ERR(cefErrCffwriteFont, "can't write CFF font")
 CTL_DCL_ERR(cefErrCantRegister, "can't register client table")
 CTL_DCL_ERR(cefErrSfntwrite,    "can't write sfnt")
 CTL_DCL_ERR(cefErrCantHappen,   "can't happen!")
+CTL_DCL_ERR(cefErrBadCall,      "invalid call sequence")
@@ -8,7 +8,7 @@
 #include "ctlshare.h"
 #include "sfntwrite.h"
 
-#define CEF_VERSION CTL_MAKE_VERSION(2, 0, 25)
+#define CEF_VERSION CTL_MAKE_VERSION(2, 2, 0)
 
 #ifdef __cplusplus
 extern "C" {
@@ -49,7 +49,9 @@ extern "C" {
    concurrently allocated permitting operation in a multi-threaded environment.
 
    Once a context has been allocated a client may call cefMakeEmbeddingFont()
-   for each font to be subset. */
+   for each font to be subset. A client that makes many subsets of the same
+   font may instead parse the font once with cefBegPreparedFont() and then
+   call cefMakeEmbeddingFont() for each subset. */
 
 typedef struct cefCtx_ *cefCtx;
 cefCtx cefNew(ctlMemoryCallbacks *mem_cb, ctlStreamCallbacks *stm_cb,
@@ -120,6 +122,7 @@ typedef struct /* Embedding specification */
 #define CEF_FORCE_LANG_1       (1 << 0) /* Force LanguageGroup 1 */
 #define CEF_WRITE_SVG          (1 << 1) /* Write SVG font instead of CEF font */
 #define CEF_FORCE_IDENTITY_ROS (1 << 2) /* Force Registry-Ordering-Supplement in CFF to be "Adobe-Identity-0" */
+#define CEF_KEEP_SUBRS         (1 << 3) /* Keep subset's subrs from CFF source */
     char *newFontName;
     float *UDV;
     char *URL;
@@ -180,6 +183,11 @@ int cefMakeEmbeddingFont(cefCtx h, cefEmbedSpec *spec, cefMapCallback *map);
    LanguageGroup value of 1. WARNING: This option is unlikely to be useful
    outside of SING glyphlet generation.
 
+   If CEF_KEEP_SUBRS is specified and the source font has CFF (not CFF2)
+   outlines, the subset glyphs' charstrings are copied from the source
+   together with the source subrs they call, rather than being flattened (see
+   cfwSetSubrSource() in cffwrite.h).
+
    The "newFontName" field, if non-NULL, specifies a new PostScript FontName as
    a null-terminated string. This name will be stored in the Name INDEX of the
    CFF table in the embedding font.
@@ -270,6 +278,28 @@ int cefMakeEmbeddingFont(cefCtx h, cefEmbedSpec *spec, cefMapCallback *map);
    in the event of an error. The list of possible error codes is specified
    below. */
 
+int cefBegPreparedFont(cefCtx h, float *UDV);
+int cefEndPreparedFont(cefCtx h);
+
+/* cefBegPreparedFont() opens the source stream and parses the font once so
+   that subsequent calls to cefMakeEmbeddingFont() only have to read and
+   convert the subset glyphs. The source stream stays open, and the parsed
+   font stays in the context, until cefEndPreparedFont() is called. The "UDV"
+   parameter selects the multiple master instance (see cefMakeEmbeddingFont())
+   and replaces the "UDV" field of each embedding specification for the
+   prepared font.
+
+   A prepared font belongs to the context that parsed it. Clients subsetting
+   from several threads should prepare the font in one context per thread.
+
+   cefBegPreparedFont() returns cefErrBadCall if a font is already prepared
+   and cefEndPreparedFont() returns cefErrBadCall if none is. Otherwise both
+   return 0 on success and a positive non-0 error code in the event of an
+   error. A failed cefBegPreparedFont() closes the source stream and leaves no
+   font prepared. A prepared font must still be ended with cefEndPreparedFont()
+   when cefMakeEmbeddingFont() fails; it then closes the source stream even if
+   ending the parse fails. */
+
 void cefFree(cefCtx h);
 
 /* cefFree() destroys the library context and all the resources allocated to
@@ -7,7 +7,7 @@
 
 #include "ctlshare.h"
 
-#define CFR_VERSION CTL_MAKE_VERSION(2, 1, 3)
+#define CFR_VERSION CTL_MAKE_VERSION(2, 1, 4)
 
 #include "absfont.h"
 
@@ -236,6 +236,15 @@ const cfrRepeatRegions *cfrGetRepeatRegions(cfrCtx h, int iFD);
 
    Note: a Private DICT is required but it may be empty (0-length). */
 
+int cfrReadSrc(cfrCtx h, long offset, size_t count, char *ptr);
+
+/* cfrReadSrc() copies "count" bytes of source stream data, beginning at stream
+   offset "offset", to the buffer pointed to by "ptr". It reads through the
+   library's own source buffering so it may be used to access the regions
+   above, and the charstrings identified by "abfGlyphInfo.sup", while the font
+   is being parsed without disturbing the parse. The function returns
+   cfrSuccess on success and an error code otherwise. */
+
 int cfrGetWidths(cfrCtx h, int iFD,
                  float *defaultWidthX, float *nominalWidthX);
 
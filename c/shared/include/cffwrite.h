@@ -8,7 +8,7 @@
 
 #include "ctlshare.h"
 
-#define CFW_VERSION CTL_MAKE_VERSION(1, 0, 56)
+#define CFW_VERSION CTL_MAKE_VERSION(1, 0, 57)
 
 #include "absfont.h"
 
@@ -146,6 +146,58 @@ extern const abfGlyphCallbacks cfwGlyphCallbacks;
    The client must keep the glyph information, passed via the "info" parameter
    to the glyphBeg() callback, stable until after cfwEndFont() returns. */
 
+typedef struct /* Source font dict */
+{
+    ctlRegion LocalSubrINDEX;
+    float defaultWidthX;
+    float nominalWidthX;
+} cfwSubrSourceFD;
+
+typedef struct cfwSubrSource_ cfwSubrSource;
+struct cfwSubrSource_ {
+    void *ctx;
+    int (*read)(cfwSubrSource *src, long offset, size_t count, char *ptr);
+    ctlRegion CharStringsINDEX;
+    ctlRegion GlobalSubrINDEX;
+    long nFDs;
+    cfwSubrSourceFD *FDArray; /* [nFDs] */
+};
+
+int cfwSetSubrSource(cfwCtx h, cfwSubrSource *src);
+
+/* cfwSetSubrSource() may be called between cfwBegFont() and cfwEndFont() when
+   the glyphs added to the font are read from a CFF font, typically in order
+   to make a subset of it. Instead of flattening the source font's subrs into
+   the charstrings, the library then keeps the source subrs that are used by
+   the glyphs in the new font and drops the rest. The kept subrs are
+   renumbered by descending use, or copied into their callers where a call
+   would cost more than it saves, and the subr calls in the charstrings are
+   patched accordingly; the charstrings are otherwise copied from the source
+   unchanged. Since this includes the glyph widths the font keeps the source
+   defaultWidthX and nominalWidthX values.
+
+   The "src" parameter describes the source CFF data. The "read" callback is
+   called to copy "count" bytes of source data beginning at stream offset
+   "offset" to "ptr" and must return 0 on success. The regions give the source
+   stream locations of the CharStrings, global subr and per-font-dict local
+   subr INDEXes (an empty region indicates a missing INDEX) and the FDArray
+   supplies the Private DICT width values; the font dict order must be that of
+   the glyphs' abfGlyphInfo.iFD values. The glyphs' source charstrings are
+   located by abfGlyphInfo.sup, which must therefore be stable (along with the
+   read callback) until after cfwEndFont() returns. The cffread library
+   provides all of these (see cfrGetSingleRegions(), cfrGetRepeatRegions(),
+   cfrGetWidths() and cfrReadSrc()).
+
+   A glyph whose source charstring can't be copied this way (e.g. one using
+   the seac or arithmetic operators, or one the library had to correct) is
+   written from the glyph callback data as usual, and so the glyph callbacks
+   must still be called for every glyph. The source subrs are only kept for
+   the first font in a FontSet, and not at all if the CFW_SUBRIZE,
+   CFW_CHECK_IF_GLYPHS_DIFFER or CFW_WRITE_CFF2 bit was set. The client must
+   not call this function if the glyph callback data was transformed (e.g.
+   by a non-default FontMatrix, or by removing hints or overlaps) because the
+   source charstrings would then no longer match the callback data. */
+
 int cfwCompareFDArrays(cfwCtx h, abfTopDict *srcTop);
 
 /* cfwCompareFDArrays() compares the FDArray of the source font with the the
@@ -274,6 +274,8 @@ enum {
 
     UFO_SRC_STREAM_ID, /* ufo read format */
     UFO_DBG_STREAM_ID,
+    UFO_CACHE_SRC_STREAM_ID,
+    UFO_CACHE_DST_STREAM_ID,
 
     UFW_DST_STREAM_ID, /* ufowrite */
     UFW_TMP_STREAM_ID,
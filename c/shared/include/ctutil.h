@@ -7,7 +7,7 @@
 
 #include "ctlshare.h"
 
-#define CTU_VERSION CTL_MAKE_VERSION(2, 0, 3)
+#define CTU_VERSION CTL_MAKE_VERSION(2, 2, 0)
 
 #include <stddef.h> /* For size_t */
 #include <stdio.h>  /* For size_t */
@@ -55,6 +55,35 @@ int ctuLookup(const void *key, const void *base, size_t count, size_t size,
    This function is intended to be used for inserting new elements into a
    sorted list without duplicating identical elements. */
 
+unsigned long ctuHashString(const char *s);
+
+/* ctuHashString() returns a hash of the null-terminated string "s" suitable
+   for selecting a slot of a ctuHashFind() table. */
+
+typedef int(CTL_CDECL *ctuHashMatchFunc)(const void *key, long index, void *ctx);
+long ctuHashFind(const void *key, unsigned long hash, const long *slots,
+                 long size, ctuHashMatchFunc match, int *found, void *ctx);
+
+/* Search hash table for key.
+
+   The table is an array of "size" slots, where "size" is a power of 2, that
+   hold the index of a client element or -1 if empty. The search starts at
+   the slot selected by the "hash" parameter and probes following slots in
+   turn, calling the "match" function with the element index of each
+   occupied slot until it returns non-0. If an element matches the key, the
+   function returns its slot and sets the "found" parameter to 1. If no
+   element matches, the function returns the empty slot where the key should
+   be added and sets the "found" parameter to 0. The table must have an empty
+   slot, which ctuHashSize() ensures. */
+
+long ctuHashSize(long size, long count);
+
+/* ctuHashSize() returns the number of slots needed to hold "count" elements
+   in a ctuHashFind() table of "size" slots, keeping it at most half full. An
+   empty table starts with 1024 slots and a full one is doubled. If the result
+   differs from "size" the client resizes the table, sets all slots to -1, and
+   adds the elements again. */
+
 typedef unsigned char ctuLongDateTime[8];
 
 /* Apple's LongDateTime is a 64-bit number representing the number of seconds
@@ -100,6 +129,24 @@ void ctuDtostr(char *buf, size_t bufLen, double value, int width, int precision)
    locale and thus the decimal point character is always a period and not
    comma. */
 
+size_t ctuLtostr(char *buf, long value);
+
+/* ctuLtostr() converts the "value" parameter into a decimal string and stores
+   the result into the buffer pointed to by the "buf" parameter, which must
+   have room for at least 21 bytes. The length of the string is returned. */
+
+size_t ctuFtostr(char *buf, size_t bufLen, double value, int precision, int trim);
+
+/* ctuFtostr() converts the "value" parameter into a string, exactly as the "%.*f"
+   print format would in the C locale, using "precision" fraction digits. If
+   the "trim" parameter is non-0 trailing fraction zeros, and then a trailing
+   decimal point, are removed. The length of the string is returned.
+
+   Values with a "precision" of 15 or less and a scaled magnitude below 2^52
+   are converted without calling the standard library. This covers the
+   coordinates and metrics written by all text-format writers, so
+   ctuDtostr(), and writers that need the length, use this function. */
+
 void ctuGetVersion(ctlVersionCallbacks *cb);
 
 /* ctuGetVersion() returns the library version number and name via the client
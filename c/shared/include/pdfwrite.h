@@ -7,7 +7,7 @@
 
 #include "ctlshare.h"
 
-#define PDW_VERSION CTL_MAKE_VERSION(1, 0, 7)
+#define PDW_VERSION CTL_MAKE_VERSION(1, 1, 0)
 
 #include "absfont.h"
 
@@ -24,9 +24,20 @@ pdwCtx pdwNew(ctlMemoryCallbacks *mem_cb, ctlStreamCallbacks *stm_cb,
 int pdwBegFont(pdwCtx h, long flags, long level, abfTopDict *top);
 
 enum {
-    PDW_FLIP_TICS = 1 << 0
+    PDW_FLIP_TICS = 1 << 0,
+    PDW_COMPRESS  = 1 << 1
 };
 
+/* pdwBegFont() begins a new PDF document for the font described by "top".
+   The "level" parameter selects the glyph palette pages only (0) or the
+   palette plus one outline page per glyph (1).
+
+   If PDW_COMPRESS is set in the "flags" parameter, all streams are
+   Flate-compressed, each glyph's outline is written once as a Form XObject
+   that the palette pages draw, and pages are written as soon as their glyphs
+   have been seen rather than at the end of the font. This greatly reduces the
+   size of proofs of large fonts and the memory needed to write them. */
+
 int pdwEndFont(pdwCtx h);
 
 extern const abfGlyphCallbacks pdwGlyphCallbacks;
@@ -7,7 +7,7 @@
 
 #include "ctlshare.h"
 
-#define SVW_VERSION CTL_MAKE_VERSION(1, 1, 11)
+#define SVW_VERSION CTL_MAKE_VERSION(1, 2, 0)
 
 #include "absfont.h"
 
@@ -92,8 +92,26 @@ enum {
 
     SVW_ABSOLUTE = 1 << 6,
     /* Indicates that coordinates should be written as absolute rather than relative. */
+
+    SVW_COMPACT = 1 << 7,
+
+    /* Write the shortest path data: every command is relative, a command
+       letter is omitted when it repeats, horizontal and vertical lines use
+       "h" and "v", smooth curves use "s", separators are dropped where a
+       sign or decimal point already separates numbers, and zero-length
+       lines are omitted. Coordinates are rounded to the svwSetPrecision()
+       grid before differencing so rounding errors don't accumulate along a
+       path. Overrides SVW_ABSOLUTE. */
 };
 
+int svwSetPrecision(svwCtx h, int precision);
+
+/* svwSetPrecision() sets the number of decimal places, from 0 to 4, that
+   path coordinates and font metrics are written with; the default is 2.
+   Trailing fraction zeros are never written. It may be called before any
+   svwBegFont() call and applies to all subsequent fonts. Returns
+   svwErrBadCall if "precision" is out of range else svwSuccess. */
+
 extern const abfGlyphCallbacks svwGlyphCallbacks;
 
 /* svwGlyphCallbacks is a glyph callback set template that will add the data
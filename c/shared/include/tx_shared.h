@@ -241,6 +241,7 @@ struct txCtx_ {
 #define SUBSET_HAS_NOTDEF   (1 << 13) /* Indicates that notdef has been added, no need to force it in.*/
 #define PATH_REMOVE_OVERLAP (1 << 14) /* Do not remove path overlaps */
 #define PATH_SUPRESS_HINTS  (1 << 15) /* Do not remove path overlaps */
+#define KEEP_SUBRS          (1 << 16) /* Keep source subrs when writing CFF */
     int mode;                         /* Current mode */
     char *modename;                   /* Name of current mode */
     void *appSpecificInfo;            /* different data for rotateFont.c & mergeFonts.c */
@@ -324,6 +325,7 @@ struct txCtx_ {
         {
             unsigned short flags; /* cefEmbedSpec flags */
             char *F;
+            int prepared; /* Subset from prepared font (-cefpre) */
         } cef;
     } arg;
     struct /* t1read library */
@@ -357,8 +359,11 @@ struct txCtx_ {
         ufoCtx ctx;
         Stream src;
         Stream dbg;
+        Stream cache;             /* Glif cache file (UFO_USE_CACHE) */
+        char cachebuf[BUFSIZ];    /* Glif cache file buffer */
         long flags;
         char *altLayerDir;
+        char *cachePath;          /* Glif cache file name (-glifCache) */
     } ufr;
     struct /* cffwrite library */
     {
@@ -367,6 +372,7 @@ struct txCtx_ {
         Stream dbg;
         long flags;
         unsigned long maxNumSubrs;
+        dnaDCL(cfwSubrSourceFD, FDArray); /* Source font dicts for +K option */
     } cfw;
     struct /* cfembed library */
     {
@@ -439,7 +445,8 @@ struct txCtx_ {
         unsigned short unrec;
         Stream tmp;
         Stream dbg;
-        long flags; /* Library flags */
+        long flags;    /* Library flags */
+        int precision; /* Coordinate decimal places */
     } svw;
     struct /* ufowrite library */
     {
@@ -8,7 +8,7 @@
 #include "ctlshare.h"
 #include <stdbool.h>
 
-#define UFO_VERSION CTL_MAKE_VERSION(1, 3, 1)
+#define UFO_VERSION CTL_MAKE_VERSION(1, 4, 0)
 
 #include "absfont.h"
 
@@ -68,6 +68,20 @@ int ufoBegFont(ufoCtx h,
 
   */
 
+#define UFO_USE_CACHE (1 << 0) /* Use a persistent glif cache */
+
+/* When the UFO_USE_CACHE flag is set, the decoded outline, advance width and
+   Unicode value of each glyph are kept in a cache file. The library reads it
+   via the UFO_CACHE_SRC_STREAM_ID stream in ufoBegFont() and rewrites it via
+   the UFO_CACHE_DST_STREAM_ID stream in ufoEndFont() when it has changed. Both
+   streams are opened with the stream callbacks' clientFileName set to NULL;
+   the client chooses where the file lives and should keep it outside the UFO,
+   so that reading a UFO never modifies it. Cache entries are keyed by glif
+   file path, size and content hash, so a glif file that is unchanged since
+   the previous run is not parsed again; glyphs with hint data are always
+   parsed. The client may return NULL from either open call, in which case the
+   cache is not read or not written. */
+
 int ufoIterateGlyphs(ufoCtx h, abfGlyphCallbacks *glyph_cb);
 
 /* ufoIterateGlyphs() is called to iterate through all the glyph data in the
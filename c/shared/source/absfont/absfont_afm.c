@@ -7,6 +7,7 @@
  */
 
 #include "absfont.h"
+#include "ctutil.h"
 
 #include <time.h>
 #include <string.h>
@@ -197,35 +198,49 @@ static void updateFontBoundingBox(abfAFMCtx h) {
         h->font_bbox.bottom = h->glyph_metrics.ctx.int_mtx.bottom;
 }
 
+/* Copy "text" followed by decimal "value" to "p"; returns end of copy. */
+static char *appendLong(char *p, const char *text, long value) {
+    size_t length = strlen(text);
+    memcpy(p, text, length);
+    p += length;
+    return p + ctuLtostr(p, value);
+}
+
 /* End glyph path. */
 static void glyphEnd(abfGlyphCallbacks *cb) {
     abfAFMCtx h = (abfAFMCtx)cb->direct_ctx;
     abfMetricsCtx g = &h->glyph_metrics.ctx;
     abfGlyphInfo *info = cb->info;
     long code = (info->encoding.code == ABF_GLYPH_UNENC) ? -1 : info->encoding.code;
+    char buf[200];
+    char *p;
     h->glyph_metrics.cb.end(&h->glyph_metrics.cb);
 
     updateFontBoundingBox(h);
 
     /* Print glyph metrics */
-    if (info->flags & ABF_GLYPH_CID)
-        fprintf(h->tmp_fp, "C %ld ; W0X %ld ; N %hu ; B %ld %ld %ld %ld ;\n",
-                code, g->int_mtx.hAdv, info->cid,
-                g->int_mtx.left, g->int_mtx.bottom,
-                g->int_mtx.right, g->int_mtx.top);
-    else if (info->gname.ptr != NULL) {
-        if (strcmp(info->gname.ptr, ".notdef") != 0) {
-            fprintf(h->tmp_fp, "C %ld ; WX %ld ; N %s ; B %ld %ld %ld %ld ;\n",
-                    code, g->int_mtx.hAdv, info->gname.ptr,
-                    g->int_mtx.left, g->int_mtx.bottom,
-                    g->int_mtx.right, g->int_mtx.top);
-        }
+    if (info->flags & ABF_GLYPH_CID) {
+        p = appendLong(buf, "C ", code);
+        p = appendLong(p, " ; W0X ", g->int_mtx.hAdv);
+        p = appendLong(p, " ; N ", info->cid);
+    } else if (info->gname.ptr != NULL) {
+        if (strcmp(info->gname.ptr, ".notdef") == 0)
+            return;
+        p = appendLong(buf, "C ", code);
+        p = appendLong(p, " ; WX ", g->int_mtx.hAdv);
+        fwrite(buf, 1, p - buf, h->tmp_fp);
+        fprintf(h->tmp_fp, " ; N %s", info->gname.ptr);
+        p = buf;
     } else {
-        fprintf(h->tmp_fp, "C %ld ; WX %ld ; B %ld %ld %ld %ld ;\n",
-                code, g->int_mtx.hAdv,
-                g->int_mtx.left, g->int_mtx.bottom,
-                g->int_mtx.right, g->int_mtx.top);
+        p = appendLong(buf, "C ", code);
+        p = appendLong(p, " ; WX ", g->int_mtx.hAdv);
     }
+    p = appendLong(p, " ; B ", g->int_mtx.left);
+    p = appendLong(p, " ", g->int_mtx.bottom);
+    p = appendLong(p, " ", g->int_mtx.right);
+    p = appendLong(p, " ", g->int_mtx.top);
+    memcpy(p, " ;\n", 3);
+    fwrite(buf, 1, p + 3 - buf, h->tmp_fp);
 }
 
 /* AFM callbacks template. */
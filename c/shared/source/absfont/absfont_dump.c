@@ -470,16 +470,16 @@ static void glyphWidth(abfGlyphCallbacks *cb, float hAdv) {
 static void writeReal(char *buf, const size_t bufLen, float value) {
     char tmp[50];
 
+    tmp[0] = ' ';
     /* if no decimal component, perform a faster to string conversion */
     if ((fabs(value - roundf(value)) < TX_EPSILON) && (value > LONG_MIN) && (value < LONG_MAX))
-        SPRINTF_S(tmp, sizeof(tmp), " %ld", (long int)roundf(value));
+        ctuLtostr(&tmp[1], (long int)roundf(value));
     else {
-        int l;
+        size_t l;
         float value2 = (float)RND_ON_WRITE(value);  // to avoid getting -0 from 0.0004.
         if ((value2 == 0) && (value < 0))
             value2 = 0;
-        SPRINTF_S(tmp, sizeof(tmp), " %.2f", value2);
-        l = (int)strlen(tmp) - 1;
+        l = ctuFtostr(&tmp[1], sizeof(tmp) - 1, value2, 2, 0);
         if ((tmp[l] == '0') && (tmp[l - 1] == '0')) {
             tmp[l - 2] = 0;
         }
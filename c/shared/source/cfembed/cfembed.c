@@ -205,6 +205,7 @@ struct cefCtx_ {
     long flags;                   /* Status flags */
 #define DO_NEW_TABLES (1 << 0)    /* Call new table functions */
 #define CLOSE_DST_STREAM (1 << 1) /* Close destination stream */
+#define PREPARED_FONT    (1 << 2) /* Source parsed by cefBegPreparedFont() */
     long svwFlags;                /* svgwrite library flags */
     cefEmbedSpec *spec;           /* Client's embedding spec */
     struct                        /* Streams */
@@ -213,6 +214,12 @@ struct cefCtx_ {
         void *dst;
         ctlStreamCallbacks cb;
     } stm;
+    struct /* Checksum of table being written */
+    {
+        unsigned long value;
+        int phase; /* Byte index within current 32-bit word */
+        int valid; /* Cleared if the destination is seeked mid-table */
+    } sum;
     struct /* Source stream */
     {
         int type;      /* Font type */
@@ -247,6 +254,12 @@ struct cefCtx_ {
         CoverageFormat2 fmt2; /* Format 2 data */
     } coverage;
     dnaDCL(GlyphMap, subset); /* Working subset specification */
+    struct                    /* Prepared font */
+    {
+        abfTopDict top;               /* Top dict as parsed */
+        dnaDCL(abfFontDict, FDArray); /* FDArray as parsed */
+    } prep;
+    dnaDCL(cfwSubrSourceFD, subrFDArray); /* Source font dicts for cffwrite */
     struct                    /* Client callbacks */
     {
         ctlMemoryCallbacks mem;
@@ -290,22 +303,39 @@ static void srcFillBuf(cefCtx h, long offset) {
     h->src.end = h->src.buf + h->src.length;
 }
 
-/* Open source and destination streams. */
-static void stmsOpen(cefCtx h) {
+/* Open source stream. */
+static void srcOpen(cefCtx h) {
     h->stm.src = h->cb.stm.open(&h->cb.stm, CEF_SRC_STREAM_ID, 0);
     if (h->stm.src == NULL)
         fatal(h, cefErrSrcStream);
     srcFillBuf(h, 0);
+}
+
+/* Close source stream. */
+static void srcClose(cefCtx h) {
+    void *stm = h->stm.src;
+    h->stm.src = NULL;
+    if (h->cb.stm.close(&h->cb.stm, stm))
+        fatal(h, cefErrSrcStream);
+}
+
+/* Close source stream, if open, after an error. */
+static void srcAbandon(cefCtx h) {
+    if (h->stm.src != NULL) {
+        (void)h->cb.stm.close(&h->cb.stm, h->stm.src);
+        h->stm.src = NULL;
+    }
+}
 
+/* Open destination stream. */
+static void dstOpen(cefCtx h) {
     h->stm.dst = h->cb.stm.open(&h->cb.stm, CEF_DST_STREAM_ID, 0);
     if (h->stm.dst == NULL)
         fatal(h, cefErrDstStream);
 }
 
-/* Close source and destination streams. */
-static void stmsClose(cefCtx h) {
-    if (h->cb.stm.close(&h->cb.stm, h->stm.src))
-        fatal(h, cefErrSrcStream);
+/* Close destination stream. */
+static void dstClose(cefCtx h) {
     if (h->cb.stm.close(&h->cb.stm, h->stm.dst))
         fatal(h, cefErrDstStream);
 }
@@ -351,14 +381,66 @@ static unsigned long srcRead4(cefCtx h) {
 
 /* --------------------------- Destination Stream -------------------------- */
 
+/* Begin checksumming a table. All bytes written to the destination stream
+   are summed as they pass through, so sfntwrite needn't read the table back
+   to checksum it. */
+static void sumBegin(cefCtx h) {
+    h->sum.value = 0;
+    h->sum.phase = 0;
+    h->sum.valid = 1;
+}
+
+/* Add bytes to the table checksum. Bytes are summed as big-endian 32-bit
+   words aligned to the start of the table, so a write may begin or end part
+   way through a word. */
+static void sumBytes(cefCtx h, size_t count, const char *ptr) {
+    const unsigned char *p = (const unsigned char *)ptr;
+    unsigned long sum = h->sum.value;
+    int phase = h->sum.phase;
+
+    /* Finish partial word */
+    for (; count > 0 && phase != 0; count--) {
+        sum += (unsigned long)*p++ << (24 - 8 * phase);
+        phase = (phase + 1) & 3;
+    }
+
+    /* Sum whole words */
+    for (; count >= 4; count -= 4) {
+        sum += (unsigned long)p[0] << 24 | (unsigned long)p[1] << 16 |
+               (unsigned long)p[2] << 8 | p[3];
+        p += 4;
+    }
+
+    /* Start partial word */
+    for (; count > 0; count--) {
+        sum += (unsigned long)*p++ << (24 - 8 * phase);
+        phase++;
+    }
+
+    h->sum.value = sum & 0xffffffff;
+    h->sum.phase = phase;
+}
+
+/* Hand the table checksum to sfntwrite unless the table wasn't written
+   sequentially. */
+static void sumEnd(cefCtx h, int *use_checksum, unsigned long *checksum) {
+    *use_checksum = h->sum.valid;
+    *checksum = h->sum.value;
+}
+
+/* Write data buffer. */
+static void dstWrite(cefCtx h, size_t count, char *buf) {
+    sumBytes(h, count, buf);
+    if (h->cb.stm.write(&h->cb.stm, h->stm.dst, count, buf) != count)
+        fatal(h, cefErrDstStream);
+}
+
 /* Write 2-byte number. */
 static void dstWrite2(cefCtx h, unsigned short value) {
     unsigned char buf[2];
     buf[0] = (unsigned char)(value >> 8);
     buf[1] = (unsigned char)value;
-    if (h->cb.stm.write(&h->cb.stm, h->stm.dst, sizeof(buf), (char *)buf) !=
-        sizeof(buf))
-        fatal(h, cefErrDstStream);
+    dstWrite(h, sizeof(buf), (char *)buf);
 }
 
 /* Write 4-byte number. */
@@ -368,9 +450,7 @@ static void dstWrite4(cefCtx h, unsigned long value) {
     buf[1] = (unsigned char)(value >> 16);
     buf[2] = (unsigned char)(value >> 8);
     buf[3] = (unsigned char)value;
-    if (h->cb.stm.write(&h->cb.stm, h->stm.dst, sizeof(buf), (char *)buf) !=
-        sizeof(buf))
-        fatal(h, cefErrDstStream);
+    dstWrite(h, sizeof(buf), (char *)buf);
 }
 
 /* ---------------------------- Stream Callbacks --------------------------- */
@@ -411,6 +491,23 @@ static size_t stm_read(ctlStreamCallbacks *cb, void *stream, char **ptr) {
         return h->cb.stm.read(&h->cb.stm, stream, ptr);
 }
 
+/* Seek on stream. */
+static int stm_seek(ctlStreamCallbacks *cb, void *stream, long offset) {
+    cefCtx h = cb->indirect_ctx;
+    if (stream == h->stm.dst)
+        h->sum.valid = 0; /* Checksum no longer tracks table data */
+    return h->cb.stm.seek(&h->cb.stm, stream, offset);
+}
+
+/* Write to stream. */
+static size_t stm_write(ctlStreamCallbacks *cb,
+                        void *stream, size_t count, char *ptr) {
+    cefCtx h = cb->indirect_ctx;
+    if (stream == h->stm.dst)
+        sumBytes(h, count, ptr); /* CFF data from cffwrite */
+    return h->cb.stm.write(&h->cb.stm, stream, count, ptr);
+}
+
 /* Close stream. */
 static int stm_close(ctlStreamCallbacks *cb, void *stream) {
     cefCtx h = cb->indirect_ctx;
@@ -426,6 +523,8 @@ static void stmInit(cefCtx h) {
     /* Patch client callbacks */
     h->stm.cb.indirect_ctx = h; /* Provide cfembed context */
     h->stm.cb.open = stm_open;
+    h->stm.cb.seek = stm_seek;
+    h->stm.cb.write = stm_write;
     h->stm.cb.close = stm_close;
 }
 
@@ -1113,6 +1212,8 @@ static int cmapWrite(sfwTableCallbacks *cb,
     cmapFmt4 *fmt4;
     cmapFmt12 *fmt12;
 
+    sumBegin(h);
+
     /* Write header */
     dstWrite2(h, h->cmap.tbl.version);
     dstWrite2(h, h->cmap.tbl.nEncodings);
@@ -1146,6 +1247,7 @@ static int cmapWrite(sfwTableCallbacks *cb,
     if (h->cmap.tbl._flags & FILLEDFMT12)
         cmapWriteFmt12(h);
 
+    sumEnd(h, use_checksum, checksum);
     return 0;
 }
 
@@ -1207,18 +1309,6 @@ static void t1Parse(cefCtx h) {
     /* Patch in filtered stream read */
     h->stm.cb.read = stm_read;
 
-    if (h->ctx.t1r == NULL) {
-        /* Initialize library */
-        h->ctx.t1r = t1rNew(&h->cb.mem, &h->stm.cb, T1R_CHECK_ARGS);
-        if (h->ctx.t1r == NULL)
-            fatal(h, cefErrT1readInit);
-    }
-
-    /* Parse font */
-    if (t1rBegFont(h->ctx.t1r,
-                   T1R_UPDATE_OPS, h->src.origin, &h->top, h->spec->UDV))
-        fatal(h, cefErrT1Parse);
-
     if (h->top->sup.flags & ABF_CID_FONT) {
         /* CID font; check name override */
         if (h->spec->newFontName != NULL)
@@ -1253,17 +1343,6 @@ static void t1Parse(cefCtx h) {
 static void cffParse(cefCtx h) {
     long i;
 
-    if (h->ctx.cfr == NULL) {
-        /* Initialize library */
-        h->ctx.cfr = cfrNew(&h->cb.mem, &h->stm.cb, CFR_CHECK_ARGS);
-        if (h->ctx.cfr == NULL)
-            fatal(h, cefErrCffreadInit);
-    }
-
-    /* Parse font */
-    if (cfrBegFont(h->ctx.cfr, CFR_UPDATE_OPS, h->src.origin, 0, &h->top, NULL))
-        fatal(h, cefErrCFFParse);
-
     if (h->top->sup.flags & ABF_CID_FONT) {
         /* CID font; check name override */
         if (h->spec->newFontName != NULL)
@@ -1299,17 +1378,6 @@ static void cffParse(cefCtx h) {
 static void ttParse(cefCtx h) {
     long i;
 
-    if (h->ctx.ttr == NULL) {
-        /* Initialize library */
-        h->ctx.ttr = ttrNew(&h->cb.mem, &h->stm.cb, TTR_CHECK_ARGS);
-        if (h->ctx.ttr == NULL)
-            fatal(h, cefErrTtreadInit);
-    }
-
-    /* Parse font */
-    if (ttrBegFont(h->ctx.ttr, TTR_EXACT_PATH, h->src.origin, 0, &h->top, 0))
-        fatal(h, cefErrTTParse);
-
     /* Check name override */
     if (h->spec->newFontName != NULL)
         h->top->FDArray.array[0].FontName.ptr = h->spec->newFontName;
@@ -1324,6 +1392,105 @@ static void ttParse(cefCtx h) {
             fatal(h, cefErrNoGlyph);
 }
 
+/* Begin parsing source font. */
+static void srcBegFont(cefCtx h, float *UDV) {
+    switch (h->src.type) {
+        case SRC_TYPE1:
+            /* Patch in filtered stream read */
+            h->stm.cb.read = stm_read;
+
+            if (h->ctx.t1r == NULL) {
+                /* Initialize library */
+                h->ctx.t1r = t1rNew(&h->cb.mem, &h->stm.cb, T1R_CHECK_ARGS);
+                if (h->ctx.t1r == NULL)
+                    fatal(h, cefErrT1readInit);
+            }
+
+            if (t1rBegFont(h->ctx.t1r,
+                           T1R_UPDATE_OPS, h->src.origin, &h->top, UDV))
+                fatal(h, cefErrT1Parse);
+
+            /* Restore client stream read */
+            h->stm.cb.read = h->cb.stm.read;
+            break;
+        case SRC_CFF:
+            if (h->ctx.cfr == NULL) {
+                /* Initialize library */
+                h->ctx.cfr = cfrNew(&h->cb.mem, &h->stm.cb, CFR_CHECK_ARGS);
+                if (h->ctx.cfr == NULL)
+                    fatal(h, cefErrCffreadInit);
+            }
+
+            if (cfrBegFont(h->ctx.cfr,
+                           CFR_UPDATE_OPS, h->src.origin, 0, &h->top, NULL))
+                fatal(h, cefErrCFFParse);
+            break;
+        case SRC_TRUETYPE:
+            if (h->ctx.ttr == NULL) {
+                /* Initialize library */
+                h->ctx.ttr = ttrNew(&h->cb.mem, &h->stm.cb, TTR_CHECK_ARGS);
+                if (h->ctx.ttr == NULL)
+                    fatal(h, cefErrTtreadInit);
+            }
+
+            if (ttrBegFont(h->ctx.ttr,
+                           TTR_EXACT_PATH, h->src.origin, 0, &h->top, 0))
+                fatal(h, cefErrTTParse);
+            break;
+    }
+}
+
+/* Pass subset glyphs from source font to the glyph callbacks. */
+static void srcSubset(cefCtx h) {
+    if (h->flags & PREPARED_FONT) {
+        /* Undo dict changes and glyph marks left by the previous subset */
+        *h->top = h->prep.top;
+        memcpy(h->top->FDArray.array, h->prep.FDArray.array,
+               sizeof(abfFontDict) * h->prep.FDArray.cnt);
+        switch (h->src.type) {
+            case SRC_TYPE1:
+                (void)t1rResetGlyphs(h->ctx.t1r);
+                break;
+            case SRC_CFF:
+                (void)cfrResetGlyphs(h->ctx.cfr);
+                break;
+            case SRC_TRUETYPE:
+                (void)ttrResetGlyphs(h->ctx.ttr);
+                break;
+        }
+    }
+
+    switch (h->src.type) {
+        case SRC_TYPE1:
+            t1Parse(h);
+            break;
+        case SRC_CFF:
+            cffParse(h);
+            break;
+        case SRC_TRUETYPE:
+            ttParse(h);
+            break;
+    }
+}
+
+/* End source font parse. */
+static void srcEndFont(cefCtx h) {
+    switch (h->src.type) {
+        case SRC_TYPE1:
+            if (t1rEndFont(h->ctx.t1r))
+                fatal(h, cefErrT1Parse);
+            break;
+        case SRC_CFF:
+            if (cfrEndFont(h->ctx.cfr))
+                fatal(h, cefErrCFFParse);
+            break;
+        case SRC_TRUETYPE:
+            if (ttrEndFont(h->ctx.ttr))
+                fatal(h, cefErrTTParse);
+            break;
+    }
+}
+
 /* Match glyph name in subset. */
 static int CTL_CDECL matchName(const void *key, const void *value) {
     return strcmp((char *)key, ((GlyphMap *)value)->gname);
@@ -1364,6 +1531,43 @@ static int CTL_CDECL cmpIds(const void *first, const void *second) {
     return 0;
 }
 
+/* Read source font data for cffwrite. */
+static int readSubrSource(cfwSubrSource *src, long offset, size_t count,
+                          char *ptr) {
+    cefCtx h = src->ctx;
+    return cfrReadSrc(h->ctx.cfr, offset, count, ptr);
+}
+
+/* Let cffwrite keep the source font's subrs (CEF_KEEP_SUBRS flag). */
+static void setSubrSource(cefCtx h) {
+    const cfrSingleRegions *regions = cfrGetSingleRegions(h->ctx.cfr);
+    cfwSubrSource src;
+    char major;
+    long i;
+
+    if (cfrReadSrc(h->ctx.cfr, regions->Header.begin, 1, &major) || major != 1)
+        return; /* Not CFF (version 1) charstrings */
+
+    dnaSET_CNT(h->subrFDArray, h->top->FDArray.cnt);
+    for (i = 0; i < h->top->FDArray.cnt; i++) {
+        cfwSubrSourceFD *fd = &h->subrFDArray.array[i];
+        fd->LocalSubrINDEX =
+            cfrGetRepeatRegions(h->ctx.cfr, i)->LocalSubrINDEX;
+        if (cfrGetWidths(h->ctx.cfr, i,
+                         &fd->defaultWidthX, &fd->nominalWidthX))
+            return;
+    }
+
+    src.ctx = h;
+    src.read = readSubrSource;
+    src.CharStringsINDEX = regions->CharStringsINDEX;
+    src.GlobalSubrINDEX = regions->GlobalSubrINDEX;
+    src.nFDs = h->subrFDArray.cnt;
+    src.FDArray = h->subrFDArray.array;
+    if (cfwSetSubrSource(h->ctx.cfw, &src))
+        fatal(h, cefErrCffwriteFont);
+}
+
 /* Fill CFF table. */
 static int CFF_Fill(sfwTableCallbacks *cb, int *dont_write) {
     cefCtx h = cb->ctx;
@@ -1378,17 +1582,12 @@ static int CFF_Fill(sfwTableCallbacks *cb, int *dont_write) {
         cfwBegFont(h->ctx.cfw, &map_cb, 0))
         fatal(h, cefErrCffwriteFont);
 
-    switch (h->src.type) {
-        case SRC_TYPE1:
-            t1Parse(h);
-            break;
-        case SRC_CFF:
-            cffParse(h);
-            break;
-        case SRC_TRUETYPE:
-            ttParse(h);
-            break;
-    }
+    if (!(h->flags & PREPARED_FONT))
+        srcBegFont(h, h->spec->UDV);
+    srcSubset(h);
+
+    if ((h->spec->flags & CEF_KEEP_SUBRS) && h->src.type == SRC_CFF)
+        setSubrSource(h);
 
     if (h->spec->flags & CEF_FORCE_LANG_1) {
         /* Force LanguageGroup 1 in all Private DICTs */
@@ -1407,21 +1606,8 @@ static int CFF_Fill(sfwTableCallbacks *cb, int *dont_write) {
     if (cfwEndFont(h->ctx.cfw, h->top))
         fatal(h, cefErrCffwriteFont);
 
-    /* End parse */
-    switch (h->src.type) {
-        case SRC_TYPE1:
-            if (t1rEndFont(h->ctx.t1r))
-                fatal(h, cefErrT1Parse);
-            break;
-        case SRC_CFF:
-            if (cfrEndFont(h->ctx.cfr))
-                fatal(h, cefErrCFFParse);
-            break;
-        case SRC_TRUETYPE:
-            if (ttrEndFont(h->ctx.ttr))
-                fatal(h, cefErrTTParse);
-            break;
-    }
+    if (!(h->flags & PREPARED_FONT))
+        srcEndFont(h);
 
     if (h->spec->subset.names != NULL)
         /* Re-sort subset by id */
@@ -1440,8 +1626,10 @@ static int CFF_Write(sfwTableCallbacks *cb,
     cefCtx h = cb->ctx;
 
     /* Write CFF data */
+    sumBegin(h);
     if (cfwEndSet(h->ctx.cfw))
         fatal(h, cefErrCffwriteFont);
+    sumEnd(h, use_checksum, checksum);
 
     return 0;
 }
@@ -1797,6 +1985,8 @@ static int GPOSWrite(sfwTableCallbacks *cb,
        is relative to <component>. Offsets, both absolute and relative, within
        the GPOS table are shown in parentheses. */
 
+    sumBegin(h);
+
     /* Write GPOS header */
     dstWrite4(h, 0x00010000); /* Version */
     dstWrite2(h, 0x000a);     /* ScriptList <Header> */
@@ -1845,6 +2035,7 @@ static int GPOSWrite(sfwTableCallbacks *cb,
     writePairPos1(h);
     writeCoverage(h);
 
+    sumEnd(h, use_checksum, checksum);
     return 0;
 }
 
@@ -1986,8 +2177,11 @@ int cefMakeEmbeddingFont(cefCtx h, cefEmbedSpec *spec, cefMapCallback *map) {
     h->spec = spec;
     h->cb.map = map;
 
-    stmsOpen(h);
-    h->src.type = getFontType(h);
+    if (!(h->flags & PREPARED_FONT)) {
+        srcOpen(h);
+        h->src.type = getFontType(h);
+    }
+    dstOpen(h);
 
     if (spec->flags & CEF_WRITE_SVG) /* Write SVG font */
     {
@@ -2005,37 +2199,16 @@ int cefMakeEmbeddingFont(cefCtx h, cefEmbedSpec *spec, cefMapCallback *map) {
         if (svwBegFont(hSvw, h->svwFlags))
             fatal(h, cefErrCffwriteFont);
 
-        switch (h->src.type) {
-            case SRC_TYPE1:
-                t1Parse(h);
-                break;
-            case SRC_CFF:
-                cffParse(h);
-                break;
-            case SRC_TRUETYPE:
-                ttParse(h);
-                break;
-        }
+        if (!(h->flags & PREPARED_FONT))
+            srcBegFont(h, spec->UDV);
+        srcSubset(h);
 
         /* Write the SVG font */
         if (svwEndFont(hSvw, h->top))
             fatal(h, cefErrCffwriteFont);
 
-        /* End parse */
-        switch (h->src.type) {
-            case SRC_TYPE1:
-                if (t1rEndFont(h->ctx.t1r))
-                    fatal(h, cefErrT1Parse);
-                break;
-            case SRC_CFF:
-                if (cfrEndFont(h->ctx.cfr))
-                    fatal(h, cefErrCFFParse);
-                break;
-            case SRC_TRUETYPE:
-                if (ttrEndFont(h->ctx.ttr))
-                    fatal(h, cefErrTTParse);
-                break;
-        }
+        if (!(h->flags & PREPARED_FONT))
+            srcEndFont(h);
 
         svwFree(hSvw);
         h->cb.glyph = cb;
@@ -2052,9 +2225,59 @@ int cefMakeEmbeddingFont(cefCtx h, cefEmbedSpec *spec, cefMapCallback *map) {
             fatal(h, cefErrSfntwrite);
     }
 
-    stmsClose(h);
+    if (!(h->flags & PREPARED_FONT))
+        srcClose(h);
+    dstClose(h);
+
+    HANDLER
+    return Exception.Code;
+    END_HANDLER
+
+    return cefSuccess;
+}
+
+/* Parse source font once for subsequent subsets. */
+int cefBegPreparedFont(cefCtx h, float *UDV) {
+    if (h->flags & PREPARED_FONT)
+        return cefErrBadCall;
+
+    /* Set error handler */
+    DURING_EX(h->err.env)
+
+    srcOpen(h);
+    h->src.type = getFontType(h);
+    srcBegFont(h, UDV);
+
+    /* Save parsed dicts; each subset may override names and flags */
+    h->prep.top = *h->top;
+    dnaSET_CNT(h->prep.FDArray, h->top->FDArray.cnt);
+    memcpy(h->prep.FDArray.array, h->top->FDArray.array,
+           sizeof(abfFontDict) * h->prep.FDArray.cnt);
+
+    h->flags |= PREPARED_FONT;
+
+    HANDLER
+    srcAbandon(h);
+    return Exception.Code;
+    END_HANDLER
+
+    return cefSuccess;
+}
+
+/* End use of prepared font. */
+int cefEndPreparedFont(cefCtx h) {
+    if (!(h->flags & PREPARED_FONT))
+        return cefErrBadCall;
+    h->flags &= ~PREPARED_FONT;
+
+    /* Set error handler */
+    DURING_EX(h->err.env)
+
+    srcEndFont(h);
+    srcClose(h);
 
     HANDLER
+    srcAbandon(h);
     return Exception.Code;
     END_HANDLER
 
@@ -2103,6 +2326,7 @@ cefCtx cefNew(ctlMemoryCallbacks *mem_cb, ctlStreamCallbacks *stm_cb,
     h->stm.src = NULL;
     h->stm.dst = NULL;
     h->subset.size = 0;
+    h->prep.FDArray.size = 0;
     h->ctx.dna = NULL;
 
     /* Copy callbacks */
@@ -2128,6 +2352,8 @@ cefCtx cefNew(ctlMemoryCallbacks *mem_cb, ctlStreamCallbacks *stm_cb,
     h->flags = DO_NEW_TABLES;
     h->svwFlags = 0;
     dnaINIT(h->ctx.dna, h->subset, 256, 128);
+    dnaINIT(h->ctx.dna, h->prep.FDArray, 1, 14);
+    dnaINIT(h->ctx.dna, h->subrFDArray, 1, 14);
     h->cb.glyph = cfwGlyphCallbacks;
     /* This keeps these callbacks from being used when
        writing a regular CFF, and avoids the overhead of processing the
@@ -2171,6 +2397,8 @@ void cefFree(cefCtx h) {
         return;
 
     dnaFREE(h->subset);
+    dnaFREE(h->subrFDArray);
+    dnaFREE(h->prep.FDArray);
 
     /* Free sfnt tables */
     if (h->ctx.sfw != NULL)
@@ -3125,6 +3125,21 @@ const cfrRepeatRegions *cfrGetRepeatRegions(cfrCtx h, int iFD) {
     return (iFD < 0 || iFD >= h->FDArray.cnt) ? NULL : &h->FDArray.array[iFD].region;
 }
 
+/* Copy source stream data. */
+int cfrReadSrc(cfrCtx h, long offset, size_t count, char *ptr) {
+    /* Set error handler */
+    DURING_EX(h->err.env)
+
+    srcSeek(h, offset);
+    srcRead(h, count, ptr);
+
+    HANDLER
+    return Exception.Code;
+    END_HANDLER
+
+    return cfrSuccess;
+}
+
 /* Return font DICT widths. */
 int cfrGetWidths(cfrCtx h, int iFD,
                  float *defaultWidthX, float *nominalWidthX) {
@@ -18,6 +18,7 @@
 #include "cffwrite_varstore.h"
 #include "cffwrite_t2cstr.h"
 #include "cffwrite_subr.h"
+#include "cffwrite_prune.h"
 
 #include <string.h>
 #include <stdlib.h>
@@ -80,6 +81,9 @@ typedef struct Glyph_ /* Glyph data */
         long offset;
     } cstr;
     uint16_t iFD; /* Modifiable and persistent copy of info->iFD */
+    uint16_t flags;
+#define GLYPH_FIXED      (1 << 0) /* Source glyph data was changed */
+#define GLYPH_KEEP_WIDTH (1 << 1) /* Charstring includes source width */
 } Glyph;
 
 typedef struct /* Glyph data */
@@ -108,6 +112,7 @@ typedef struct /* Per-font data */
     dnaDCL(FDInfo, FDArray);       /* FD array */
     dnaDCL(Glyph, glyphs);         /* Per-glyph data */
     dnaDCL(SeenGlyph, seenGlyphs); /* Per-glyph data */
+    dnaDCL(long, seenHash);        /* seenGlyphs index hash table */
     dnaDCL(SeenDict, seenDicts);   /* Per-fontdict data */
 
     INDEX CharStrings; /* CharStrings INDEX data */
@@ -212,6 +217,7 @@ static void initFont(void *ctx, long cnt, cff_Font *font) {
         font->FDArray.func = initFDInfo;
         dnaINIT(g->ctx.dnaFail, font->glyphs, 256, 750);
         dnaINIT(g->ctx.dnaFail, font->seenGlyphs, 256, 256);
+        dnaINIT(g->ctx.dnaFail, font->seenHash, 1, 1);
         dnaINIT(g->ctx.dnaFail, font->seenDicts, 2, 2);
         font++;
     }
@@ -257,6 +263,7 @@ static void cfwControlFree(cfwCtx g) {
         dnaFREE(font->FDArray);
         dnaFREE(font->glyphs);
         dnaFREE(font->seenGlyphs);
+        dnaFREE(font->seenHash);
         dnaFREE(font->seenDicts);
     }
     dnaFREE(h->FontSet);
@@ -310,26 +317,6 @@ static void tmp2bufCopy(cfwCtx g, long length, long offset, char *ptr) {
     g->tmp.next += length;
 }
 
-/* Match glyph name. */
-static int CTL_CDECL matchSeenName(const void *key, const void *value, void *ctx) {
-    char *compStr = ((SeenGlyph *)value)->info.gname.ptr;
-
-    return strcmp((char *)key,
-                  compStr);
-}
-
-/* Match glyph CID. */
-static int CTL_CDECL matchSeenCID(const void *key, const void *value, void *ctx) {
-    long match;
-    match = *(unsigned short *)key - ((SeenGlyph *)value)->info.cid;
-
-    if (match == 0) {
-        return match;
-    } else {
-        return (match > 0) ? 1 : -1;
-    }
-}
-
 /* Match font FD dict FontName. */
 static int CTL_CDECL matchFontName(const void *srcName, const void *value, void *ctx) {
     long fdIndex = ((SeenDict *)value)->fdIndex;
@@ -356,37 +343,80 @@ static int CTL_CDECL matchFontName(const void *srcName, const void *value, void
     return result;
 }
 
+/* Hash glyph name or CID. */
+static unsigned long hashSeen(abfGlyphInfo *info) {
+    if (info->flags & ABF_GLYPH_CID) {
+        unsigned long hash = info->cid * 2654435761UL;
+        return hash ^ (hash >> 15);
+    }
+    return ctuHashString(info->gname.ptr);
+}
+
+/* Match glyph name or CID to seen glyph. */
+static int CTL_CDECL matchSeen(const void *key, long index, void *ctx) {
+    controlCtx h = ctx;
+    abfGlyphInfo *info = (abfGlyphInfo *)key;
+    abfGlyphInfo *seen = &h->_new->seenGlyphs.array[index].info;
+    return (info->flags & ABF_GLYPH_CID) ? seen->cid == info->cid : strcmp(seen->gname.ptr, info->gname.ptr) == 0;
+}
+
+/* Find hash table slot of glyph, or the empty slot where it should be added. */
+static long findSeenSlot(controlCtx h, abfGlyphInfo *info, int *found) {
+    return ctuHashFind(info, hashSeen(info), h->_new->seenHash.array,
+                       h->_new->seenHash.cnt, matchSeen, found, h);
+}
+
+/* Resize seen glyph hash table to "size" slots and re-add glyphs. */
+static int resizeSeenHash(cfwCtx g, long size) {
+    controlCtx h = g->ctx.control;
+    long i;
+
+    if (dnaSetCnt(&h->_new->seenHash, sizeof(long), size) == -1) {
+        return 0;
+    }
+    for (i = 0; i < size; i++) {
+        h->_new->seenHash.array[i] = -1;
+    }
+    for (i = 0; i < h->_new->seenGlyphs.cnt; i++) {
+        int found;
+        h->_new->seenHash.array[findSeenSlot(h, &h->_new->seenGlyphs.array[i].info, &found)] = i;
+    }
+    return 1;
+}
+
 /*
    Test if glyph has already been added to the font.
    The function sets the result code:
     0                         glyph not yet seen
     cfwErrGlyphPresent,       "identical charstring is already present"
     cfwErrGlyphDiffers,       "different charstring of same name is already present"
-   and returns the index of the glyph in the sorted array of glyph names in the CFF. If not
-   yet in the font, the index is one greater than the index of the glyph which sorts before the new name.
+    cfwErrNoMemory,           "out of memory" growing the hash table
+   and returns the slot of the glyph in the glyph name (or CID) hash table. If
+   not yet in the font, this is the empty slot that cfwAddGlyph() fills. The
+   caller must not add the glyph unless the result code is 0.
 
  */
 long cfwSeenGlyph(cfwCtx g, abfGlyphInfo *info, int *result, long startNew, long endNew) {
     controlCtx h = g->ctx.control;
-    long seenIndex = 0;
+    long seenSlot;
+    long size;
     int nameFound;
 
     *result = 0;
 
-    if (info->flags & ABF_GLYPH_CID) {
-        nameFound = ctuLookup(&info->cid, h->_new->seenGlyphs.array, h->_new->seenGlyphs.cnt,
-                              sizeof(h->_new->seenGlyphs.array[0]), matchSeenCID, (size_t *)&seenIndex, h);
-    } else {
-        nameFound = ctuLookup(info->gname.ptr, h->_new->seenGlyphs.array, h->_new->seenGlyphs.cnt,
-                              sizeof(h->_new->seenGlyphs.array[0]), matchSeenName, (size_t *)&seenIndex, h);
+    /* Keep hash table at most half full once the glyph is added */
+    size = ctuHashSize(h->_new->seenHash.cnt, h->_new->seenGlyphs.cnt + 1);
+    if (size != h->_new->seenHash.cnt && !resizeSeenHash(g, size)) {
+        *result = cfwErrNoMemory;
+        return -1;
     }
+    seenSlot = findSeenSlot(h, info, &nameFound);
 
     if (nameFound) {
         int noMatch = 0;
         long lenNewStr = endNew - startNew;
-        long glyphIndex = h->_new->seenGlyphs.array[seenIndex].glyphsIndex;
+        long glyphIndex = h->_new->seenGlyphs.array[h->_new->seenHash.array[seenSlot]].glyphsIndex;
         long lenOldStr = h->_new->glyphs.array[glyphIndex].cstr.length;
-
         if (lenNewStr != lenOldStr) {
             noMatch = 1;
         } else {
@@ -423,7 +453,7 @@ long cfwSeenGlyph(cfwCtx g, abfGlyphInfo *info, int *result, long startNew, long
         }
     }
 
-    return seenIndex;
+    return seenSlot;
 }
 
 static long mergeDict(cfwCtx g, abfFontDict *srcDict) {
@@ -538,7 +568,8 @@ int cfwCompareFDArrays(cfwCtx g, abfTopDict *srcTop) {
 
 /* Add new glyph. */
 void cfwAddGlyph(cfwCtx g,
-                 abfGlyphInfo *info, float hAdv, long length, long offset, long seen_index) {
+                 abfGlyphInfo *info, float hAdv, long length, long offset, long seen_index,
+                 int fixed) {
     controlCtx h = g->ctx.control;
     Glyph *glyph = NULL;
     SeenGlyph *seenGlyph = NULL;
@@ -579,6 +610,7 @@ void cfwAddGlyph(cfwCtx g,
     glyph->hAdv = hAdv;
     glyph->cstr.length = length;
     glyph->cstr.offset = offset;
+    glyph->flags = fixed ? GLYPH_FIXED : 0;
     glyph->iFD = info->iFD; /* Make modifiable/persistent copy */
                             /* When merging  CID fonts, this must specify the
                                destination font FD array index, not the source
@@ -589,32 +621,25 @@ void cfwAddGlyph(cfwCtx g,
 
     /* We get to here only if the new glyph does NOT have the same name as a
        glyph which has already been seen. It is therefore added to the list.
-       'seen_index' gives the index of the new name in the alphabetic list of
-       glyph names. */
+       'seen_index' gives the empty hash table slot found for the new name by
+       cfwSeenGlyph(). */
 
     /* For CID glyphs, we also need to check if the FD is new to the dest font,
        and if so add it, and we need to fix the glyph->iFD value. This is
        currently an index into the  source font FD array */
     if (g->flags & CFW_CHECK_IF_GLYPHS_DIFFER) {
-        int needHole = seen_index < h->_new->seenGlyphs.cnt;
+        long iSeen = dnaNext(&h->_new->seenGlyphs, sizeof(SeenGlyph));
 
         /* grow array, increment seenGlyphs.cnt */
-        if (dnaNext(&h->_new->seenGlyphs, sizeof(SeenGlyph)) == -1) {
+        if (iSeen == -1) {
             g->err.code = cfwErrNoMemory;
             return;
         }
 
-        /* ptr to insertion-point index */
-        seenGlyph = &h->_new->seenGlyphs.array[seen_index];
-
-        /* Move higher elements (if there are any) up one index to make hole. */
-        if (needHole) {
-            memmove(seenGlyph + 1, seenGlyph,
-                    ((h->_new->seenGlyphs.cnt - 1) - seen_index) * sizeof(SeenGlyph));
-        }
-
+        seenGlyph = &h->_new->seenGlyphs.array[iSeen];
         seenGlyph->glyphsIndex = index;
         seenGlyph->info = *info;  // I can't save a ptr to the info, as the original array of abfGlyphInfo moves when resized.
+        h->_new->seenHash.array[seen_index] = iSeen;
     }
 
     if (info->flags & ABF_GLYPH_UNICODE) {
@@ -1299,7 +1324,9 @@ static void writeCharStringsINDEX(controlCtx h, cff_Font *font) {
                        i, chrstr_length);
         }
 
-        if ((!(g->flags & CFW_WRITE_CFF2)) && (glyph->hAdv != fd->width.dflt)) {
+        if ((!(g->flags & CFW_WRITE_CFF2)) &&
+            !(glyph->flags & GLYPH_KEEP_WIDTH) &&
+            (glyph->hAdv != fd->width.dflt)) {
             /* Add glyph width size */
             offset += numsize(glyph->hAdv - fd->width.nominal);
         }
@@ -1313,7 +1340,9 @@ static void writeCharStringsINDEX(controlCtx h, cff_Font *font) {
         Glyph *glyph = &font->glyphs.array[i];
         FDInfo *fd = &font->FDArray.array[glyph->iFD];
 
-        if ((!(g->flags & CFW_WRITE_CFF2)) && (glyph->hAdv != fd->width.dflt)) {
+        if ((!(g->flags & CFW_WRITE_CFF2)) &&
+            !(glyph->flags & GLYPH_KEEP_WIDTH) &&
+            (glyph->hAdv != fd->width.dflt)) {
             /* Write width */
             long length;
             uint8_t t[5];
@@ -1473,9 +1502,12 @@ int cfwBegFont(cfwCtx g, cfwMapCallback *map, unsigned long maxNumSubrs) {
 
     /* For h->_new->seenGlyphs, we do NOT need to pre-allocate for .notdef
        as we are not forcing it to the beginning of the list */
+    h->_new->seenGlyphs.cnt = 0;
+    h->_new->seenHash.cnt = 0;
 
     h->flags &= ~(SEEN_NAME_KEYED_GLYPH | SEEN_CID_KEYED_GLYPH);
     h->mergedDicts = 0;
+    cfwPruneClearSource(g);
 
     /* Set up metrics facility */
     g->glyph_metrics.cb = abfGlyphMetricsCallbacks;
@@ -1489,6 +1521,20 @@ int cfwBegFont(cfwCtx g, cfwMapCallback *map, unsigned long maxNumSubrs) {
     return cfwSuccess;
 }
 
+/* Set subr source for current font. */
+int cfwSetSubrSource(cfwCtx g, cfwSubrSource *src) {
+    /* Set error handler */
+    DURING_EX(g->err.env)
+
+    cfwPruneSetSource(g, src);
+
+    HANDLER
+    return g->err.code;
+    END_HANDLER
+
+    return cfwSuccess;
+}
+
 /* Order glyphs in CID-keyed font. */
 static void orderCIDKeyedGlyphs(controlCtx h) {
     cfwCtx g = h->g;
@@ -1862,6 +1908,75 @@ static void zeroOutEmptyFontBBox(cfwCtx g) {
     }
 }
 
+/* Replace the charstrings of glyphs whose source charstrings can be copied
+   and keep the source subrs that they use. */
+static void keepSourceSubrs(controlCtx h) {
+    cfwCtx g = h->g;
+    cff_Font *font = h->_new;
+    long *kept;
+    long i;
+
+    if (!cfwPruneBegFont(g, font->FDArray.cnt)) {
+        return;
+    }
+
+    kept = (long *)cfwMemNew(g, sizeof(long) * font->glyphs.cnt);
+    for (i = 0; i < font->glyphs.cnt; i++) {
+        Glyph *glyph = &font->glyphs.array[i];
+        kept[i] = (glyph->flags & GLYPH_FIXED) ?
+                  -1 : cfwPruneAddGlyph(g, glyph->info, glyph->iFD);
+    }
+    cfwPruneEndFont(g);
+
+    /* Set subrs and the source widths that kept charstrings are encoded
+       against; the remaining glyphs' widths are written against them too */
+    for (i = 0; i < font->FDArray.cnt; i++) {
+        FDInfo *fd = &font->FDArray.array[i];
+        cfwPruneGetWidths(g, i, &fd->width.dflt, &fd->width.nominal);
+        cfwPruneGetSubrs(g, i, &fd->subrData);
+        fd->Subrs.count = fd->subrData.nStrings;
+    }
+    {
+        subr_CSData gsubrs;
+        cfwPruneGetSubrs(g, -1, &gsubrs);
+        cfwSubrSetGlobal(g, &gsubrs);
+    }
+
+    /* Append kept charstrings to tmp stream */
+    for (i = 0; i < font->glyphs.cnt; i++) {
+        Glyph *glyph = &font->glyphs.array[i];
+        long offset;
+        long length;
+
+        if (kept[i] == -1) {
+            continue;
+        }
+        offset = g->cb.stm.tell(&g->cb.stm, g->stm.tmp);
+        if (offset == -1) {
+            cfwFatal(g, cfwErrTmpStream, NULL);
+        }
+        length = cfwPruneWriteGlyph(g, kept[i]);
+        font->CharStrings.datasize += length - glyph->cstr.length;
+        glyph->cstr.offset = offset;
+        glyph->cstr.length = length;
+        glyph->flags |= GLYPH_KEEP_WIDTH;
+    }
+    cfwCstrSyncTmp(g);
+
+    /* Recompute size of the widths still to be written */
+    font->size.widths = 0;
+    for (i = 0; i < font->glyphs.cnt; i++) {
+        Glyph *glyph = &font->glyphs.array[i];
+        FDInfo *fd = &font->FDArray.array[glyph->iFD];
+        if (!(glyph->flags & GLYPH_KEEP_WIDTH) &&
+            glyph->hAdv != fd->width.dflt) {
+            font->size.widths += numsize(glyph->hAdv - fd->width.nominal);
+        }
+    }
+
+    cfwMemFree(g, kept);
+}
+
 /* End font. */
 int cfwEndFont(cfwCtx g, abfTopDict *top) {
     controlCtx h = g->ctx.control;
@@ -1956,6 +2071,11 @@ int cfwEndFont(cfwCtx g, abfTopDict *top) {
 
     analyzeWidths(h);
 
+    if (h->FontSet.cnt == 1 &&
+        !(g->flags & (CFW_SUBRIZE | CFW_CHECK_IF_GLYPHS_DIFFER | CFW_WRITE_CFF2))) {
+        keepSourceSubrs(h);
+    }
+
     if (h->_new->map != NULL && !(g->flags & CFW_PRESERVE_GLYPH_ORDER)) {
         /* Callback glyph mapping */
         for (i = 0; i < h->_new->glyphs.cnt; i++) {
@@ -2145,6 +2265,7 @@ int cfwEndSet(cfwCtx g) {
     cfwDictReuse(g);
     cfwCstrReuse(g);
     cfwSubrReuse(g);
+    cfwPruneReuse(g);
 
     /* Close debug stream */
     if (g->stm.dbg != NULL) {
@@ -2240,6 +2361,7 @@ cfwCtx cfwNew(ctlMemoryCallbacks *mem_cb, ctlStreamCallbacks *stm_cb,
     cfwDictNew(g);
     cfwCstrNew(g);
     cfwSubrNew(g);
+    cfwPruneNew(g);
 
     g->err.code = cfwSuccess;
 
@@ -2267,6 +2389,7 @@ void cfwFree(cfwCtx g) {
     cfwDictFree(g);
     cfwCstrFree(g);
     cfwSubrFree(g);
+    cfwPruneFree(g);
 
     /* Free service libraries */
     dnaFree(g->ctx.dnaSafe);
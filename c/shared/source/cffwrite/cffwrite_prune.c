@@ -0,0 +1,833 @@
+/* Copyright 2014 Adobe Systems Incorporated (http://www.adobe.com/). All Rights Reserved.
+   This software is licensed as OpenSource, under the Apache License, Version 2.0.
+   This license is available at: http://opensource.org/licenses/Apache-2.0. */
+
+/*
+ * Source subr retention support.
+ *
+ * When the glyphs of a font are read from a CFF font the source subrs can be
+ * kept instead of being flattened into the charstrings. Each glyph's source
+ * charstring is scanned, following the subrs it calls, in order to find the
+ * subrs that it uses and the locations of the subr number operands that
+ * select them. Once all the glyphs have been scanned, used subrs that no
+ * longer pay for themselves (typically those left with a single caller) are
+ * copied into their callers and the rest are renumbered by descending call
+ * count, using the same bias-aware ordering as the subroutinizer. Only the
+ * subr calls are rewritten; all other charstring bytes, including the widths,
+ * are copied unchanged and so the font keeps the source default and nominal
+ * widths.
+ *
+ * A charstring whose subr calls can't be identified reliably isn't copied and
+ * the glyph keeps the charstring that was built from the glyph callbacks.
+ */
+
+#include "cffwrite_prune.h"
+#include "txops.h"
+
+#include <string.h>
+
+typedef struct /* Subr call site */
+{
+    long offset;          /* Subr number operand offset in charstring */
+    long iSubr;           /* Source subr index (unbiased) */
+    unsigned char length; /* Subr number operand length */
+    unsigned char global; /* Flags global subr call */
+} CallSite;
+
+typedef struct /* Source subr */
+{
+    short state;
+#define SUBR_UNSEEN   0 /* Not yet scanned */
+#define SUBR_SCANNING 1 /* First scan in progress */
+#define SUBR_OK       2 /* Scanned */
+    short flags;
+#define SUBR_USED   (1 << 0) /* Called by kept glyph */
+#define SUBR_INLINE (1 << 1) /* Copied into callers */
+    long end;    /* Length of subr up to (not including) return */
+    long iSite;  /* First call site in h->sites */
+    long nSites; /* Call site count */
+    long count;  /* Number of calls from kept charstrings */
+    long iNew;   /* New subr index */
+    long stamp;  /* Last glyph scan to call this subr */
+} Subr;
+
+typedef struct /* Source subr INDEX */
+{
+    dnaDCL(long, offset);         /* Subr data offsets [count + 1] */
+    dnaDCL(unsigned char, data);  /* Subr data */
+    dnaDCL(Subr, subrs);          /* Per-subr data [count] */
+    dnaDCL(Subr *, order);        /* Kept subrs in new index order */
+    long bias;                    /* Source subr bias */
+    long newBias;                 /* Kept subr bias */
+} SubrINDEX;
+
+typedef struct /* Kept glyph */
+{
+    long offset; /* Charstring offset in h->cstrs */
+    long length; /* Charstring length */
+    long iSite;  /* First call site in h->sites */
+    long nSites; /* Call site count */
+    uint16_t iFD;
+} KeptGlyph;
+
+/* ----------------------------- Module context ---------------------------- */
+
+struct pruneCtx_ {
+    short flags;
+#define SOURCE_SET (1 << 0) /* Client set subr source for current font */
+#define FONT_SCAN  (1 << 1) /* Scanning current font glyphs */
+    cfwSubrSource src;                 /* Client subr source */
+    dnaDCL(cfwSubrSourceFD, FDArray);  /* Copy of client FDArray */
+    SubrINDEX gsubrs;                  /* Global subrs */
+    dnaDCL(SubrINDEX, lsubrs);         /* Local subrs [nFDs] */
+    dnaDCL(CallSite, sites);           /* Recorded call sites */
+    dnaDCL(KeptGlyph, glyphs);         /* Kept glyphs */
+    dnaDCL(unsigned char, cstrs);      /* Kept glyph charstrings */
+    dnaDCL(unsigned char, cstr);       /* Source glyph charstring */
+    dnaDCL(unsigned char, buf);        /* Source data and output buffer */
+    dnaDCL(Subr *, called);            /* Subrs called by current glyph */
+    struct                             /* Scan results per call depth */
+    {
+        dnaDCL(CallSite, sites);
+        long end; /* Scan end offset */
+    } level[TX_MAX_SUBR_DEPTH + 1];
+    struct /* Charstring scan state */
+    {
+        short flags;
+#define SEEN_ENDCHAR (1 << 0) /* Charstring ended */
+        long nArgs;       /* Operand stack depth */
+        long nStems;      /* Stem hint count */
+        long stamp;       /* Glyph scan stamp */
+        SubrINDEX *local; /* Glyph's local subrs */
+    } scan;
+    cfwCtx g; /* Package context */
+};
+
+/* Initialize subr INDEX. */
+static void initSubrINDEX(cfwCtx g, SubrINDEX *index) {
+    dnaINIT(g->ctx.dnaSafe, index->offset, 500, 1000);
+    dnaINIT(g->ctx.dnaSafe, index->data, 5000, 10000);
+    dnaINIT(g->ctx.dnaSafe, index->subrs, 500, 1000);
+    dnaINIT(g->ctx.dnaSafe, index->order, 500, 1000);
+}
+
+/* Initialize local subr INDEXes. */
+static void initLocalSubrs(void *ctx, long cnt, SubrINDEX *index) {
+    cfwCtx g = (cfwCtx)ctx;
+    while (cnt--) {
+        initSubrINDEX(g, index);
+        index++;
+    }
+}
+
+/* Free subr INDEX. */
+static void freeSubrINDEX(SubrINDEX *index) {
+    dnaFREE(index->offset);
+    dnaFREE(index->data);
+    dnaFREE(index->subrs);
+    dnaFREE(index->order);
+}
+
+/* Initialize module. */
+void cfwPruneNew(cfwCtx g) {
+    pruneCtx h = (pruneCtx)cfwMemNew(g, sizeof(struct pruneCtx_));
+    int i;
+
+    h->flags = 0;
+    dnaINIT(g->ctx.dnaSafe, h->FDArray, 1, 10);
+    initSubrINDEX(g, &h->gsubrs);
+    dnaINIT(g->ctx.dnaSafe, h->lsubrs, 1, 10);
+    h->lsubrs.func = initLocalSubrs;
+    dnaINIT(g->ctx.dnaSafe, h->sites, 1000, 2000);
+    dnaINIT(g->ctx.dnaSafe, h->glyphs, 250, 1000);
+    dnaINIT(g->ctx.dnaSafe, h->cstrs, 10000, 20000);
+    dnaINIT(g->ctx.dnaSafe, h->cstr, 500, 1000);
+    dnaINIT(g->ctx.dnaSafe, h->buf, 10000, 20000);
+    dnaINIT(g->ctx.dnaSafe, h->called, 50, 100);
+    for (i = 0; i <= TX_MAX_SUBR_DEPTH; i++) {
+        dnaINIT(g->ctx.dnaSafe, h->level[i].sites, 10, 20);
+    }
+
+    /* Link contexts */
+    h->g = g;
+    g->ctx.prune = h;
+}
+
+/* Prepare module for reuse. */
+void cfwPruneReuse(cfwCtx g) {
+    pruneCtx h = g->ctx.prune;
+    h->flags = 0;
+}
+
+/* Free resources. */
+void cfwPruneFree(cfwCtx g) {
+    pruneCtx h = g->ctx.prune;
+    long i;
+
+    if (h == NULL) {
+        return;
+    }
+
+    dnaFREE(h->FDArray);
+    freeSubrINDEX(&h->gsubrs);
+    for (i = 0; i < h->lsubrs.size; i++) {
+        freeSubrINDEX(&h->lsubrs.array[i]);
+    }
+    dnaFREE(h->lsubrs);
+    dnaFREE(h->sites);
+    dnaFREE(h->glyphs);
+    dnaFREE(h->cstrs);
+    dnaFREE(h->cstr);
+    dnaFREE(h->buf);
+    dnaFREE(h->called);
+    for (i = 0; i <= TX_MAX_SUBR_DEPTH; i++) {
+        dnaFREE(h->level[i].sites);
+    }
+
+    cfwMemFree(g, h);
+    g->ctx.prune = NULL;
+}
+
+/* Forget subr source; called at the beginning of each font. */
+void cfwPruneClearSource(cfwCtx g) {
+    pruneCtx h = g->ctx.prune;
+    h->flags = 0;
+}
+
+/* Save client subr source for the current font. */
+void cfwPruneSetSource(cfwCtx g, cfwSubrSource *src) {
+    pruneCtx h = g->ctx.prune;
+
+    h->src = *src;
+    if (src->nFDs > 0) {
+        dnaSET_CNT(h->FDArray, src->nFDs);
+        memcpy(h->FDArray.array, src->FDArray,
+               sizeof(cfwSubrSourceFD) * src->nFDs);
+    } else {
+        h->FDArray.cnt = 0;
+    }
+    h->src.nFDs = h->FDArray.cnt;
+    h->src.FDArray = h->FDArray.array;
+    h->flags = SOURCE_SET;
+}
+
+/* ------------------------------ Source Data ------------------------------ */
+
+/* Read source data; return 1 on error. */
+static int readSrc(pruneCtx h, long offset, long count, unsigned char *ptr) {
+    return h->src.read(&h->src, offset, (size_t)count, (char *)ptr) != 0;
+}
+
+/* Return subr bias for subr count. */
+static long subrBias(long count) {
+    return (count < 1240) ? 107 : (count < 33900) ? 1131 : 32768;
+}
+
+/* Load subr INDEX from source region; return 1 on error. */
+static int loadSubrINDEX(pruneCtx h, SubrINDEX *index, ctlRegion *region) {
+    long size = region->end - region->begin;
+    long count;
+    long hdrSize;
+    long i;
+    int offSize;
+    unsigned char *p;
+
+    index->offset.cnt = 0;
+    index->data.cnt = 0;
+    index->subrs.cnt = 0;
+    index->order.cnt = 0;
+    index->bias = 0;
+
+    if (region->begin == -1 || size <= 2) {
+        return 0; /* Missing or empty INDEX */
+    }
+
+    dnaSET_CNT(h->buf, size);
+    p = h->buf.array;
+    if (readSrc(h, region->begin, size, p)) {
+        return 1;
+    }
+
+    count = (long)p[0] << 8 | p[1];
+    if (count == 0) {
+        return 0;
+    }
+    offSize = p[2];
+    hdrSize = 3 + (count + 1) * offSize;
+    if (offSize < 1 || offSize > 4 || hdrSize > size) {
+        return 1;
+    }
+
+    /* Read offsets, converting them to 0-based data offsets */
+    dnaSET_CNT(index->offset, count + 1);
+    for (i = 0; i <= count; i++) {
+        unsigned char *q = &p[3 + i * offSize];
+        long offset = 0;
+        int j;
+        for (j = 0; j < offSize; j++) {
+            offset = offset << 8 | q[j];
+        }
+        offset--;
+        if (offset < ((i == 0) ? 0 : index->offset.array[i - 1]) ||
+            offset > size - hdrSize || (i == 0 && offset != 0)) {
+            return 1;
+        }
+        index->offset.array[i] = offset;
+    }
+
+    dnaSET_CNT(index->data, index->offset.array[count]);
+    memcpy(index->data.array, &p[hdrSize], index->data.cnt);
+
+    dnaSET_CNT(index->subrs, count);
+    memset(index->subrs.array, 0, sizeof(Subr) * count);
+    index->bias = subrBias(count);
+
+    return 0;
+}
+
+/* --------------------------- Charstring Scanning ------------------------- */
+
+static int scanCstr(pruneCtx h, unsigned char *cstr, long length,
+                    int depth, int global);
+
+/* Scan subr; return 1 if it can't be kept in this context. */
+static int scanSubr(pruneCtx h, SubrINDEX *index, long iSubr,
+                    int depth, int global) {
+    Subr *subr = &index->subrs.array[iSubr];
+    CallSite *sites;
+    long offset = index->offset.array[iSubr];
+    long i;
+
+    if (subr->state == SUBR_SCANNING) {
+        return 1; /* Recursive call */
+    }
+    if (subr->state == SUBR_UNSEEN) {
+        subr->state = SUBR_SCANNING;
+    }
+
+    if (scanCstr(h, &index->data.array[offset],
+                 index->offset.array[iSubr + 1] - offset, depth, global)) {
+        if (subr->state == SUBR_SCANNING) {
+            subr->state = SUBR_UNSEEN;
+        }
+        return 1;
+    }
+
+    sites = h->level[depth].sites.array;
+    if (subr->state == SUBR_SCANNING) {
+        /* First scan; record call sites */
+        subr->iSite = h->sites.cnt;
+        subr->nSites = h->level[depth].sites.cnt;
+        subr->end = h->level[depth].end;
+        if (subr->nSites > 0) {
+            memcpy(dnaEXTEND(h->sites, subr->nSites), sites,
+                   sizeof(CallSite) * subr->nSites);
+        }
+        subr->state = SUBR_OK;
+    } else {
+        /* Rescan; call sites must not depend on calling context */
+        if (h->level[depth].sites.cnt != subr->nSites ||
+            h->level[depth].end != subr->end) {
+            return 1;
+        }
+        for (i = 0; i < subr->nSites; i++) {
+            CallSite *site = &h->sites.array[subr->iSite + i];
+            if (sites[i].offset != site->offset ||
+                sites[i].iSubr != site->iSubr ||
+                sites[i].global != site->global) {
+                return 1;
+            }
+        }
+    }
+
+    if (subr->stamp != h->scan.stamp) {
+        subr->stamp = h->scan.stamp;
+        *dnaNEXT(h->called) = subr;
+    }
+
+    return 0;
+}
+
+/* Scan charstring, tracking the operand stack depth and stem count, and
+   recording subr calls; return 1 if the charstring can't be kept. Scanning
+   stops at the first unsupported operator; the arithmetic, storage,
+   deprecated and CFF2-only operators aren't supported. */
+static int scanCstr(pruneCtx h, unsigned char *cstr, long length,
+                    int depth, int global) {
+    long i = 0;
+    long lastOff = -1; /* Offset of preceding integer operand */
+    long lastVal = 0;
+    int lastLen = 0;
+
+    h->level[depth].sites.cnt = 0;
+
+    while (i < length) {
+        int b0 = cstr[i];
+        long start = i;
+
+        if (b0 == t2_shortint || b0 >= 32) {
+            /* Operand */
+            int len;
+            if (b0 == t2_shortint) {
+                len = 3;
+                if (i + len > length) {
+                    return 1;
+                }
+                lastVal = (short)(cstr[i + 1] << 8 | cstr[i + 2]);
+            } else if (b0 < 247) {
+                len = 1;
+                lastVal = b0 - 139;
+            } else if (b0 < 255) {
+                len = 2;
+                if (i + len > length) {
+                    return 1;
+                }
+                lastVal = (b0 < 251) ? (b0 - 247) * 256 + cstr[i + 1] + 108
+                                     : -(b0 - 251) * 256 - cstr[i + 1] - 108;
+            } else {
+                len = 5;
+                if (i + len > length) {
+                    return 1;
+                }
+            }
+            if (++h->scan.nArgs > T2_MAX_OP_STACK) {
+                return 1;
+            }
+            lastOff = (b0 == 255) ? -1 : start;
+            lastLen = len;
+            i += len;
+            continue;
+        }
+
+        i++;
+        switch (b0) {
+            case tx_hstem:
+            case tx_vstem:
+            case t2_hstemhm:
+            case t2_vstemhm:
+                /* An odd operand count includes the width */
+                h->scan.nStems += h->scan.nArgs / 2;
+                h->scan.nArgs = 0;
+                break;
+            case t2_hintmask:
+            case t2_cntrmask:
+                h->scan.nStems += h->scan.nArgs / 2;
+                h->scan.nArgs = 0;
+                i += (h->scan.nStems + 7) / 8;
+                if (i > length) {
+                    return 1;
+                }
+                break;
+            case tx_rmoveto:
+            case tx_hmoveto:
+            case tx_vmoveto:
+            case tx_rlineto:
+            case tx_hlineto:
+            case tx_vlineto:
+            case tx_rrcurveto:
+            case t2_rcurveline:
+            case t2_rlinecurve:
+            case t2_vvcurveto:
+            case t2_hhcurveto:
+            case tx_vhcurveto:
+            case tx_hvcurveto:
+                h->scan.nArgs = 0;
+                break;
+            case tx_endchar:
+                if (h->scan.nArgs >= 4) {
+                    return 1; /* seac */
+                }
+                h->scan.nArgs = 0;
+                h->scan.flags |= SEEN_ENDCHAR;
+                h->level[depth].end = i;
+                return 0;
+            case tx_return:
+                h->level[depth].end = i - 1;
+                return depth == 0;
+            case tx_callsubr:
+            case t2_callgsubr: {
+                SubrINDEX *index;
+                CallSite *site;
+                long iSubr;
+
+                if (lastOff == -1 || lastOff + lastLen != start) {
+                    return 1; /* Subr number not a literal */
+                }
+                h->scan.nArgs--;
+                if (b0 == t2_callgsubr) {
+                    index = &h->gsubrs;
+                } else if (global && h->lsubrs.cnt > 1) {
+                    return 1; /* Local subrs depend on calling glyph */
+                } else {
+                    index = h->scan.local;
+                }
+                iSubr = lastVal + index->bias;
+                if (iSubr < 0 || iSubr >= index->subrs.cnt ||
+                    depth == TX_MAX_SUBR_DEPTH) {
+                    return 1;
+                }
+
+                site = dnaNEXT(h->level[depth].sites);
+                site->offset = lastOff;
+                site->iSubr = iSubr;
+                site->length = (unsigned char)lastLen;
+                site->global = (b0 == t2_callgsubr);
+
+                if (scanSubr(h, index, iSubr, depth + 1,
+                             global || b0 == t2_callgsubr)) {
+                    return 1;
+                }
+                if (h->scan.flags & SEEN_ENDCHAR) {
+                    h->level[depth].end = i;
+                    return 0;
+                }
+                break;
+            }
+            case tx_escape:
+                if (i == length) {
+                    return 1;
+                }
+                switch (tx_ESC(cstr[i++])) {
+                    case t2_hflex:
+                    case t2_flex:
+                    case t2_hflex1:
+                    case t2_flex1:
+                        h->scan.nArgs = 0;
+                        break;
+                    default:
+                        return 1;
+                }
+                break;
+            default:
+                return 1;
+        }
+        lastOff = -1;
+    }
+
+    /* Charstrings must end with endchar; subrs may omit return */
+    h->level[depth].end = length;
+    return depth == 0;
+}
+
+/* ------------------------------- Renumbering ----------------------------- */
+
+/* Compare subrs by decreasing call count, then by source index. */
+static int CTL_CDECL cmpCounts(const void *first, const void *second,
+                               void *ctx) {
+    const Subr *a = *(Subr **)first;
+    const Subr *b = *(Subr **)second;
+    if (a->count != b->count) {
+        return (a->count > b->count) ? -1 : 1;
+    }
+    return (a < b) ? -1 : (a > b);
+}
+
+/* Compare subrs by new index. */
+static int CTL_CDECL cmpNewIndexes(const void *first, const void *second,
+                                   void *ctx) {
+    const Subr *a = *(Subr **)first;
+    const Subr *b = *(Subr **)second;
+    return (a->iNew < b->iNew) ? -1 : (a->iNew > b->iNew);
+}
+
+/* Return index of the subr with the specified rank (0 is most frequently
+   called) so that the more frequently called subrs have the shorter biased
+   subr numbers. This mirrors the subroutinizer's reordering. */
+static long rankIndex(long rank, long count) {
+    if (count < 1240 || rank >= 33900) {
+        return rank;
+    } else if (count < 33900) {
+        if (rank >= 1239) {
+            return rank;
+        } else if (rank >= 215) {
+            return rank - 215;
+        } else {
+            return rank + 1024;
+        }
+    } else if (rank >= 2263) {
+        return rank - 2263;
+    } else if (rank >= 1239) {
+        return rank + 31637;
+    } else if (rank >= 215) {
+        return rank + 31422;
+    } else {
+        return rank + 32661;
+    }
+}
+
+/* Return the INDEX selected by a call site in a charstring whose local subrs
+   are "local". */
+static SubrINDEX *siteINDEX(pruneCtx h, CallSite *site, SubrINDEX *local) {
+    return site->global ? &h->gsubrs : local;
+}
+
+/* Count calls to subrs from call sites. */
+static void countCalls(pruneCtx h, CallSite *site, long nSites,
+                       SubrINDEX *local) {
+    for (; nSites > 0; nSites--, site++) {
+        siteINDEX(h, site, local)->subrs.array[site->iSubr].count++;
+    }
+}
+
+/* Count calls made by used subrs in INDEX. */
+static void countSubrCalls(pruneCtx h, SubrINDEX *index, SubrINDEX *local) {
+    long i;
+    for (i = 0; i < index->subrs.cnt; i++) {
+        Subr *subr = &index->subrs.array[i];
+        if (subr->flags & SUBR_USED) {
+            countCalls(h, &h->sites.array[subr->iSite], subr->nSites, local);
+        }
+    }
+}
+
+/* Select used subrs in INDEX that are better copied into their callers: those
+   called once and short ones without calls of their own, for which the calls
+   would cost more than they save (assuming 1-byte subr numbers). */
+static void selectInlineSubrs(SubrINDEX *index) {
+    long i;
+    for (i = 0; i < index->subrs.cnt; i++) {
+        Subr *subr = &index->subrs.array[i];
+        if ((subr->flags & SUBR_USED) &&
+            (subr->count == 1 ||
+             (subr->nSites == 0 &&
+              subr->count * (subr->end - 2) <= subr->end + 3))) {
+            subr->flags |= SUBR_INLINE;
+        }
+    }
+}
+
+/* Assign new indexes to kept subrs in INDEX. */
+static void numberSubrs(pruneCtx h, SubrINDEX *index) {
+    long i;
+
+    index->order.cnt = 0;
+    for (i = 0; i < index->subrs.cnt; i++) {
+        Subr *subr = &index->subrs.array[i];
+        if ((subr->flags & (SUBR_USED | SUBR_INLINE)) == SUBR_USED) {
+            *dnaNEXT(index->order) = subr;
+        }
+    }
+
+    ctuQSort(index->order.array, index->order.cnt, sizeof(Subr *),
+             cmpCounts, h);
+    for (i = 0; i < index->order.cnt; i++) {
+        index->order.array[i]->iNew = rankIndex(i, index->order.cnt);
+    }
+    ctuQSort(index->order.array, index->order.cnt, sizeof(Subr *),
+             cmpNewIndexes, h);
+
+    index->newBias = subrBias(index->order.cnt);
+}
+
+/* Append charstring to h->buf with its subr numbers patched and inlined subr
+   calls replaced by the subrs. Local subr calls in a global subr can only be
+   kept when there is a single font dict, whose local subrs are "local". */
+static void patchCstr(pruneCtx h, unsigned char *cstr, long length,
+                      CallSite *site, long nSites, SubrINDEX *local) {
+    long offset = 0;
+
+    for (; nSites > 0; nSites--, site++) {
+        SubrINDEX *index = siteINDEX(h, site, local);
+        Subr *subr = &index->subrs.array[site->iSubr];
+        long count = site->offset - offset;
+
+        if (count > 0) {
+            memcpy(dnaEXTEND(h->buf, count), &cstr[offset], count);
+        }
+        if (subr->flags & SUBR_INLINE) {
+            /* Copy subr in place of subr number and call operator */
+            patchCstr(h, &index->data.array[index->offset.array[site->iSubr]],
+                      subr->end, &h->sites.array[subr->iSite], subr->nSites,
+                      local);
+            offset = site->offset + site->length + 1;
+        } else {
+            unsigned char t[5];
+            int n = cfwEncInt(subr->iNew - index->newBias, t);
+            memcpy(dnaEXTEND(h->buf, n), t, n);
+            offset = site->offset + site->length;
+        }
+    }
+
+    if (length > offset) {
+        memcpy(dnaEXTEND(h->buf, length - offset), &cstr[offset],
+               length - offset);
+    }
+}
+
+/* ------------------------------ Interface ------------------------------- */
+
+/* Begin scanning the glyphs of the current font; return 0 if the source subrs
+   can't be used. */
+int cfwPruneBegFont(cfwCtx g, long nFDs) {
+    pruneCtx h = g->ctx.prune;
+    long i;
+
+    if (!(h->flags & SOURCE_SET) || h->src.nFDs != nFDs) {
+        return 0;
+    }
+    h->flags &= ~FONT_SCAN;
+
+    if (loadSubrINDEX(h, &h->gsubrs, &h->src.GlobalSubrINDEX)) {
+        return 0;
+    }
+    dnaSET_CNT(h->lsubrs, nFDs);
+    for (i = 0; i < nFDs; i++) {
+        if (loadSubrINDEX(h, &h->lsubrs.array[i],
+                          &h->src.FDArray[i].LocalSubrINDEX)) {
+            return 0;
+        }
+    }
+
+    h->sites.cnt = 0;
+    h->glyphs.cnt = 0;
+    h->cstrs.cnt = 0;
+    h->scan.stamp = 0;
+    h->flags |= FONT_SCAN;
+
+    return 1;
+}
+
+/* Scan glyph's source charstring. Return the index of the kept glyph, or -1
+   if the glyph must keep its flattened charstring. */
+long cfwPruneAddGlyph(cfwCtx g, abfGlyphInfo *info, uint16_t iFD) {
+    pruneCtx h = g->ctx.prune;
+    ctlRegion *region = &h->src.CharStringsINDEX;
+    KeptGlyph *glyph;
+    long length;
+    long i;
+
+    if (!(h->flags & FONT_SCAN) || info == NULL || iFD >= h->lsubrs.cnt ||
+        info->sup.begin < region->begin || info->sup.end > region->end ||
+        info->sup.begin >= info->sup.end) {
+        return -1;
+    }
+
+    length = info->sup.end - info->sup.begin;
+    dnaSET_CNT(h->cstr, length);
+    if (readSrc(h, info->sup.begin, length, h->cstr.array)) {
+        return -1;
+    }
+
+    /* Scan charstring */
+    h->scan.flags = 0;
+    h->scan.nArgs = 0;
+    h->scan.nStems = 0;
+    h->scan.stamp++;
+    h->scan.local = &h->lsubrs.array[iFD];
+    h->called.cnt = 0;
+    if (scanCstr(h, h->cstr.array, length, 0, 0)) {
+        return -1;
+    }
+
+    /* Save charstring and call sites */
+    glyph = dnaNEXT(h->glyphs);
+    glyph->iFD = iFD;
+    glyph->offset = h->cstrs.cnt;
+    glyph->length = length;
+    memcpy(dnaEXTEND(h->cstrs, length), h->cstr.array, length);
+    glyph->iSite = h->sites.cnt;
+    glyph->nSites = h->level[0].sites.cnt;
+    if (glyph->nSites > 0) {
+        memcpy(dnaEXTEND(h->sites, glyph->nSites), h->level[0].sites.array,
+               sizeof(CallSite) * glyph->nSites);
+    }
+
+    /* Mark called subrs used */
+    for (i = 0; i < h->called.cnt; i++) {
+        h->called.array[i]->flags |= SUBR_USED;
+    }
+
+    return h->glyphs.cnt - 1;
+}
+
+/* Renumber used subrs. */
+void cfwPruneEndFont(cfwCtx g) {
+    pruneCtx h = g->ctx.prune;
+    long i;
+
+    if (!(h->flags & FONT_SCAN)) {
+        return;
+    }
+
+    /* Count calls from kept glyphs and used subrs */
+    for (i = 0; i < h->glyphs.cnt; i++) {
+        KeptGlyph *glyph = &h->glyphs.array[i];
+        countCalls(h, &h->sites.array[glyph->iSite], glyph->nSites,
+                   &h->lsubrs.array[glyph->iFD]);
+    }
+    countSubrCalls(h, &h->gsubrs, &h->lsubrs.array[0]);
+    for (i = 0; i < h->lsubrs.cnt; i++) {
+        countSubrCalls(h, &h->lsubrs.array[i], &h->lsubrs.array[i]);
+    }
+
+    selectInlineSubrs(&h->gsubrs);
+    numberSubrs(h, &h->gsubrs);
+    for (i = 0; i < h->lsubrs.cnt; i++) {
+        selectInlineSubrs(&h->lsubrs.array[i]);
+        numberSubrs(h, &h->lsubrs.array[i]);
+    }
+}
+
+/* Make used subrs of font dict "iFD" (global subrs if -1) in new order. */
+void cfwPruneGetSubrs(cfwCtx g, long iFD, subr_CSData *subrs) {
+    pruneCtx h = g->ctx.prune;
+    SubrINDEX *index;
+    SubrINDEX *local;
+    long i;
+
+    subrs->nStrings = 0;
+    subrs->offset = NULL;
+    subrs->data = NULL;
+
+    if (!(h->flags & FONT_SCAN)) {
+        return;
+    }
+    if (iFD == -1) {
+        index = &h->gsubrs;
+        local = &h->lsubrs.array[0];
+    } else {
+        index = local = &h->lsubrs.array[iFD];
+    }
+    if (index->order.cnt == 0) {
+        return;
+    }
+
+    subrs->nStrings = (unsigned short)index->order.cnt;
+    subrs->offset = (Offset *)cfwMemNew(g, sizeof(Offset) * subrs->nStrings);
+    h->buf.cnt = 0;
+    for (i = 0; i < index->order.cnt; i++) {
+        Subr *subr = index->order.array[i];
+        long iSubr = (long)(subr - index->subrs.array);
+        long offset = index->offset.array[iSubr];
+        patchCstr(h, &index->data.array[offset],
+                  index->offset.array[iSubr + 1] - offset,
+                  &h->sites.array[subr->iSite], subr->nSites, local);
+        subrs->offset[i] = h->buf.cnt;
+    }
+    subrs->data = (char *)cfwMemNew(g, h->buf.cnt);
+    memcpy(subrs->data, h->buf.array, h->buf.cnt);
+}
+
+/* Get source widths of font dict "iFD". */
+void cfwPruneGetWidths(cfwCtx g, long iFD, float *dflt, float *nominal) {
+    pruneCtx h = g->ctx.prune;
+    *dflt = h->src.FDArray[iFD].defaultWidthX;
+    *nominal = h->src.FDArray[iFD].nominalWidthX;
+}
+
+/* Write kept glyph charstring to the tmp stream; return its length. */
+long cfwPruneWriteGlyph(cfwCtx g, long iGlyph) {
+    pruneCtx h = g->ctx.prune;
+    KeptGlyph *glyph = &h->glyphs.array[iGlyph];
+
+    h->buf.cnt = 0;
+    patchCstr(h, &h->cstrs.array[glyph->offset], glyph->length,
+              &h->sites.array[glyph->iSite], glyph->nSites,
+              &h->lsubrs.array[glyph->iFD]);
+    if (g->cb.stm.write(&g->cb.stm, g->stm.tmp, h->buf.cnt,
+                        (char *)h->buf.array) != (size_t)h->buf.cnt) {
+        cfwFatal(g, cfwErrTmpStream, NULL);
+    }
+
+    return h->buf.cnt;
+}
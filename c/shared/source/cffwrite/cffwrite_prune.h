@@ -0,0 +1,29 @@
+/* Copyright 2014 Adobe Systems Incorporated (http://www.adobe.com/). All Rights Reserved.
+   This software is licensed as OpenSource, under the Apache License, Version 2.0.
+   This license is available at: http://opensource.org/licenses/Apache-2.0. */
+
+/*
+ * Source subr retention support.
+ */
+
+#ifndef CFFWRITE_PRUNE_H
+#define CFFWRITE_PRUNE_H
+
+#include "cffwrite_share.h"
+#include "cffwrite_subr.h"
+
+void cfwPruneNew(cfwCtx g);
+void cfwPruneReuse(cfwCtx g);
+void cfwPruneFree(cfwCtx g);
+
+void cfwPruneClearSource(cfwCtx g);
+void cfwPruneSetSource(cfwCtx g, cfwSubrSource *src);
+
+int cfwPruneBegFont(cfwCtx g, long nFDs);
+long cfwPruneAddGlyph(cfwCtx g, abfGlyphInfo *info, uint16_t iFD);
+void cfwPruneEndFont(cfwCtx g);
+void cfwPruneGetSubrs(cfwCtx g, long iFD, subr_CSData *subrs);
+void cfwPruneGetWidths(cfwCtx g, long iFD, float *dflt, float *nominal);
+long cfwPruneWriteGlyph(cfwCtx g, long iGlyph);
+
+#endif /* CFFWRITE_PRUNE_H */
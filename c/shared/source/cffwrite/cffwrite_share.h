@@ -66,7 +66,7 @@ int cfwEncReal(float r, unsigned char *t);
 long cfwSeenGlyph(cfwCtx g, abfGlyphInfo *info, int *result,
                   long startNew, long endNew);
 void cfwAddGlyph(cfwCtx g, abfGlyphInfo *info, float hAdv, long length,
-                 long offset, long seen_index);
+                 long offset, long seen_index, int fixed);
 
 /* -------------------------------- Contexts -------------------------------
 
@@ -110,6 +110,7 @@ typedef struct sindexCtx_ *sindexCtx;
 typedef struct dictCtx_ *dictCtx;
 typedef struct cstrCtx_ *cstrCtx;
 typedef struct subrCtx_ *subrCtx;
+typedef struct pruneCtx_ *pruneCtx;
 
 /* Library context (the one returned to client) */
 struct cfwCtx_ {
@@ -145,6 +146,7 @@ struct cfwCtx_ {
         dictCtx dict;
         cstrCtx cstr;
         subrCtx subr;
+        pruneCtx prune;
     } ctx;
     struct /* Error handling */
     {
@@ -3134,6 +3134,13 @@ long cfwSubrSizeGlobal(cfwCtx g) {
     return size;
 }
 
+/* Set global subrs from data built outside the subroutinizer */
+void cfwSubrSetGlobal(cfwCtx g, subr_CSData *gsubrs) {
+    subrCtx h = g->ctx.subr;
+    csFreeData(g, &h->gsubrs);
+    h->gsubrs = *gsubrs;
+}
+
 /* Write subrs */
 static void subrWrite(cfwCtx g, subr_CSData *subrs) {
     long dataSize;
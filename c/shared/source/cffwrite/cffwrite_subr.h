@@ -74,6 +74,7 @@ long cfwSubrSizeLocal(cfwCtx g, subr_CSData *subrs);
 void cfwSubrWriteLocal(cfwCtx g, subr_CSData *subrs);
 
 long cfwSubrSizeGlobal(cfwCtx g);
+void cfwSubrSetGlobal(cfwCtx g, subr_CSData *gsubrs);
 void cfwSubrWriteGlobal(cfwCtx g);
 
 #endif /* CFFWRITE_SUBR_H */
@@ -70,6 +70,12 @@ enum /* Warning types */
     warn_cnt
 };
 
+/* Warnings reporting changes to the source glyph data */
+#define WARN_FIXUPS                                                \
+    (1 << warn_move0 | 1 << warn_move1 | 1 << warn_move2 |        \
+     1 << warn_hint0 | 1 << warn_hint1 | 1 << warn_hint3 |        \
+     1 << warn_hint5 | 1 << warn_hint6 | 1 << warn_hint7)
+
 /* Hintmask */
 #define MAX_MASK_BYTES ((T2_MAX_STEMS + 7) / 8)
 typedef char HintMask[MAX_MASK_BYTES];
@@ -182,6 +188,15 @@ void cfwCstrReuse(cfwCtx g) {
     h->tmpoff = 0;
 }
 
+/* Resynchronize tmp stream offset after other modules have written to it. */
+void cfwCstrSyncTmp(cfwCtx g) {
+    cstrCtx h = g->ctx.cstr;
+    h->tmpoff = g->cb.stm.tell(&g->cb.stm, g->stm.tmp);
+    if (h->tmpoff == -1) {
+        cfwFatal(g, cfwErrTmpStream, NULL);
+    }
+}
+
 /* Free resources. */
 void cfwCstrFree(cfwCtx g) {
     cstrCtx h = g->ctx.cstr;
@@ -2539,7 +2554,9 @@ static void glyphEnd(abfGlyphCallbacks *cb) {
         if (g->flags & CFW_CHECK_IF_GLYPHS_DIFFER) {
             /* check and see if glyph has been already seen */
             seen_index = cfwSeenGlyph(g, h->glyph.info, &errorCode, cstroff, h->tmpoff);
-            if (errorCode) {
+            if (errorCode == cfwErrNoMemory) {
+                g->err.code = cfwErrNoMemory;
+            } else if (errorCode) {
                 /* set the cfwCtx error code.*/
                 g->err.code |= errorCode;
                 if (errorCode == cfwErrGlyphPresent) {
@@ -2554,7 +2571,8 @@ static void glyphEnd(abfGlyphCallbacks *cb) {
             }
         }
         if (errorCode == 0) {
-            cfwAddGlyph(g, h->glyph.info, h->glyph.hAdv, h->tmpoff - cstroff, cstroff, seen_index);
+            cfwAddGlyph(g, h->glyph.info, h->glyph.hAdv, h->tmpoff - cstroff, cstroff, seen_index,
+                        (h->glyphwarning & WARN_FIXUPS) != 0);
         }
     }
 
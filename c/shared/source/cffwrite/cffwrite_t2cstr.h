@@ -16,6 +16,7 @@ void cfwCstrReuse(cfwCtx g);
 void cfwCstrFree(cfwCtx g);
 
 void cfwCstrBegFont(cfwCtx g, int nFDs);
+void cfwCstrSyncTmp(cfwCtx g);
 void printFinalWarn(cfwCtx g);
 
 #endif /* CSTR_H */
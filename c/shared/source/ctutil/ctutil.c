@@ -119,6 +119,48 @@ int ctuLookup(const void *key, const void *base, size_t count, size_t size,
     return 0;
 }
 
+/* Hash string (FNV-1a, with high bits folded into the low slot bits). */
+unsigned long ctuHashString(const char *s) {
+    const unsigned char *p = (const unsigned char *)s;
+    unsigned long hash = 2166136261UL;
+
+    while (*p != '\0') {
+        hash = (hash ^ *p++) * 16777619UL;
+    }
+    return hash ^ (hash >> 15);
+}
+
+/* Linear probe hash table for key. Returns matching slot, or empty slot
+   where key should be added, and sets "found" accordingly. */
+long ctuHashFind(const void *key, unsigned long hash, const long *slots,
+                 long size, ctuHashMatchFunc match, int *found, void *ctx) {
+    long mask = size - 1;
+    long slot = (long)(hash & mask);
+
+    for (;;) {
+        long index = slots[slot];
+        if (index == -1) {
+            *found = 0;
+            return slot;
+        } else if (match(key, index, ctx)) {
+            *found = 1;
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+/* Return hash table size needed for count elements. */
+long ctuHashSize(long size, long count) {
+    if (size == 0) {
+        size = 1024;
+    }
+    while (count * 2 > size) {
+        size *= 2;
+    }
+    return size;
+}
+
 /* Convert ANSI standard date/time format to Apple LongDateTime format.
    Algorithm adapted from standard Julian Day calculation. */
 void ctuANSITime2LongDateTime(struct tm *ansi, ctuLongDateTime ldt) {
@@ -240,35 +282,172 @@ double ctuStrtod(const char *s, char **endptr) {
     return result;
 }
 
-/* Convert double in a locale-independent manner. */
-void ctuDtostr(char *buf, size_t bufLen, double value, int width, int precision) {
-    char *p;
-    if (width == 0 && precision == 0) {
-        SPRINTF_S(buf, bufLen, "%.12lf", value);
-    } else if (width == 0 && precision > 0) {
-        SPRINTF_S(buf, bufLen, "%.*lf", precision, value);
-    } else if (width > 0 && precision == 0) {
-        SPRINTF_S(buf, bufLen, "%*lf", width, value);
+/* Two-digit strings for 00-99. */
+static const char digit_pairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/* Convert long to decimal string. */
+size_t ctuLtostr(char *buf, long value) {
+    char digits[24];
+    char *p = digits + sizeof(digits);
+    unsigned long u = (value < 0) ? 0UL - (unsigned long)value : (unsigned long)value;
+    size_t length;
+
+    /* Extract digits from the right, two at a time */
+    while (u >= 100) {
+        unsigned i = (unsigned)(u % 100) * 2;
+        u /= 100;
+        *--p = digit_pairs[i + 1];
+        *--p = digit_pairs[i];
+    }
+    if (u >= 10) {
+        unsigned i = (unsigned)u * 2;
+        *--p = digit_pairs[i + 1];
+        *--p = digit_pairs[i];
     } else {
-        SPRINTF_S(buf, bufLen, "%*.*lf", width, precision, value);
+        *--p = (char)('0' + u);
     }
-    p = strchr(buf, ',');
-    if (p != NULL) {
-        /* Non-C locale in use; convert to C locale convention */
-        *p = '.';
+
+    if (value < 0) {
+        *--p = '-';
     }
-    p = strchr(buf, '.');
+
+    length = digits + sizeof(digits) - p;
+    memcpy(buf, p, length);
+    buf[length] = '\0';
+    return length;
+}
+
+/* Remove trailing fraction zeros, and the decimal point if no fraction digits
+   remain, from string of "length" bytes. Returns new length. */
+static size_t trimZeros(char *buf, size_t length) {
+    char *p = strchr(buf, '.');
     if (p != NULL) {
-        /* Have decimal point. Remove trailing zeros.*/
-        int l = (int)strlen(p);
-        p += l - 1;
+        p = buf + length - 1;
         while (*p == '0') {
-            *p = '\0';
             p--;
         }
         if (*p == '.') {
-            *p = '\0';
+            p--;
         }
+        length = p + 1 - buf;
+        buf[length] = '\0';
+    }
+    return length;
+}
+
+/* Convert double with the standard library. */
+static size_t printFixed(char *buf, size_t bufLen, double value, int width, int precision) {
+    char *p;
+    if (width == 0) {
+        SPRINTF_S(buf, bufLen, "%.*f", precision, value);
+    } else {
+        SPRINTF_S(buf, bufLen, "%*.*f", width, precision, value);
+    }
+    p = strchr(buf, ',');
+    if (p != NULL) {
+        /* Non-C locale in use; convert to C locale convention */
+        *p = '.';
+    }
+    return strlen(buf);
+}
+
+/* Powers of 10 that are exactly representable as doubles. */
+static const double pow10_exact[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+    1e13, 1e14, 1e15};
+
+#define FTOSTR_MAX_PRECISION (int)(sizeof(pow10_exact) / sizeof(pow10_exact[0]) - 1)
+
+/* Convert double with "%.*f" semantics. The digits are computed from the exact
+   product of the value and 10^precision, so they match the correctly-rounded
+   conversion of the standard library. Values whose scaled magnitude exceeds
+   2^52, and exact ties, whose rounding depends on the library, are passed to
+   the standard library. */
+size_t ctuFtostr(char *buf, size_t bufLen, double value, int precision, int trim) {
+    char digits[40];
+    char *p = digits + sizeof(digits);
+    double scale;
+    double scaled;
+    double error;
+    double whole;
+    double frac;
+    uint64_t q;
+    size_t length;
+    int i;
+
+    if (precision < 0 || precision > FTOSTR_MAX_PRECISION || bufLen < sizeof(digits)) {
+        goto slow;
+    }
+
+    scale = pow10_exact[precision];
+    scaled = value * scale;
+    if (!(fabs(scaled) < 4503599627370496.0)) {
+        goto slow; /* Out of range or NaN */
+    }
+
+    /* scaled + error is the exact product; scaled - whole is exact */
+    error = fma(value, scale, -scaled);
+    whole = floor(scaled + 0.5);
+    frac = (scaled - whole) + error;
+    if (frac < -0.5) {
+        whole -= 1;
+    } else if (frac > 0.5) {
+        whole += 1;
+    } else if (frac == -0.5 || frac == 0.5) {
+        goto slow; /* Exact tie */
+    }
+    q = (uint64_t)fabs(whole);
+
+    /* Fraction digits */
+    length = 0;
+    for (i = 0; i < precision; i++) {
+        char digit = (char)('0' + q % 10);
+        q /= 10;
+        if (length > 0 || digit != '0' || !trim) {
+            *--p = digit;
+            length++;
+        }
+    }
+    if (length > 0) {
+        *--p = '.';
+    }
+
+    /* Integer digits */
+    do {
+        *--p = (char)('0' + q % 10);
+        q /= 10;
+    } while (q);
+
+    if (signbit(value)) {
+        *--p = '-';
+    }
+
+    length = digits + sizeof(digits) - p;
+    memcpy(buf, p, length);
+    buf[length] = '\0';
+    return length;
+
+slow:
+    length = printFixed(buf, bufLen, value, 0, (precision < 0) ? 6 : precision);
+    return trim ? trimZeros(buf, length) : length;
+}
+
+/* Convert double in a locale-independent manner. */
+void ctuDtostr(char *buf, size_t bufLen, double value, int width, int precision) {
+    if (width == 0) {
+        (void)ctuFtostr(buf, bufLen, value, (precision == 0) ? 12 : precision, 1);
+    } else {
+        (void)trimZeros(buf, printFixed(buf, bufLen, value, width, (precision == 0) ? 6 : precision));
     }
 }
 
@@ -169,6 +169,7 @@ typedef struct /* Per-glyph objects */
         OBJ obj;
     } page;
     OBJ bearings; /* Side-bearing tics */
+    OBJ form;     /* Outline Form XObject (PDW_COMPRESS) */
 } Glyph;
 
 enum /* Object streams */
@@ -180,6 +181,8 @@ enum /* Object streams */
     STM_HINT,
     STM_FLEX,
     STM_LINKS,
+    STM_BEARINGS, /* Side-bearing tics (PDW_COMPRESS) */
+    STM_PAGE,     /* Palette page content (PDW_COMPRESS) */
     STM_CNT
 };
 
@@ -201,10 +204,22 @@ struct pdwCtx_ {
         OBJ page_mtx_key; /* Page metrics key */
         OBJ text_font;    /* Text font */
         OBJ coord_font;   /* Coord font */
+        OBJ pages;        /* Page tree root (PDW_COMPRESS) */
+        OBJ zone;         /* Hint zones (PDW_COMPRESS) */
+        OBJ transform;    /* Outline transformation (PDW_COMPRESS) */
     } obj;
     STM stms[STM_CNT];  /* Object streams */
     dnaDCL(long, xref); /* Object offsets */
     dnaDCL(OBJ, pages); /* Page objects */
+    dnaDCL(OBJ, glyphpages); /* Glyph page objects (PDW_COMPRESS) */
+    struct                   /* Flate encoder */
+    {
+        STM out;             /* Encoded data */
+        dnaDCL(long, head);  /* Most recent position for each hash */
+        dnaDCL(long, prev);  /* Previous position with same hash */
+        unsigned long bits;  /* Bit accumulator */
+        int nBits;           /* Bits in accumulator */
+    } flate;
     struct              /* Text parameters */
     {
         short iStm;    /* Text stream */
@@ -224,6 +239,10 @@ struct pdwCtx_ {
         float fy;
         float sx; /* Second point in path */
         float sy;
+        float left; /* Bounds of all points (PDW_COMPRESS) */
+        float bottom;
+        float right;
+        float top;
         int cnt; /* Point count */
         int moves;
         int lines;
@@ -263,6 +282,9 @@ struct pdwCtx_ {
 static void writePDFBeg(pdwCtx h);
 static void writePDFEnd(pdwCtx h);
 static void writePages(pdwCtx h);
+static void writeGlyphObjs(pdwCtx h, abfGlyphInfo *info);
+static OBJ writeZoneObj(pdwCtx h, long iFD);
+static OBJ writeTransformObj(pdwCtx h);
 
 /* ----------------------------- Error Handling ---------------------------- */
 
@@ -332,6 +354,12 @@ pdwCtx pdwNew(ctlMemoryCallbacks *mem_cb, ctlStreamCallbacks *stm_cb,
     dnaINIT(h->dna, h->stms[STM_HINT], 200, 500);
     dnaINIT(h->dna, h->stms[STM_FLEX], 200, 500);
     dnaINIT(h->dna, h->stms[STM_LINKS], 200, 500);
+    dnaINIT(h->dna, h->stms[STM_BEARINGS], 200, 500);
+    dnaINIT(h->dna, h->stms[STM_PAGE], 20000, 20000);
+    dnaINIT(h->dna, h->glyphpages, 250, 750);
+    dnaINIT(h->dna, h->flate.out, 1000, 5000);
+    dnaINIT(h->dna, h->flate.head, 1, 1);
+    dnaINIT(h->dna, h->flate.prev, 1, 1);
 
     return h;
 }
@@ -356,6 +384,12 @@ int pdwFree(pdwCtx h) {
     dnaFREE(h->stms[STM_HINT]);
     dnaFREE(h->stms[STM_FLEX]);
     dnaFREE(h->stms[STM_LINKS]);
+    dnaFREE(h->stms[STM_BEARINGS]);
+    dnaFREE(h->stms[STM_PAGE]);
+    dnaFREE(h->glyphpages);
+    dnaFREE(h->flate.out);
+    dnaFREE(h->flate.head);
+    dnaFREE(h->flate.prev);
 
     dnaFree(h->dna);
 
@@ -431,6 +465,15 @@ int pdwBegFont(pdwCtx h, long flags, long level, abfTopDict *top) {
     h->xref.cnt = 0;
     *dnaNEXT(h->xref) = 0;
 
+    if (h->flags & PDW_COMPRESS) {
+        /* Pages are written as they are completed */
+        h->glyphs.cnt = 0;
+        h->layers.cnt = 0;
+        h->pages.cnt = 0;
+        h->glyphpages.cnt = 0;
+        h->stms[STM_PAGE].cnt = 0;
+    }
+
     writePDFBeg(h);
 
     HANDLER
@@ -536,6 +579,186 @@ static void dstEndObj(pdwCtx h) {
              "endobj\n");
 }
 
+/* ----------------------------- Flate Encoding ---------------------------- */
+
+/* Streams are encoded as a zlib-wrapped deflate stream (RFC 1950/1951) made
+   from a single block using the fixed Huffman codes. Matches are found with a
+   hash chain search of the 32K window. Content streams are made of a small
+   set of operators and numbers so this gets most of the available
+   compression without the cost of building dynamic code tables. */
+
+#define FLATE_WINDOW 32768
+#define FLATE_HASH_BITS 14
+#define FLATE_HASH_SIZE (1 << FLATE_HASH_BITS)
+#define FLATE_MIN_MATCH 3
+#define FLATE_MAX_MATCH 258
+#define FLATE_MAX_CHAIN 32
+
+/* Length code base values and extra bits (codes 257-285) */
+static const unsigned short lengthBase[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const unsigned char lengthExtra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+
+/* Distance code base values and extra bits (codes 0-29) */
+static const unsigned short distBase[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289,
+    16385, 24577};
+static const unsigned char distExtra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+/* Add "n" bits of "value" to the encoded data, least significant bit first. */
+static void flatePutBits(pdwCtx h, unsigned long value, int n) {
+    h->flate.bits |= value << h->flate.nBits;
+    h->flate.nBits += n;
+    while (h->flate.nBits >= 8) {
+        *dnaNEXT(h->flate.out) = (char)(h->flate.bits & 0xff);
+        h->flate.bits >>= 8;
+        h->flate.nBits -= 8;
+    }
+}
+
+/* Add Huffman code. Codes are packed most significant bit first. */
+static void flatePutCode(pdwCtx h, unsigned code, int n) {
+    unsigned rev = 0;
+    int i;
+    for (i = 0; i < n; i++) {
+        rev = (rev << 1) | (code & 1);
+        code >>= 1;
+    }
+    flatePutBits(h, rev, n);
+}
+
+/* Add fixed code for literal/length symbol. */
+static void flatePutSymbol(pdwCtx h, int sym) {
+    if (sym < 144)
+        flatePutCode(h, 0x30 + sym, 8);
+    else if (sym < 256)
+        flatePutCode(h, 0x190 + sym - 144, 9);
+    else if (sym < 280)
+        flatePutCode(h, sym - 256, 7);
+    else
+        flatePutCode(h, 0xc0 + sym - 280, 8);
+}
+
+/* Add length/distance pair. */
+static void flatePutMatch(pdwCtx h, int length, int dist) {
+    int i;
+
+    for (i = 28; lengthBase[i] > length; i--)
+        ;
+    flatePutSymbol(h, 257 + i);
+    flatePutBits(h, length - lengthBase[i], lengthExtra[i]);
+
+    for (i = 29; distBase[i] > dist; i--)
+        ;
+    flatePutCode(h, i, 5);
+    flatePutBits(h, dist - distBase[i], distExtra[i]);
+}
+
+/* Hash the 3 bytes at "p". */
+static long flateHash(const unsigned char *p) {
+    return ((p[0] << 10) ^ (p[1] << 5) ^ p[2]) & (FLATE_HASH_SIZE - 1);
+}
+
+/* Encode "cnt" bytes from "src" in h->flate.out. */
+static void flateEncode(pdwCtx h, long cnt, const unsigned char *src) {
+    unsigned long a = 1;
+    unsigned long b = 0;
+    long *head;
+    long *prev;
+    long i;
+
+    if (h->flate.head.cnt == 0) {
+        dnaSET_CNT(h->flate.head, FLATE_HASH_SIZE);
+        dnaSET_CNT(h->flate.prev, FLATE_WINDOW);
+    }
+    head = h->flate.head.array;
+    prev = h->flate.prev.array;
+    for (i = 0; i < FLATE_HASH_SIZE; i++)
+        head[i] = -1;
+
+    h->flate.out.cnt = 0;
+    h->flate.bits = 0;
+    h->flate.nBits = 0;
+
+    /* zlib header (32K window, default compression) and block header
+       (BFINAL=1, BTYPE=01) */
+    flatePutBits(h, 0x78, 8);
+    flatePutBits(h, 0x9c, 8);
+    flatePutBits(h, 1, 1);
+    flatePutBits(h, 1, 2);
+
+    i = 0;
+    while (i < cnt) {
+        int length = 0;
+        long dist = 0;
+
+        if (i + FLATE_MIN_MATCH <= cnt) {
+            long hash = flateHash(&src[i]);
+            long j = head[hash];
+            int chain = FLATE_MAX_CHAIN;
+            int max = (cnt - i < FLATE_MAX_MATCH) ? (int)(cnt - i) : FLATE_MAX_MATCH;
+
+            /* Find longest match in window */
+            while (j >= 0 && i - j <= FLATE_WINDOW && chain-- > 0) {
+                if (src[j + length] == src[i + length]) {
+                    int n = 0;
+                    while (n < max && src[j + n] == src[i + n])
+                        n++;
+                    if (n > length) {
+                        length = n;
+                        dist = i - j;
+                        if (n == max)
+                            break;
+                    }
+                }
+                if (prev[j & (FLATE_WINDOW - 1)] >= j)
+                    break; /* Entry was overwritten */
+                j = prev[j & (FLATE_WINDOW - 1)];
+            }
+
+            prev[i & (FLATE_WINDOW - 1)] = head[hash];
+            head[hash] = i;
+        }
+
+        if (length >= FLATE_MIN_MATCH) {
+            long end = i + length;
+            flatePutMatch(h, length, (int)dist);
+            for (i++; i < end; i++)
+                if (i + FLATE_MIN_MATCH <= cnt) {
+                    long hash = flateHash(&src[i]);
+                    prev[i & (FLATE_WINDOW - 1)] = head[hash];
+                    head[hash] = i;
+                }
+        } else
+            flatePutSymbol(h, src[i++]);
+    }
+
+    /* End of block; flush to byte boundary */
+    flatePutSymbol(h, 256);
+    if (h->flate.nBits > 0)
+        flatePutBits(h, 0, 8 - h->flate.nBits);
+
+    /* Adler-32 checksum */
+    for (i = 0; i < cnt; i++) {
+        a += src[i];
+        if (a >= 65521)
+            a -= 65521;
+        b += a;
+        if (b >= 65521)
+            b -= 65521;
+    }
+    flatePutBits(h, (b >> 8) & 0xff, 8);
+    flatePutBits(h, b & 0xff, 8);
+    flatePutBits(h, (a >> 8) & 0xff, 8);
+    flatePutBits(h, a & 0xff, 8);
+}
+
 /* ------------------------- Stream Object Support ------------------------- */
 
 /* Save formatted string to stream object. */
@@ -550,8 +773,9 @@ static void CTL_CDECL stmPrint(pdwCtx h, long iStm, char *fmt, ...) {
     memcpy(dnaEXTEND(h->stms[iStm], length), buf, length);
 }
 
-/* Write stream object stream to dst stream. */
-static long stmWrite(pdwCtx h, long iStm) {
+/* Write stream object stream to dst stream with additional stream dictionary
+   entries "dict". */
+static long stmWriteDict(pdwCtx h, long iStm, char *dict) {
     OBJ num;
     STM *stm = &h->stms[iStm];
 
@@ -559,21 +783,40 @@ static long stmWrite(pdwCtx h, long iStm) {
         return -1; /* Empty stream */
 
     num = newObj(h);
-    dstPrint(h,
-             "%ld 0 obj\n"
-             "<< /Length %ld >>\n"
-             "stream\n",
-             num, stm->cnt);
-    dstWrite(h, (size_t)stm->cnt, stm->array);
-    dstPrint(h,
-             "endstream\n"
-             "endobj\n");
+    if (h->flags & PDW_COMPRESS) {
+        flateEncode(h, stm->cnt, (unsigned char *)stm->array);
+        dstPrint(h,
+                 "%ld 0 obj\n"
+                 "<< %s/Length %ld /Filter /FlateDecode >>\n"
+                 "stream\n",
+                 num, dict, h->flate.out.cnt);
+        dstWrite(h, (size_t)h->flate.out.cnt, h->flate.out.array);
+        dstPrint(h,
+                 "\n"
+                 "endstream\n"
+                 "endobj\n");
+    } else {
+        dstPrint(h,
+                 "%ld 0 obj\n"
+                 "<< %s/Length %ld >>\n"
+                 "stream\n",
+                 num, dict, stm->cnt);
+        dstWrite(h, (size_t)stm->cnt, stm->array);
+        dstPrint(h,
+                 "endstream\n"
+                 "endobj\n");
+    }
 
     stm->cnt = 0; /* Reset stream */
 
     return num;
 }
 
+/* Write stream object stream to dst stream. */
+static long stmWrite(pdwCtx h, long iStm) {
+    return stmWriteDict(h, iStm, "");
+}
+
 /* ------------------------------ Text Support ----------------------------- */
 
 /* Begin text object. No leading set if leading parameter is 0. */
@@ -679,6 +922,8 @@ static int glyphBeg(abfGlyphCallbacks *cb, abfGlyphInfo *info) {
 
     h->glyph.rec = dnaNEXT(h->glyphs);
     h->glyph.rec->layer.index = h->layers.cnt;
+    h->path.left = h->path.bottom = 32767;
+    h->path.right = h->path.top = -32767;
 
     if (h->level > 0) {
         stmPrint(h, STM_TICS, "s\n");
@@ -708,7 +953,7 @@ static void glyphWidth(abfGlyphCallbacks *cb, float hAdv) {
         h->metrics.cb.width(&h->metrics.cb, hAdv);
 
     /* Write bearings object */
-    stmPrint(h, STM_MISC,
+    stmPrint(h, (h->flags & PDW_COMPRESS) ? STM_BEARINGS : STM_MISC,
              "%.2f 0 m\n"
              "0 0 l\n"
              "0 %.2f l\n"
@@ -721,7 +966,8 @@ static void glyphWidth(abfGlyphCallbacks *cb, float hAdv) {
              hAdv + IN_EM(0.03),
              hAdv,
              hAdv, IN_EM(-0.03));
-    h->glyph.rec->bearings = stmWrite(h, STM_MISC);
+    if (!(h->flags & PDW_COMPRESS))
+        h->glyph.rec->bearings = stmWrite(h, STM_MISC);
 }
 
 /* Make normalized vector. */
@@ -883,6 +1129,18 @@ static void endPath(pdwCtx h) {
     drawCoord(h, h->path.sx, h->path.sy);
 }
 
+/* Add point to path bounds. */
+static void addBounds(pdwCtx h, float x, float y) {
+    if (x < h->path.left)
+        h->path.left = x;
+    if (x > h->path.right)
+        h->path.right = x;
+    if (y < h->path.bottom)
+        h->path.bottom = y;
+    if (y > h->path.top)
+        h->path.top = y;
+}
+
 /* Draw glyph move. */
 static void glyphMove(abfGlyphCallbacks *cb, float x0, float y0) {
     pdwCtx h = cb->direct_ctx;
@@ -891,6 +1149,7 @@ static void glyphMove(abfGlyphCallbacks *cb, float x0, float y0) {
         endPath(h);
 
     stmPrint(h, STM_PATH, "%.2f %.2f m\n", x0, y0);
+    addBounds(h, x0, y0);
 
     h->path.cnt = 1;
     if (h->level > 0) {
@@ -922,6 +1181,7 @@ static void glyphLine(abfGlyphCallbacks *cb, float x1, float y1) {
     pdwCtx h = cb->direct_ctx;
 
     stmPrint(h, STM_PATH, "%.2f %.2f l\n", x1, y1);
+    addBounds(h, x1, y1);
     drawCoord(h, x1, y1);
 
     if (h->level > 0)
@@ -938,6 +1198,9 @@ static void glyphCurve(abfGlyphCallbacks *cb,
     pdwCtx h = cb->direct_ctx;
 
     stmPrint(h, STM_PATH, "%.2f %.2f %.2f %.2f %.2f %.2f c\n", x1, y1, x2, y2, x3, y3);
+    addBounds(h, x1, y1);
+    addBounds(h, x2, y2);
+    addBounds(h, x3, y3);
 
     drawCntlPt(h, x1, y1);
     drawCntlPt(h, x2, y2);
@@ -1121,8 +1384,8 @@ static void drawTile(pdwCtx h, int iStm,
     textEnd(h);
 }
 
-/* Write tile metrics value object. */
-static long writeTileMtxValueObj(pdwCtx h, abfGlyphInfo *info) {
+/* Draw tile metrics values to stream. */
+static void drawTileMtxValue(pdwCtx h, int iStm, abfGlyphInfo *info) {
     char tag[20];
     char enc[50];
     char hAdv[20];
@@ -1142,8 +1405,8 @@ static long writeTileMtxValueObj(pdwCtx h, abfGlyphInfo *info) {
     }
     sprintf(hAdv, "%.2f", h->glyph.hAdv);
 
-    drawTile(h, STM_MISC, x, y, tag, hAdv, gname);
-    stmPrint(h, STM_MISC,
+    drawTile(h, iStm, x, y, tag, hAdv, gname);
+    stmPrint(h, iStm,
              "q\n"
              "%.2f 0 0 %.2f %.2f %.2f cm\n",
              scale, scale,
@@ -1151,6 +1414,11 @@ static long writeTileMtxValueObj(pdwCtx h, abfGlyphInfo *info) {
                                          h->glyph.hAdv / h->top->sup.UnitsPerEm) /
                             2),
              RND(1, y - TILE_SIZE * 0.7));
+}
+
+/* Write tile metrics value object. */
+static long writeTileMtxValueObj(pdwCtx h, abfGlyphInfo *info) {
+    drawTileMtxValue(h, STM_MISC, info);
     return stmWrite(h, STM_MISC);
 }
 
@@ -1216,6 +1484,11 @@ static void glyphEnd(abfGlyphCallbacks *cb) {
     if (h->level > 0)
         textEnd(h); /* End coord text */
 
+    if (h->flags & PDW_COMPRESS) {
+        writeGlyphObjs(h, cb->info);
+        return;
+    }
+
     saveLayer(h);
 
     /* Save glyph objects */
@@ -1401,7 +1674,10 @@ static long writeMtxKeyObj(pdwCtx h) {
 
 /* Write beginning PDF file. */
 static void writePDFBeg(pdwCtx h) {
-    dstPrint(h, "%%PDF-1.1\n");
+    if (h->flags & PDW_COMPRESS)
+        dstPrint(h, "%%PDF-1.2\n%%\xe2\xe3\xcf\xd3\n");
+    else
+        dstPrint(h, "%%PDF-1.1\n");
 
     h->obj.init_page = writeInitPageObj(h);
     h->obj.info = writeInfoObj(h);
@@ -1412,6 +1688,17 @@ static void writePDFBeg(pdwCtx h) {
         h->obj.coord_font = writeFontObj(h, FONT_COORD);
         h->obj.page_mtx_key = writeMtxKeyObj(h);
     }
+
+    if (h->flags & PDW_COMPRESS) {
+        /* Pages are written as they are completed so allocate page tree root
+           object number and write the glyph page objects now */
+        h->obj.pages = h->xref.cnt;
+        *dnaNEXT(h->xref) = 0;
+        if (h->level > 0) {
+            h->obj.zone = writeZoneObj(h, 0);
+            h->obj.transform = writeTransformObj(h);
+        }
+    }
 }
 
 /* Write end of PDF file (xref + trailer). */
@@ -1736,6 +2023,15 @@ static OBJ writeZoneObj(pdwCtx h, long iFD) {
     return stmWrite(h, STM_MISC);
 }
 
+/* Write path transformation object. */
+static OBJ writeTransformObj(pdwCtx h) {
+    stmPrint(h, STM_MISC,
+             "%g 0 0 %g %g %g cm\n",
+             h->glyph.scale, h->glyph.scale,
+             EM_ORIG_H, EM_ORIG_V);
+    return stmWrite(h, STM_MISC);
+}
+
 /* Write glyph pages. */
 static void writeGlyphPages(pdwCtx h, OBJ parent) {
     OBJ zone;
@@ -1746,13 +2042,7 @@ static void writeGlyphPages(pdwCtx h, OBJ parent) {
         return;
 
     zone = writeZoneObj(h, 0);
-
-    /* Write path transformation object */
-    stmPrint(h, STM_MISC,
-             "%g 0 0 %g %g %g cm\n",
-             h->glyph.scale, h->glyph.scale,
-             EM_ORIG_H, EM_ORIG_V);
-    transform_obj = stmWrite(h, STM_MISC);
+    transform_obj = writeTransformObj(h);
 
     for (i = 0; i < h->glyphs.cnt; i++) {
         Glyph *glyph = &h->glyphs.array[i];
@@ -1793,18 +2083,162 @@ static void writeGlyphPages(pdwCtx h, OBJ parent) {
     }
 }
 
+/* ----------------------- Streamed Pages (PDW_COMPRESS) ------------------- */
+
+/* Append stream "iSrc" to stream "iDst". */
+static void stmAppend(pdwCtx h, int iDst, int iSrc) {
+    STM *src = &h->stms[iSrc];
+    memcpy(dnaEXTEND(h->stms[iDst], src->cnt), src->array, src->cnt);
+}
+
+/* Write palette page for the glyphs seen since the last one. */
+static void writePalettePage(pdwCtx h) {
+    OBJ content;
+    OBJ page;
+    long i;
+
+    if (h->level > 0)
+        writeTileAnnots(h, 0, h->glyphs.cnt);
+
+    content = stmWrite(h, STM_PAGE);
+
+    /* Page resources replace the inherited ones and so include the fonts */
+    page = dstBegObj(h);
+    dstPrint(h,
+             "/Type /Page\n"
+             "/Parent %ld 0 R\n"
+             "/Resources <<\n"
+             "/ProcSet [/PDF /Text]\n"
+             "/Font <<\n"
+             "/F0 %ld 0 R\n",
+             h->obj.pages,
+             h->obj.text_font);
+    if (h->level > 0)
+        dstPrint(h, "/F1 %ld 0 R\n", h->obj.coord_font);
+    dstPrint(h,
+             ">>\n"
+             "/XObject <<\n");
+    for (i = 0; i < h->glyphs.cnt; i++)
+        if (h->glyphs.array[i].form != -1)
+            dstPrint(h, "/G%ld %ld 0 R\n", i, h->glyphs.array[i].form);
+    dstPrint(h,
+             ">>\n"
+             ">>\n"
+             "/Contents [\n");
+    writeObjRef(h, h->obj.init_page);
+    writeObjRef(h, h->obj.header);
+    writeObjRef(h, h->obj.tile_mtx_key);
+    if (content != -1)
+        writeObjRef(h, content);
+    dstPrint(h, "]\n");
+
+    if (h->level > 0) {
+        dstPrint(h, "/Annots [\n");
+        for (i = 0; i < h->glyphs.cnt; i++)
+            writeObjRef(h, h->glyphs.array[i].tile.annot);
+        dstPrint(h, "]\n");
+    }
+
+    dstEndObj(h);
+
+    *dnaNEXT(h->pages) = page;
+
+    /* Start next page */
+    h->glyphs.cnt = 0;
+    h->layers.cnt = 0;
+}
+
+/* Write glyph page object. */
+static OBJ writeGlyphPage(pdwCtx h, Glyph *glyph, OBJ body) {
+    OBJ num = dstBegObj(h);
+    dstPrint(h,
+             "/Type /Page\n"
+             "/Parent %ld 0 R\n"
+             "/Contents [\n",
+             h->obj.pages);
+    writeObjRef(h, h->obj.init_page);
+    writeObjRef(h, h->obj.header);
+    writeObjRef(h, h->obj.page_mtx_key);
+    writeObjRef(h, glyph->page.mtx_value);
+    writeObjRef(h, h->obj.transform);
+    if (h->obj.zone != -1)
+        writeObjRef(h, h->obj.zone);
+    writeObjRef(h, body);
+    dstPrint(h, "]\n");
+    dstEndObj(h);
+    return num;
+}
+
+/* Write the objects of the glyph just drawn: its outline Form XObject, its
+   glyph page, and its palette tile, which is saved for its palette page.
+   Only the palette tiles draw the form. A glyph page strokes the outline
+   with its tics, and a form can't leave a path open for its caller to
+   paint, so the glyph page keeps its own copy of the outline. */
+static void writeGlyphObjs(pdwCtx h, abfGlyphInfo *info) {
+    Glyph *glyph = h->glyph.rec;
+    int marking = h->stms[STM_PATH].cnt > 0;
+
+    /* Hint and flex layers aren't drawn */
+    h->stms[STM_HINT].cnt = 0;
+    h->stms[STM_FLEX].cnt = 0;
+
+    if (h->level > 0) {
+        /* Write glyph page; outline and labels are drawn in glyph space */
+        h->metrics.cb.end(&h->metrics.cb);
+        glyph->page.mtx_value = writePageMtxValueObj(h, info);
+        stmAppend(h, STM_MISC, STM_BEARINGS);
+        if (marking) {
+            stmAppend(h, STM_MISC, STM_PATH);
+            stmAppend(h, STM_MISC, STM_TICS);
+            stmAppend(h, STM_MISC, STM_COORDS);
+        }
+        glyph->page.obj = writeGlyphPage(h, glyph, stmWrite(h, STM_MISC));
+        *dnaNEXT(h->glyphpages) = glyph->page.obj;
+    }
+    h->stms[STM_TICS].cnt = 0;
+    h->stms[STM_COORDS].cnt = 0;
+
+    /* Write outline form */
+    glyph->form = -1;
+    if (marking) {
+        char dict[100];
+        sprintf(dict, "/Type /XObject /Subtype /Form /BBox [%.2f %.2f %.2f %.2f] ",
+                h->path.left, h->path.bottom, h->path.right, h->path.top);
+        stmPrint(h, STM_PATH, "f\n");
+        glyph->form = stmWriteDict(h, STM_PATH, dict);
+    }
+
+    /* Add tile to palette page */
+    drawTileMtxValue(h, STM_PAGE, info);
+    stmAppend(h, STM_PAGE, STM_BEARINGS);
+    h->stms[STM_BEARINGS].cnt = 0;
+    if (glyph->form != -1)
+        stmPrint(h, STM_PAGE, "/G%ld Do\n", h->glyphs.cnt - 1);
+    stmPrint(h, STM_PAGE, "Q\n");
+
+    if (h->glyphs.cnt == TILES_PER_PAGE)
+        writePalettePage(h);
+}
+
 /* Write page objects. */
 static void writePages(pdwCtx h) {
     long i;
     long pagecnt;
     OBJ pages;
 
-    /* Get pages object number and allocate dummy xref */
-    pages = h->xref.cnt;
-    *dnaNEXT(h->xref) = 0;
+    if (h->flags & PDW_COMPRESS) {
+        /* Write last palette page */
+        if (h->glyphs.cnt > 0 || h->pages.cnt == 0)
+            writePalettePage(h);
+        pages = h->obj.pages;
+    } else {
+        /* Get pages object number and allocate dummy xref */
+        pages = h->xref.cnt;
+        *dnaNEXT(h->xref) = 0;
 
-    writeGlyphPages(h, pages);
-    writePalettePages(h, pages);
+        writeGlyphPages(h, pages);
+        writePalettePages(h, pages);
+    }
 
     /* Replace dummy xref by file offset */
     h->xref.array[pages] = dstTell(h) - h->dst.start;
@@ -1825,7 +2259,7 @@ static void writePages(pdwCtx h) {
     pagecnt = h->pages.cnt;
     if (h->level > 0) {
         dstPrint(h, "/F1 %ld 0 R\n", h->obj.coord_font);
-        pagecnt += h->glyphs.cnt;
+        pagecnt += (h->flags & PDW_COMPRESS) ? h->glyphpages.cnt : h->glyphs.cnt;
     }
 
     dstPrint(h,
@@ -1836,9 +2270,14 @@ static void writePages(pdwCtx h) {
              pagecnt);
     for (i = 0; i < h->pages.cnt; i++)
         writeObjRef(h, h->pages.array[i]);
-    if (h->level > 0)
-        for (i = 0; i < h->glyphs.cnt; i++)
-            writeObjRef(h, h->glyphs.array[i].page.obj);
+    if (h->level > 0) {
+        if (h->flags & PDW_COMPRESS)
+            for (i = 0; i < h->glyphpages.cnt; i++)
+                writeObjRef(h, h->glyphpages.array[i]);
+        else
+            for (i = 0; i < h->glyphs.cnt; i++)
+                writeObjRef(h, h->glyphs.array[i].page.obj);
+    }
     dstPrint(h, "]\n");
     dstEndObj(h);
 
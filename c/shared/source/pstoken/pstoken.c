@@ -176,9 +176,14 @@ int pstFree(pstCtx h) {
 
 /* ------------------------ Source Data Management ------------------------- */
 
-/* Decrypt ASCII source buffer to plain buffer. Return 1 on error else 0. */
+/* Decrypt ASCII source buffer to plain buffer. Return 1 on error else 0.
+   Runs of hex digit pairs, which make up nearly all of a line, are decrypted
+   two digits at a time; whitespace and odd nibbles take the slow path. The
+   decryption state is kept in a local so the byte stores can't force it to
+   be reloaded. */
 static int ascii_decrypt(pstCtx h, size_t length, char *buf) {
     int hi_nib = h->cipher.hi_nib;
+    unsigned short r = h->cipher.r;
     char *end = buf + length;
     char *src = buf;
     char *dst;
@@ -192,22 +197,41 @@ static int ascii_decrypt(pstCtx h, size_t length, char *buf) {
 
     /* Decrypt and copy buffer */
     dst = h->plain.array;
-    do {
-        int nib = digit[(uint8_t)(*src++)];
+    while (src < end) {
+        int nib;
+        if (hi_nib == -1) {
+            /* Fast path: consecutive digit pairs */
+            while (end - src >= 2) {
+                int hi = digit[(uint8_t)src[0]];
+                int lo = digit[(uint8_t)src[1]];
+                unsigned char cipher;
+                if ((hi | lo) > 15)
+                    break;
+                cipher = hi << 4 | lo;
+                *dst++ = cipher ^ (r >> 8);
+                r = (cipher + r) * 52845 + 22719;
+                src += 2;
+            }
+            if (src == end)
+                break;
+        }
+
+        nib = digit[(uint8_t)(*src++)];
         if (nib > 15)
             continue;
         else if (hi_nib == -1)
             hi_nib = nib;
         else {
             unsigned char cipher = hi_nib << 4 | nib;
-            *dst++ = cipher ^ (h->cipher.r >> 8);
-            h->cipher.r = (cipher + h->cipher.r) * 52845 + 22719;
+            *dst++ = cipher ^ (r >> 8);
+            r = (cipher + r) * 52845 + 22719;
             hi_nib = -1;
         }
-    } while (src < end);
+    }
 
     /* Save possible odd nibble that's split across buffers */
     h->cipher.hi_nib = hi_nib;
+    h->cipher.r = r;
 
     /* 64-bit warning fixed by cast here */
     h->plain.cnt = (long)(dst - h->plain.array);
@@ -217,7 +241,8 @@ static int ascii_decrypt(pstCtx h, size_t length, char *buf) {
 /* Decrypt binary source buffer to plain buffer. Return 1 on error else 0. */
 static int binary_decrypt(pstCtx h, size_t length, char *buf) {
     size_t i;
-    char *src = buf;
+    unsigned short r = h->cipher.r;
+    unsigned char *src = (unsigned char *)buf;
     char *dst;
 
     /* Set plain text buffer size */
@@ -231,9 +256,10 @@ static int binary_decrypt(pstCtx h, size_t length, char *buf) {
     dst = h->plain.array;
     for (i = 0; i < length; i++) {
         unsigned char cipher = *src++;
-        *dst++ = cipher ^ (h->cipher.r >> 8);
-        h->cipher.r = (cipher + h->cipher.r) * 52845 + 22719;
+        *dst++ = cipher ^ (r >> 8);
+        r = (cipher + r) * 52845 + 22719;
     }
+    h->cipher.r = r;
 
     return 0;
 }
@@ -446,30 +472,41 @@ int pstEndParse(pstCtx h) {
 
 /* --------------------------- PostScript Parser --------------------------- */
 
-/* Skip to delimiter and push it. Return 1 on error else 0. */
-static int skip2Delim(pstCtx h) {
+/* Skip characters until one in lexical class "stop" is next, scanning the
+   source buffer directly and only refilling at its end. Return 1 on error
+   else 0. */
+static int skipUntil(pstCtx h, int stop) {
     for (;;) {
-        int c = read1(h);
+        char *p = h->src.next;
+        char *end = p + h->src.left;
+        int c;
+
+        while (p < end && !(class[(uint8_t)*p] & stop))
+            p++;
+        h->src.left -= (size_t)(p - h->src.next);
+        h->src.next = p;
+        if (p < end)
+            return 0;
+
+        /* Buffer exhausted; refill and test first char */
+        c = read1(h);
         if (c == -1)
             return 1;
-        else if (IS_DELIMETER(c))
-            break;
+        else if (class[(uint8_t)c] & stop) {
+            unread1(h);
+            return 0;
+        }
     }
-    unread1(h);
-    return 0;
+}
+
+/* Skip to delimiter and push it. Return 1 on error else 0. */
+static int skip2Delim(pstCtx h) {
+    return skipUntil(h, S_ | W_);
 }
 
 /* Skip comment line and push newline. Return 1 on error else 0.*/
 static int skipComment(pstCtx h) {
-    for (;;) {
-        int c = read1(h);
-        if (c == -1)
-            return 1;
-        else if (IS_NEWLINE(c))
-            break;
-    }
-    unread1(h);
-    return 0;
+    return skipUntil(h, N_);
 }
 
 /* Skip over string token. Return 1 on error else 0. */
@@ -857,15 +894,13 @@ int pstGetToken(pstCtx h, pstToken *token) {
                     return h->errcode;
             }
 
-            /* skip2Delim() won't do here because might have null name object */
-            for (;;)
-                if (c == -1)
-                    return h->errcode;
-                else if (IS_DELIMETER(c))
-                    break;
-                else
-                    c = read1(h);
-            unread1(h);
+            /* Check first char here because might have null name object */
+            if (c == -1)
+                return h->errcode;
+            else if (IS_DELIMETER(c))
+                unread1(h);
+            else if (skip2Delim(h))
+                return h->errcode;
             break;
         case '{':
             if (skipProcedure(h))
@@ -469,7 +469,6 @@ int sfwWriteTables(sfwCtx h, void *stm, ctlTag sfnt_tag) {
     long i;
     long origin;
     long offset;
-    long dirSize = HDR_SIZE + ENTRY_SIZE * h->hdr.numTables;
     char *filler = "\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0";
 
     if (h->state != 3)
@@ -500,22 +499,23 @@ int sfwWriteTables(sfwCtx h, void *stm, ctlTag sfnt_tag) {
     if (writeTables(h, origin))
         return sfwErrAbort;
 
-    /* Read tables and compute table checksums */
+    /* Read back tables whose writers didn't supply a checksum and compute
+       their checksums */
     do_seek = 1;
     offset = 0;
     entry = h->hdr.directory.array;
     for (i = 0; i < h->tables.cnt; i++) {
         Table *table = &h->tables.array[i];
         if (!(table->flags & DONT_WRITE)) {
+            if (entry->tag == CTL_TAG('h', 'e', 'a', 'd'))
+                offset = entry->offset + HEAD_ADJUST_OFFSET;
+
             if (table->flags & USE_CHECKSUM)
                 do_seek = 1;
             else {
                 long j;
                 int nLongs = (entry->length + 3) / 4;
 
-                if (entry->tag == CTL_TAG('h', 'e', 'a', 'd'))
-                    offset = entry->offset + HEAD_ADJUST_OFFSET;
-
                 if (do_seek) {
                     /* Seek to table offset */
                     dstSeek(h, origin + entry->offset);
@@ -538,20 +538,20 @@ int sfwWriteTables(sfwCtx h, void *stm, ctlTag sfnt_tag) {
     writeHdr(h);
 
     if (offset != 0) {
-        /* head table present; read header and compute header checksum */
-        dstSeek(h, origin);
-        h->dst.left = 0;
-        sum = 0;
-        for (i = 0; i < dirSize; i += 4)
-            sum += read4(h);
-
-        /* Add in table checksums */
-        for (i = 0; i < h->hdr.numTables; i++)
-            sum += h->hdr.directory.array[i].checksum;
+        /* head table present; compute font checksum from the header fields
+           and table checksums already in hand */
+        sum = h->hdr.version;
+        sum += (unsigned long)h->hdr.numTables << 16 | h->hdr.searchRange;
+        sum += (unsigned long)h->hdr.entrySelector << 16 | h->hdr.rangeShift;
+        for (i = 0; i < h->hdr.numTables; i++) {
+            entry = &h->hdr.directory.array[i];
+            sum += entry->tag + entry->checksum * 2 + entry->offset +
+                   entry->length;
+        }
 
         /* Write head table checksum adjustment */
         dstSeek(h, origin + offset);
-        write4(h, 0xb1b0afba - sum);
+        write4(h, (0xb1b0afba - sum) & 0xffffffff);
     }
 
     if (stm == NULL) {
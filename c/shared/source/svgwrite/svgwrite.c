@@ -33,6 +33,7 @@ struct svwCtx_ {
     {
         long flags; /* See svgwrite.h for flags */
         char *newline;
+        int precision; /* Decimal places */
     } arg;
     struct /* Destination stream */
     {
@@ -49,6 +50,18 @@ struct svwCtx_ {
         float x;
         float y;
         int state;
+        struct /* SVW_COMPACT path data; coordinates in 10^-precision units */
+        {
+            long x;   /* Current point */
+            long y;
+            long x0;  /* Subpath start point */
+            long y0;
+            long x2;  /* Last curve's second control point */
+            long y2;
+            char cmd; /* Last command letter */
+            int nums; /* Numbers written since command letter */
+            int dot;  /* Last number had a decimal point */
+        } q;
     } path;
     struct /* Streams */
     {
@@ -147,50 +160,10 @@ static void writeBuf(svwCtx h, size_t writeCnt, const char *ptr) {
 
 /* Write integer value as ASCII to dst stream. */
 static void writeInt(svwCtx h, long value) {
-    char buf[50];
-    sprintf(buf, "%ld", value);
-    writeBuf(h, strlen(buf), buf);
+    char buf[24];
+    writeBuf(h, ctuLtostr(buf, value), buf);
 }
 
-/* Convert a long into a string */
-static void svw_ltoa(char *buf, long val) {
-    static char ascii_digit[] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9'};
-    char *position = buf;
-    char *start = buf;
-    int digit;
-    char tmp;
-
-    int isneg = val < 0;
-    if (isneg)
-        val = -val;
-
-    /* extract char's */
-    do {
-        digit = val % 10;
-        val /= 10;
-        *position = ascii_digit[digit];
-        position++;
-    } while (val);
-
-    /* store sign */
-    if (isneg) {
-        *position = '-';
-        position++;
-    }
-
-    /* terminate */
-    *position = '\0';
-    position--;
-
-    /* reverse string */
-    while (start < position) {
-        tmp = *position;
-        *position = *start;
-        *start = tmp;
-        position--;
-        start++;
-    }
-}
 /* Write real number in ASCII to dst stream. */
 #define TX_EPSILON 0.0003
 /*In Xcode, FLT_EPSILON is 1.192..x10-7, but the diff between value-roundf(value) can be 3.05..x10-5, when the input value is from a 24.8 fixed. */
@@ -198,10 +171,61 @@ static void writeReal(svwCtx h, float value) {
     char buf[50];
     /* if no decimal component, perform a faster to string conversion */
     if ((fabs(value - roundf(value)) < TX_EPSILON) && (value > LONG_MIN) && (value < LONG_MAX))
-        svw_ltoa(buf, (long)roundf(value));
+        writeBuf(h, ctuLtostr(buf, (long)roundf(value)), buf);
     else
-        ctuDtostr(buf, sizeof(buf), value, 0, 2);
-    writeBuf(h, strlen(buf), buf);
+        writeBuf(h, ctuFtostr(buf, sizeof(buf), value, h->arg.precision, 1), buf);
+}
+
+/* Powers of 10 indexed by precision */
+static const long scale[] = {1, 10, 100, 1000, 10000};
+
+/* Round coordinate to the precision grid. */
+static long quantize(svwCtx h, float value) {
+    return (long)floor(value * (double)scale[h->arg.precision] + 0.5);
+}
+
+/* Write command letter of compact path data unless it repeats the last. */
+static void writeCompactCmd(svwCtx h, char cmd) {
+    if (cmd == h->path.q.cmd)
+        return;
+    writeBuf(h, 1, &cmd);
+    h->path.q.cmd = cmd;
+    h->path.q.nums = 0;
+}
+
+/* Write compact path data number from its value in precision grid units.
+   A space separator is only written when the number doesn't begin with a
+   sign, or with a decimal point following a number that already had one. */
+static void writeCompactNum(svwCtx h, long value) {
+    int precision = h->arg.precision;
+    unsigned long mag = (value < 0) ? 0UL - (unsigned long)value : (unsigned long)value;
+    unsigned long ipart = mag / scale[precision];
+    unsigned long fpart = mag % scale[precision];
+    char buf[32];
+    char *p = buf;
+    int dot = 0;
+
+    if (value < 0)
+        *p++ = '-';
+    if (ipart != 0 || fpart == 0)
+        p += ctuLtostr(p, (long)ipart);
+    if (fpart != 0) {
+        int i;
+        *p++ = '.';
+        for (i = precision - 1; i >= 0; i--) {
+            p[i] = (char)('0' + fpart % 10);
+            fpart /= 10;
+        }
+        p += precision;
+        while (p[-1] == '0')
+            p--;
+        dot = 1;
+    }
+
+    if (h->path.q.nums++ != 0 && buf[0] != '-' && !(buf[0] == '.' && h->path.q.dot))
+        writeBuf(h, 1, " ");
+    writeBuf(h, p - buf, buf);
+    h->path.q.dot = dot;
 }
 
 /* Write null-terminated string to dst steam. */
@@ -290,6 +314,7 @@ svwCtx svwNew(ctlMemoryCallbacks *mem_cb, ctlStreamCallbacks *stm_cb,
     h->state = 0;
     h->top = NULL;
     h->glyphs.size = 0;
+    h->arg.precision = 2;
     h->dna = NULL;
     h->stm.dst = NULL;
     h->stm.dbg = NULL;
@@ -335,6 +360,14 @@ void svwFree(svwCtx h) {
     return;
 }
 
+/* Set coordinate precision. */
+int svwSetPrecision(svwCtx h, int precision) {
+    if (precision < 0 || precision >= (int)ARRAY_LEN(scale))
+        return svwErrBadCall;
+    h->arg.precision = precision;
+    return svwSuccess;
+}
+
 /* Begin font. */
 int svwBegFont(svwCtx h, long flags) {
     /* Validate glyphnames */
@@ -363,6 +396,8 @@ int svwBegFont(svwCtx h, long flags) {
 
     /* Initialize */
     h->arg.flags = flags;
+    if (flags & SVW_COMPACT)
+        h->arg.flags &= ~SVW_ABSOLUTE; /* Compact path data is relative */
     h->tmp.cnt = 0;
     h->dst.cnt = 0;
     h->glyphs.cnt = 0;
@@ -571,6 +606,9 @@ static int glyphBeg(abfGlyphCallbacks *cb, abfGlyphInfo *info) {
     h->path.x = 0;
     h->path.y = 0;
     h->path.state = 1;
+    h->path.q.x = 0;
+    h->path.q.y = 0;
+    h->path.q.cmd = 0;
 
     if (info->encoding.code == 0xFFFF) /* Signifies .notdef glyph */
         writeStr(h, "<missing-glyph");
@@ -655,6 +693,26 @@ static void glyphMove(abfGlyphCallbacks *cb, float x0, float y0) {
         return;
     }
 
+    if (h->arg.flags & SVW_COMPACT) {
+        long x = quantize(h, x0);
+        long y = quantize(h, y0);
+        if (h->path.state < 3)
+            writeStr(h, " d=\"");
+        else {
+            /* Close path; current point returns to the subpath start */
+            writeCompactCmd(h, 'z');
+            h->path.q.x = h->path.q.x0;
+            h->path.q.y = h->path.q.y0;
+        }
+        writeCompactCmd(h, 'm');
+        writeCompactNum(h, x - h->path.q.x);
+        writeCompactNum(h, y - h->path.q.y);
+        h->path.q.x = h->path.q.x0 = x;
+        h->path.q.y = h->path.q.y0 = y;
+        h->path.state = 3;
+        return;
+    }
+
     if (h->path.state < 3)
         /* First moveto for this glyph implies start of path data. */
         writeStr(h, " d=\"");
@@ -696,6 +754,26 @@ static void glyphLine(abfGlyphCallbacks *cb, float x1, float y1) {
         h->err.code = svwErrBadCall;
         return;
     }
+    if (h->arg.flags & SVW_COMPACT) {
+        long dx = quantize(h, x1) - h->path.q.x;
+        long dy = quantize(h, y1) - h->path.q.y;
+        if (dx == 0 && dy == 0)
+            return; /* Zero-length line */
+        else if (dy == 0) {
+            writeCompactCmd(h, 'h');
+            writeCompactNum(h, dx);
+        } else if (dx == 0) {
+            writeCompactCmd(h, 'v');
+            writeCompactNum(h, dy);
+        } else {
+            writeCompactCmd(h, 'l');
+            writeCompactNum(h, dx);
+            writeCompactNum(h, dy);
+        }
+        h->path.q.x += dx;
+        h->path.q.y += dy;
+        return;
+    }
     if (h->arg.flags & SVW_ABSOLUTE) {
         writeStr(h, " L ");
         writeReal(h, x1);
@@ -726,6 +804,34 @@ static void glyphCurve(abfGlyphCallbacks *cb,
         return;
     }
 
+    if (h->arg.flags & SVW_COMPACT) {
+        long qx1 = quantize(h, x1);
+        long qy1 = quantize(h, y1);
+        long qx2 = quantize(h, x2);
+        long qy2 = quantize(h, y2);
+        long qx3 = quantize(h, x3);
+        long qy3 = quantize(h, y3);
+        if ((h->path.q.cmd == 'c' || h->path.q.cmd == 's') &&
+            qx1 == 2 * h->path.q.x - h->path.q.x2 &&
+            qy1 == 2 * h->path.q.y - h->path.q.y2) {
+            /* First control point reflects the last curve's second */
+            writeCompactCmd(h, 's');
+        } else {
+            writeCompactCmd(h, 'c');
+            writeCompactNum(h, qx1 - h->path.q.x);
+            writeCompactNum(h, qy1 - h->path.q.y);
+        }
+        writeCompactNum(h, qx2 - h->path.q.x);
+        writeCompactNum(h, qy2 - h->path.q.y);
+        writeCompactNum(h, qx3 - h->path.q.x);
+        writeCompactNum(h, qy3 - h->path.q.y);
+        h->path.q.x2 = qx2;
+        h->path.q.y2 = qy2;
+        h->path.q.x = qx3;
+        h->path.q.y = qy3;
+        return;
+    }
+
     if (h->arg.flags & SVW_ABSOLUTE)
         writeStr(h, " C ");
     else
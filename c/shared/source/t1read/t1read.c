@@ -118,7 +118,7 @@ struct t1rCtx_ {
     struct /* Chars */
     {
         dnaDCL(Char, index);  /* In parse order */
-        dnaDCL(long, byName); /* In glyph name order */
+        dnaDCL(long, byName); /* Glyph name hash; [slot]->index or -1 */
     } chars;
     struct /* String pool */
     {
@@ -367,34 +367,59 @@ static void freeChars(t1rCtx h) {
     dnaFREE(h->chars.byName);
 }
 
-/* Match glyph name. */
-static int CTL_CDECL matchChar(const void *key, const void *value, void *ctx) {
+/* Return glyph name of char. Once the names are set the client owns
+   gname.impl, e.g. cffwrite stores its string index there. */
+static char *charName(t1rCtx h, Char *chr) {
+    return (chr->gname.ptr != ABF_UNSET_PTR) ? chr->gname.ptr : getString(h, (STI)chr->gname.impl);
+}
+
+/* Match glyph name to char. */
+static int CTL_CDECL matchChar(const void *key, long index, void *ctx) {
     t1rCtx h = ctx;
-    return strcmp((char *)key, getString(h, (STI)h->chars.index.array
-                                                [*(long *)value]
-                                                    .gname.impl));
+    return strcmp((char *)key, charName(h, &h->chars.index.array[index])) == 0;
+}
+
+/* Find hash table slot of glyph name, or the empty slot where it should be
+   added. */
+static long findCharSlot(t1rCtx h, char *gname, int *found) {
+    return ctuHashFind(gname, ctuHashString(gname), h->chars.byName.array,
+                       h->chars.byName.cnt, matchChar, found, h);
+}
+
+/* Resize glyph name hash table to "size" slots and re-add chars. */
+static void resizeChars(t1rCtx h, long size) {
+    long i;
+
+    dnaSET_CNT(h->chars.byName, size);
+    for (i = 0; i < size; i++)
+        h->chars.byName.array[i] = -1;
+    for (i = 0; i < h->chars.index.cnt; i++) {
+        int found;
+        char *gname = charName(h, &h->chars.index.array[i]);
+        h->chars.byName.array[findCharSlot(h, gname, &found)] = i;
+    }
 }
 
 /* Add char record. Return 1 if record exists else 0. Char record returned by
    "chr" parameter. */
 static int addChar(t1rCtx h, STI sti, Char **chr) {
-    size_t index;
-    int found =
-        ctuLookup(getString(h, sti),
-                  h->chars.byName.array, h->chars.byName.cnt,
-                  sizeof(h->chars.byName.array[0]), matchChar, &index, h);
+    int found;
+    long slot;
+    long size;
+
+    /* Keep table at most half full; grow before the new char is added
+       because its name isn't set until it's returned */
+    size = ctuHashSize(h->chars.byName.cnt, h->chars.index.cnt + 1);
+    if (size != h->chars.byName.cnt)
+        resizeChars(h, size);
 
+    slot = findCharSlot(h, getString(h, sti), &found);
     if (found)
         /* Match found; return existing record */
-        *chr = &h->chars.index.array[h->chars.byName.array[index]];
+        *chr = &h->chars.index.array[h->chars.byName.array[slot]];
     else {
         /* Not found; add to table and return new record */
-        long *new = &dnaGROW(h->chars.byName, h->chars.byName.cnt)[index];
-
-        /* Make and fill hole */
-        memmove(new + 1, new, (h->chars.byName.cnt++ - index) * sizeof(h->chars.byName.array[0]));
-        *new = h->chars.index.cnt;
-
+        h->chars.byName.array[slot] = h->chars.index.cnt;
         *chr = dnaNEXT(h->chars.index);
     }
 
@@ -403,13 +428,12 @@ static int addChar(t1rCtx h, STI sti, Char **chr) {
 
 /* Find char by name. NULL if not found else char record. */
 static Char *findChar(t1rCtx h, STI sti) {
-    size_t index;
-    if (ctuLookup(getString(h, sti),
-                  h->chars.byName.array, h->chars.byName.cnt,
-                  sizeof(h->chars.byName.array[0]), matchChar, &index, h))
-        return &h->chars.index.array[h->chars.byName.array[index]];
-    else
+    int found;
+    long slot;
+    if (h->chars.byName.cnt == 0)
         return NULL;
+    slot = findCharSlot(h, getString(h, sti), &found);
+    return found ? &h->chars.index.array[h->chars.byName.array[slot]] : NULL;
 }
 
 /* ---------------------------- Encoding Support --------------------------- */
@@ -3269,29 +3293,22 @@ int t1rGetGlyphByTag(t1rCtx h,
     return t1rSuccess;
 }
 
-/* Match glyph name after font fully parsed. */
-static int CTL_CDECL postMatchChar(const void *key, const void *value,
-                                   void *ctx) {
-    t1rCtx h = ctx;
-    return strcmp((char *)key,
-                  h->chars.index.array[*(long *)value].gname.ptr);
-}
-
 /* Get glyph from font by its name. */
 int t1rGetGlyphByName(t1rCtx h, char *gname, abfGlyphCallbacks *glyph_cb) {
-    size_t index;
+    int found;
+    long slot;
 
-    if (h->flags & CID_FONT)
+    if ((h->flags & CID_FONT) || h->chars.byName.cnt == 0)
         return t1rErrNoGlyph;
 
-    if (!ctuLookup(gname, h->chars.byName.array, h->chars.byName.cnt,
-                   sizeof(h->chars.byName.array[0]), postMatchChar, &index, h))
+    slot = findCharSlot(h, gname, &found);
+    if (!found)
         return t1rErrNoGlyph;
 
     /* Set error handler */
     DURING_EX(h->err.env)
 
-    readGlyph(h, (unsigned short)h->chars.byName.array[index], glyph_cb);
+    readGlyph(h, (unsigned short)h->chars.byName.array[slot], glyph_cb);
 
     HANDLER
     return Exception.Code;
@@ -279,11 +279,9 @@ static void writeInt(t1wCtx h, size_t N, long value) {
 static void writeReal(t1wCtx h, float value) {
     char buf[50];
     if (roundf(value) == value)
-        sprintf(buf, "%ld", (long)roundf(value));
-    else {
-        ctuDtostr(buf, sizeof(buf), value, 0, 8); /* 8 places is as good as it gets when converting ASCII real numbers->float-> ASCII real numbers, as happens to all the  PrivateDict values.*/
-    }
-    writeBuf(h, strlen(buf), buf);
+        writeBuf(h, ctuLtostr(buf, (long)roundf(value)), buf);
+    else
+        writeBuf(h, ctuFtostr(buf, sizeof(buf), value, 8, 1), buf); /* 8 places is as good as it gets when converting ASCII real numbers->float-> ASCII real numbers, as happens to all the  PrivateDict values.*/
 }
 
 /* Write null-terminated string to dst steam. */
@@ -1,11 +1,14 @@
-"[-cef options: default none]\n"
+"[-cef options: defaults -K]\n"
 "-F <FontName>   replace FontName in output file\n"
 "-cefsvg         generate SVG font instead of CEF font\n"
+"+/-K            do/don't keep the source font's subroutines\n"
 "\n"
 "CEF mode writes CEF (Compact Embedded Font) formatted data from an abstract\n"
 "font. The -F (FontName) option specifies a new PostScript FontName that\n"
 "replaces the one from the source font. The -cefsvg option tells the cefembed\n"
-"library to write out an SVG font instead of a CEF font.\n"
+"library to write out an SVG font instead of a CEF font. The +K option keeps\n"
+"the subroutines of a CFF source font that are used by the subset glyphs\n"
+"instead of flattening them (see the -cff mode +K option).\n"
 "\n"
 "For example, the command:\n"
 "\n"
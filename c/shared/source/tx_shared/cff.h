@@ -1,6 +1,7 @@
-"[-cff options: defaults -E, -F, -O, -S, +T, -V, -Z, -b, -d]\n"
+"[-cff options: defaults -E, -F, -K, -O, -S, +T, -V, -Z, -b, -d]\n"
 "+/-E    do/don't optimize for embedding\n"
 "+/-F    do/don't optimize Family zones\n"
+"+/-K    do/don't keep the source font's subroutines\n"
 "+/-O    do/don't optimize for ROM\n"
 "+/-S    do/don't subroutinize\n"
 "+/-T    do/don't optimize font (for testing purpose; not for production)\n"
@@ -33,6 +34,14 @@
 "exception of the .notdef glyph which is always assigned glyph index 0). The +d\n"
 "(debug) option enables duplicate hintsubrs warnings on stderr.\n"
 "\n"
+"The +K option applies to CFF and OpenType/CFF source fonts and is intended for\n"
+"subsetting. Rather than flattening the source font's subroutines into the\n"
+"charstrings, the subroutines used by the selected glyphs are kept, renumbered\n"
+"so that the most frequently called have the shortest numbers, and the rest\n"
+"are dropped. This is much faster than +S and usually gives similar sizes.\n"
+"Glyphs that can't be copied this way, and all glyphs when +S, +V, -n or\n"
+"a non-default FontMatrix are in effect, are written as if -K were used.\n"
+"\n"
 "For example, the command:\n"
 "\n"
 "    tx -cff +d -a rdr_____.pfb\n"
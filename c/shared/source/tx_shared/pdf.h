@@ -3,6 +3,7 @@
 "[-pdf options: default -0]\n"
 "-0      show glyph palette (320 glyphs/page)\n"
 "-1      -0 + glyph outlines (1 glyph/page)\n"
+"-z      compress streams and write pages as they are completed\n"
 "\n"
 "PDF mode writes PDF data that graphically represents the glyphs in an abstract\n"
 "font.\n"
@@ -12,3 +13,7 @@
 "per page that are linked to the corresponding glyph in the palette. Thus you\n"
 "can mouse click on a glyph in the palette to get to the outline page of the\n"
 "same glyph.\n"
+"\n"
+"The -z option Flate-compresses the content streams, draws each glyph outline\n"
+"once as a form that is referenced by its palette tile, and writes each page\n"
+"as soon as its glyphs have been read. Use it for large (e.g. CJK) fonts.\n"
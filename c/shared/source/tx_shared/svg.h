@@ -8,12 +8,18 @@
 "-gn2      Glyph names for all glyphs\n",
 "\n"
 "-abs      Write absolute coordinates (rather than relative)\n"
+"-c        Write compact path data\n"
+"-d <n>    Coordinate decimal places (0-4) [default 2]\n"
 "-sa       Standalone font file\n"
 "\n"
 "SVG mode converts an abstract font to an SVG font. The form of the SVG font is\n"
 "controlled by the options above.\n"
 "\n"
 "The options are reasonably self explanatory.\n"
+"\n"
+"The -c option writes the shortest path data for previews of whole fonts: all\n"
+"commands are relative, repeated command letters and redundant separators are\n"
+"omitted, and horizontal, vertical, and smooth segments use their short forms.\n"
 "\n",
 "For example, the command:\n"
 "\n"
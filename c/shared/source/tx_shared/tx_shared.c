@@ -242,6 +242,17 @@ static void *stm_open(ctlStreamCallbacks *cb, int id, size_t size) {
                 return NULL;
             break;
         }
+        case UFO_CACHE_SRC_STREAM_ID:
+        case UFO_CACHE_DST_STREAM_ID:
+            /* Glif cache file given with -glifCache; an unreadable or
+               unwritable file just isn't used */
+            if (h->ufr.cachePath == NULL)
+                return NULL;
+            s = &h->ufr.cache;
+            s->fp = fopen(h->ufr.cachePath, (id == UFO_CACHE_SRC_STREAM_ID) ? "rb" : "wb");
+            if (s->fp == NULL)
+                return NULL;
+            break;
         case CEF_DST_STREAM_ID:
             /* Open CEF destination stream */
             s = &h->dst.stm;
@@ -533,6 +544,7 @@ void stmInit(txCtx h) {
     stmSet(&h->dst.stm, stm_Dst, h->file.dst, h->dst.buf);
 
     stmSet(&h->cef.src, stm_Src, h->file.src, h->src.buf);
+    stmSet(&h->ufr.cache, stm_Dst, "(ufr) glif cache", h->ufr.cachebuf);
 
     tmpSet(&h->cef.tmp0, "(cef) tmpfile0");
     tmpSet(&h->cef.tmp1, "(cef) tmpfile1");
@@ -1664,17 +1676,12 @@ static void cefGlyphMap(cefMapCallback *cb,
         printf("[%hu]=<%s> ", gid, info->gname.ptr);
 }
 
-/* End font. */
-static void cef_EndFont(txCtx h) {
-    cefMapCallback map;
-    cefEmbedSpec spec;
-    int result;
+/* Fill embedding spec for the whole font or the -g subset. */
+static void cefFillSpec(txCtx h, cefEmbedSpec *spec, int whole) {
     long i;
     unsigned short unrec;
 
-    getGlyphList(h);
-
-    if (h->arg.g.cnt == 0) {
+    if (whole || h->arg.g.cnt == 0) {
         /* Whole font subset */
         dnaSET_CNT(h->cef.subset, h->src.glyphs.cnt);
         for (i = 0; i < h->cef.subset.cnt; i++)
@@ -1741,29 +1748,55 @@ static void cef_EndFont(txCtx h) {
 
     /* Initialize embedding spec. */
 initspec:
-    spec.flags = h->arg.cef.flags;
-    spec.newFontName = h->arg.cef.F;
-    spec.UDV = getUDV(h);
-    spec.URL = NULL;
-    spec.subset.cnt = h->cef.subset.cnt;
-    spec.subset.array = h->cef.subset.array;
-    spec.subset.names = (h->cef.gnames.cnt > 0) ? h->cef.gnames.array : NULL;
-    spec.kern.cnt = 0;
+    spec->flags = h->arg.cef.flags;
+    spec->newFontName = h->arg.cef.F;
+    spec->UDV = getUDV(h);
+    spec->URL = NULL;
+    spec->subset.cnt = h->cef.subset.cnt;
+    spec->subset.array = h->cef.subset.array;
+    spec->subset.names = (h->cef.gnames.cnt > 0) ? h->cef.gnames.array : NULL;
+    spec->kern.cnt = 0;
+}
 
-    printSpec(h, &spec);
+/* End font. */
+static void cef_EndFont(txCtx h) {
+    cefMapCallback map;
+    cefEmbedSpec spec;
+    int result = cefSuccess;
+
+    getGlyphList(h);
 
     /* Turn off segmentation on source stream */
     h->seg.refill = NULL;
 
+    if (h->arg.cef.flags & CEF_WRITE_SVG)
+        cefSetSvwFlags(h->cef.ctx, h->svw.flags);
+
+    if (h->arg.cef.prepared) {
+        /* Make whole font from prepared font; requested subset overwrites it */
+        result = cefBegPreparedFont(h->cef.ctx, getUDV(h));
+        if (result)
+            fatal(h, "(cef) %s", cefErrStr(result));
+        cefFillSpec(h, &spec, 1);
+        result = cefMakeEmbeddingFont(h->cef.ctx, &spec, NULL);
+    }
+
+    cefFillSpec(h, &spec, 0);
+
+    printSpec(h, &spec);
+
     /* Initialize glyph mapping callback */
     map.ctx = NULL;
     map.glyphmap = cefGlyphMap;
 
-    if (h->arg.cef.flags & CEF_WRITE_SVG)
-        cefSetSvwFlags(h->cef.ctx, h->svw.flags);
-
     /* Make embedding font */
-    result = cefMakeEmbeddingFont(h->cef.ctx, &spec, &map);
+    if (result == cefSuccess)
+        result = cefMakeEmbeddingFont(h->cef.ctx, &spec, &map);
+    if (h->arg.cef.prepared) {
+        int endResult = cefEndPreparedFont(h->cef.ctx);
+        if (result == cefSuccess)
+            result = endResult;
+    }
     if (result)
         fatal(h, "(cef) %s", cefErrStr(result));
     else
@@ -1779,6 +1812,7 @@ static void cef_SetMode(txCtx h) {
     /* Initialize args */
     h->arg.cef.F = NULL;
     h->arg.cef.flags = 0;
+    h->arg.cef.prepared = 0;
     h->svw.flags = SVW_NEWLINE_UNIX; /* In case cfembed library used in svgwrite mode */
 
     /* Set mode name */
@@ -2727,7 +2761,8 @@ static void svg_BegFont(txCtx h, abfTopDict *top) {
     h->svw.unrec = 0xE000; /* Start of Private Use Area */
 
     dstFileSetAutoName(h, top);
-    if (svwBegFont(h->svw.ctx, h->svw.flags))
+    if (svwSetPrecision(h->svw.ctx, h->svw.precision) ||
+        svwBegFont(h->svw.ctx, h->svw.flags))
         fatal(h, NULL);
 }
 
@@ -2746,6 +2781,7 @@ static void svg_SetMode(txCtx h) {
     /* Initialize control data */
     h->svw.options = 0;
     h->svw.flags = SVW_NEWLINE_UNIX;
+    h->svw.precision = 2;
 
     /* Set mode name */
     h->modename = "svg";
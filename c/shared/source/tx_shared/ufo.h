@@ -1,6 +1,10 @@
 "[-ufo options: default none]\n"
 "-altLayer NAME   Select a layer other than\n"
 "                 'com.adobe.type.processedglyphs'\n"
+"-glifCache FILE  When reading a UFO font, keep decoded glyphs\n"
+"                 in the cache file FILE and only parse GLIF\n"
+"                 files that changed since the last run. The\n"
+"                 UFO itself is never written\n"
 "\n"
 "UFO mode converts an abstract font to a UFO 2 font.\n"
 "\n"
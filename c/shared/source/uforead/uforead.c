@@ -32,6 +32,8 @@
 #include "supportexcept.h"
 #include "txops.h"
 #include "uforead.h"
+#include <libxml/xmlreader.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdarg.h>
 #include <stdio.h>
@@ -202,6 +204,83 @@ typedef struct {
     abfGlyphCallbacks* glyph_cb;
 } glifInfo;
 
+/* Decoded outline event of a glyph that is used as a component. The events
+   are recorded the first time the glyph is read as a component and replayed
+   for later references, instead of re-reading its glif file. */
+enum {
+    glifEvtContourBeg,
+    glifEvtContourEnd,
+    glifEvtPoint,
+    glifEvtComponent
+};
+
+typedef struct
+{
+    int type;
+    int pointType;       /* glifEvtPoint */
+    float x;
+    float y;
+    char* pointName;     /* glifEvtComponent in cache file: base glyph name */
+    long base;           /* glifEvtComponent: index of base glyph in chars.index */
+    Transform transform; /* glifEvtComponent: component transform */
+} GlifEvent;
+
+enum {
+    glifCacheUnknown,    /* Not yet read as a component */
+    glifCacheDone,       /* Events recorded */
+    glifCacheNone        /* Can't be replayed: has <lib> data with side effects */
+};
+
+typedef struct
+{
+    int state;
+    long first;  /* Index of first event in glif.cache.events */
+    long cnt;
+} GlifCacheRec;
+
+/* Streaming GLIF input. Each nesting level of component references has its
+   own reader, which is reset and reused for every glif file read at that
+   level. Data is copied out of the client stream buffer because a nested
+   read reuses that buffer. */
+typedef struct
+{
+    ufoCtx h;
+    void* src;               /* Source stream */
+    xmlTextReaderPtr reader;
+    char* buf;               /* Copy of last block read from stream */
+    size_t size;             /* Allocated size of buf */
+    char* next;              /* Next unread byte in buf */
+    size_t left;             /* Unread bytes in buf */
+    bool record;             /* Record outline events for replay */
+    bool preloaded;          /* buf already holds the whole glif file */
+    dnaDCL(GlifEvent, events);
+} GlifInput;
+
+/* Persistent glif cache (UFO_USE_CACHE). The cache file holds the decoded
+   outline events, advance width and Unicode value of each glyph, keyed by
+   glif file path, size and content hash. Glyphs whose glif file is unchanged
+   are set up from the cache without being parsed. */
+#define GLIF_CACHE_MAGIC   0x75667243  /* 'ufrC' */
+#define GLIF_CACHE_VERSION 1
+
+typedef struct
+{
+    uint32_t size;  /* Glif file size */
+    uint64_t hash;  /* Glif file content hash */
+    long entry;     /* Index of matching cache file entry; -1 if none */
+} GlifFileRec;
+
+typedef struct
+{
+    char* path;     /* Points into cache file data */
+    uint32_t size;
+    uint64_t hash;
+    long width;
+    unsigned long unicode;
+    long first;     /* Index of first event in glif.disk.events */
+    long cnt;
+} GlifDiskRec;
+
 struct ufoCtx_ {
     abfTopDict top;
     abfFontDict fdict;
@@ -228,6 +307,26 @@ struct ufoCtx_ {
         dnaDCL(OpRec, opList);
     } data;
     struct
+    {
+        dnaDCL(GlifInput*, inputs); /* Streaming readers, one per component nesting level */
+        long depth;                 /* Current nesting level */
+        struct
+        {
+            dnaDCL(GlifCacheRec, glyphs); /* Indexed like chars.index */
+            dnaDCL(GlifEvent, events);
+        } cache;
+        struct                            /* Persistent cache */
+        {
+            bool active;                  /* UFO_USE_CACHE was set */
+            bool dirty;                   /* Cache file needs rewriting */
+            dnaDCL(GlifFileRec, files);   /* Indexed by tag */
+            dnaDCL(GlifDiskRec, entries); /* Read from cache file; in path order */
+            dnaDCL(GlifEvent, events);    /* Events of entries */
+            dnaDCL(char, data);           /* Cache file data */
+            dnaDCL(char, out);            /* Cache file being written */
+        } disk;
+    } glif;
+    struct
     {
         StemHint stems[T2_MAX_STEMS];
         dnaDCL(HintMask, hintMasks);
@@ -332,19 +431,27 @@ static bool strEqual(const char* string1, const char* string2);
 static long strtolCheck(ufoCtx h, char* keyValue, bool fail, char* msg, int base);
 static double strtodCheck(ufoCtx h, char* keyValue, bool fail, char* msg);
 static unsigned long strtoulCheck(ufoCtx h, char* keyValue, bool fail, char* msg, int base);
+static void freeGlifEvents(ufoCtx h, GlifInput* in);
 
 /* XML File Parsing Functions */
 static xmlNodePtr parseXMLFile(ufoCtx h, char* filename, const char* filetype);
 static int parseXMLPlistFile(ufoCtx h, xmlNodePtr cur);
-static int parseXMLGlifFile(ufoCtx h, xmlNodePtr cur, int tag, unsigned long *unicode, abfGlyphCallbacks* glyph_cb, GLIF_Rec* glifRec);
+static int parseXMLGlifFile(ufoCtx h, int tag, unsigned long *unicode, abfGlyphCallbacks* glyph_cb, GLIF_Rec* glifRec);
 static char* parseXMLKeyName(ufoCtx h, xmlNodePtr cur);
 static char* parseXMLKeyValue(ufoCtx h, xmlNodePtr cur);
-static void parseXMLGLIFKey(ufoCtx h, xmlNodePtr cur, unsigned long *unicode, int tag, abfGlyphCallbacks* glyph_cb);
-static int parseXMLPoint(ufoCtx h, xmlNodePtr cur, abfGlyphCallbacks* glyph_cb, GLIF_Rec* glifRec, int state);
-static int parseXMLComponent(ufoCtx h, xmlNodePtr cur, GLIF_Rec* glifRec, abfGlyphCallbacks* glyph_cb);
-static int parseXMLAnchor(ufoCtx h, xmlNodePtr cur, GLIF_Rec* glifRec);
-static int parseXMLContour(ufoCtx h, xmlNodePtr cur, GLIF_Rec* glifRec, abfGlyphCallbacks* glyph_cb);
-static int parseXMLGuideline(ufoCtx h, xmlNodePtr cur, int tag, abfGlyphCallbacks* glyph_cb, GLIF_Rec* glifRec);
+static int parseXMLPoint(ufoCtx h, xmlTextReaderPtr reader, abfGlyphCallbacks* glyph_cb, GLIF_Rec* glifRec, int state);
+static int parseXMLComponent(ufoCtx h, xmlTextReaderPtr reader, GLIF_Rec* glifRec, abfGlyphCallbacks* glyph_cb);
+static int parseXMLAnchor(ufoCtx h, xmlTextReaderPtr reader, GLIF_Rec* glifRec);
+static void beginXMLContour(ufoCtx h);
+static void freeGlifCache(ufoCtx h);
+static void growGlifCache(ufoCtx h);
+static GlifInput* preloadGlifInput(ufoCtx h);
+static bool preParseCachedGLIF(ufoCtx h, GLIF_Rec* glifRec, int tag, GlifInput* in);
+static void resolveGlifCache(ufoCtx h);
+static void readGlifCacheFile(ufoCtx h);
+static void writeGlifCacheFile(ufoCtx h);
+static int endXMLContour(ufoCtx h, long contourStartOpIndex, abfGlyphCallbacks* glyph_cb);
+static int parseXMLGuideline(ufoCtx h, xmlTextReaderPtr reader, int tag, abfGlyphCallbacks* glyph_cb, GLIF_Rec* glifRec);
 static int parseType1HintDataV2(ufoCtx h, xmlNodePtr cur);
 static bool parseFontInfoFDArray(ufoCtx h, xmlNodePtr cur);
 static bool setFontInfoFD(ufoCtx h, char* keyName, char* keyValue);
@@ -484,6 +591,27 @@ void ufoFree(ufoCtx h) {
     dnaFREE(h->data.glifRecs);
     dnaFREE(h->data.glifOrder);
     dnaFREE(h->data.opList);
+    {
+        long i;
+        for (i = 0; i < h->glif.inputs.cnt; i++) {
+            GlifInput* in = h->glif.inputs.array[i];
+            if (in->reader != NULL)
+                xmlFreeTextReader(in->reader);
+            freeGlifEvents(h, in);
+            dnaFREE(in->events);
+            memFree(h, in->buf);
+            memFree(h, in);
+        }
+    }
+    dnaFREE(h->glif.inputs);
+    freeGlifCache(h);
+    dnaFREE(h->glif.cache.glyphs);
+    dnaFREE(h->glif.cache.events);
+    dnaFREE(h->glif.disk.files);
+    dnaFREE(h->glif.disk.entries);
+    dnaFREE(h->glif.disk.events);
+    dnaFREE(h->glif.disk.data);
+    dnaFREE(h->glif.disk.out);
     freeStrings(h);
     dnaFree(h->dna);
 
@@ -538,6 +666,14 @@ ufoCtx ufoNew(ctlMemoryCallbacks* mem_cb, ctlStreamCallbacks* stm_cb,
     dnaINIT(h->dna, h->data.glifRecs, 14, 100);
     dnaINIT(h->dna, h->data.glifOrder, 14, 100);
     dnaINIT(h->dna, h->data.opList, 50, 50);
+    dnaINIT(h->dna, h->glif.inputs, 4, 4);
+    dnaINIT(h->dna, h->glif.cache.glyphs, 256, 1000);
+    dnaINIT(h->dna, h->glif.cache.events, 1000, 5000);
+    dnaINIT(h->dna, h->glif.disk.files, 256, 1000);
+    dnaINIT(h->dna, h->glif.disk.entries, 256, 1000);
+    dnaINIT(h->dna, h->glif.disk.events, 1000, 5000);
+    dnaINIT(h->dna, h->glif.disk.data, 0, 65536);
+    dnaINIT(h->dna, h->glif.disk.out, 0, 65536);
     dnaINIT(h->dna, h->hints.hintMasks, 10, 10);
     dnaINIT(h->dna, h->hints.flexOpList, 10, 10);
     h->hints.hintMasks.func = initHintMask;
@@ -1450,7 +1586,6 @@ static void addCharFromGLIF(ufoCtx h, int tag, GLIF_Rec* glifRec, char* glyphNam
 
 static int preParseGLIF(ufoCtx h, GLIF_Rec* glifRec, int tag) {
     h->parseState.UFOFile = preParsingGLIF;
-    const char* filetype = "glyph";
     int char_begin = 0;
     int char_end = 0;
     unsigned long unicode = ABF_GLYPH_UNENC;
@@ -1492,11 +1627,17 @@ static int preParseGLIF(ufoCtx h, GLIF_Rec* glifRec, int tag) {
         fatal(h, ufoErrSrcStream, "Failed to open the %s glif file.\n", glifRec->glifFilePath);
     }
 
+    if (h->glif.disk.active &&
+        preParseCachedGLIF(h, glifRec, tag, preloadGlifInput(h))) {
+        h->cb.stm.close(&h->cb.stm, h->stm.src);
+        h->stm.src = NULL;
+        return ufoSuccess;
+    }
+
     dnaSET_CNT(h->valueArray, 0);
     h->parseState.GLIFInfo.glifRec = glifRec;
 
-    xmlNodePtr cur = parseXMLFile(h, h->cb.stm.clientFileName, filetype);
-    int parsingSuccess = parseXMLGlifFile(h, cur, tag, &unicode, NULL, glifRec);
+    int parsingSuccess = parseXMLGlifFile(h, tag, &unicode, NULL, glifRec);
 
     h->cb.stm.close(&h->cb.stm, h->stm.src);
     h->stm.src = NULL;
@@ -1631,10 +1772,6 @@ static bool xmlAttrEqual(xmlAttr *attr, char* name){
         return false;
 }
 
-static char* getXmlAttrValue(xmlAttr *attr){
-    return (char*) attr->children->content;
-}
-
 static bool setXMLLib(ufoCtx h, xmlNodePtr cur, char* keyName) {
     char* keyValue;
     bool result = false;
@@ -1664,46 +1801,488 @@ static void parseXMLLib(ufoCtx h, xmlNodePtr cur) {
     }
 }
 
-static void parseXMLOutline(ufoCtx h, xmlNodePtr cur, GLIF_Rec* glifRec, abfGlyphCallbacks* glyph_cb ) {
-    cur = cur->xmlChildrenNode;
-    while (cur != NULL) {
-        if (xmlKeyEqual(cur, "contour")) {
-            parseXMLContour(h, cur, glifRec, glyph_cb);
-        } else if (xmlKeyEqual(cur, "component")) {
-            parseXMLComponent(h, cur, glifRec, glyph_cb);
+static bool readerAttrEqual(xmlTextReaderPtr reader, char* name) {
+    return xmlStrEqual(xmlTextReaderConstLocalName(reader), (const xmlChar *) name);
+}
+
+static char* getReaderAttrValue(xmlTextReaderPtr reader) {
+    return (char*) xmlTextReaderConstValue(reader);
+}
+
+/* Refill callback for the GLIF reader */
+static int glifInputRead(void* ctx, char* buffer, int len) {
+    GlifInput* in = ctx;
+    ufoCtx h = in->h;
+
+    if (in->left == 0) {
+        char* ptr;
+        size_t count;
+        if (in->src == NULL)
+            return 0;  /* Preloaded data used up */
+        count = h->cb.stm.read(&h->cb.stm, in->src, &ptr);
+        if (count == 0)
+            return 0;
+        if (count > in->size) {
+            memFree(h, in->buf);
+            in->buf = memNew(h, count);
+            in->size = count;
         }
-        cur = cur->next;
+        memcpy(in->buf, ptr, count);
+        in->next = in->buf;
+        in->left = count;
+    }
+    if ((size_t)len > in->left)
+        len = (int)in->left;
+    memcpy(buffer, in->next, len);
+    in->next += len;
+    in->left -= len;
+    return len;
+}
+
+/* Get the input for the current component nesting level. */
+static GlifInput* getGlifInput(ufoCtx h) {
+    if (h->glif.depth == h->glif.inputs.cnt) {
+        GlifInput* in = memNew(h, sizeof(GlifInput));
+        memset(in, 0, sizeof(GlifInput));
+        in->h = h;
+        dnaINIT(h->dna, in->events, 100, 500);
+        *dnaNEXT(h->glif.inputs) = in;
     }
+    return h->glif.inputs.array[h->glif.depth];
 }
 
-static void parseXMLGLIFKey(ufoCtx h, xmlNodePtr cur, unsigned long *unicode, int tag, abfGlyphCallbacks* glyph_cb) {
-    GLIF_Rec* glifRec = h->parseState.GLIFInfo.glifRec;
-    char* keyValue;
-    xmlAttr *attr = cur->properties;
-    if (h->parseState.UFOFile == preParsingGLIF) {      /* called from preParseGLIF */
-        if (xmlKeyEqual(cur, "advance")) {
-            while (attr != NULL) {
-                if (xmlAttrEqual(attr, "width") || xmlAttrEqual(attr, "advance"))
-                    setWidth(h, tag, strtolCheck(h, getXmlAttrValue(attr), false, NULL, 10));
-                attr = attr->next;
+/* Discard the events recorded by an input, freeing their point names. */
+static void freeGlifEvents(ufoCtx h, GlifInput* in) {
+    long i;
+    for (i = 0; i < in->events.cnt; i++) {
+        if (in->events.array[i].pointName != NULL)
+            memFree(h, in->events.array[i].pointName);
+    }
+    in->events.cnt = 0;
+}
+
+/* Get reader for the current component nesting level, set up to read the
+   already open h->stm.src stream, or the data preloaded from it. */
+static GlifInput* beginGlifInput(ufoCtx h, char* filename) {
+    GlifInput* in = getGlifInput(h);
+    int options = XML_PARSE_NOBLANKS | XML_PARSE_NONET;
+
+    if (in->preloaded) {
+        in->src = NULL;
+        in->preloaded = false;
+    } else {
+        in->src = h->stm.src;
+        in->next = in->buf;
+        in->left = 0;
+    }
+    in->record = h->parseState.UFOFile == parsingGLIF &&
+                 (h->glif.depth > 0 || h->glif.disk.active);
+    freeGlifEvents(h, in);
+
+    if (in->reader == NULL) {
+        in->reader = xmlReaderForIO(glifInputRead, NULL, in, filename, NULL, options);
+        if (in->reader == NULL)
+            fatal(h, ufoErrNoMemory, NULL);
+    } else if (xmlReaderNewIO(in->reader, glifInputRead, NULL, in, filename, NULL, options) != 0) {
+        fatal(h, ufoErrSrcStream, "Unable to read '%s'.\n", filename);
+    }
+    return in;
+}
+
+/* Return a new event for the glyph being read at the current nesting level,
+   or NULL if it isn't being recorded. */
+static GlifEvent* newGlifEvent(ufoCtx h, int type) {
+    GlifInput* in;
+    GlifEvent* ev;
+
+    if (h->glif.depth >= h->glif.inputs.cnt)
+        return NULL;
+    in = h->glif.inputs.array[h->glif.depth];
+    if (!in->record)
+        return NULL;
+    ev = dnaNEXT(in->events);
+    ev->type = type;
+    ev->pointName = NULL;
+    return ev;
+}
+
+static void freeGlifCache(ufoCtx h) {
+    long i;
+    for (i = 0; i < h->glif.cache.events.cnt; i++) {
+        GlifEvent* ev = &h->glif.cache.events.array[i];
+        if (ev->pointName != NULL)
+            memFree(h, ev->pointName);
+    }
+    h->glif.cache.events.cnt = 0;
+    h->glif.cache.glyphs.cnt = 0;
+}
+
+/* Make sure glif.cache.glyphs has a record for every char. */
+static void growGlifCache(ufoCtx h) {
+    if (h->glif.cache.glyphs.cnt < h->chars.index.cnt) {
+        long cnt = h->glif.cache.glyphs.cnt;
+        dnaSET_CNT(h->glif.cache.glyphs, h->chars.index.cnt);
+        memset(&h->glif.cache.glyphs.array[cnt], 0,
+               (h->chars.index.cnt - cnt) * sizeof(GlifCacheRec));
+    }
+}
+
+/* --------------------------- Glif Cache File ----------------------------- */
+
+/* Read the whole of the open h->stm.src glif stream into the buffer of the
+   current input, so it can be hashed and, if needed, parsed from memory. */
+static GlifInput* preloadGlifInput(ufoCtx h) {
+    GlifInput* in = getGlifInput(h);
+    size_t total = 0;
+
+    for (;;) {
+        char* ptr;
+        size_t count = h->cb.stm.read(&h->cb.stm, h->stm.src, &ptr);
+        if (count == 0)
+            break;
+        if (total + count > in->size) {
+            size_t size = (in->size == 0) ? BUFSIZ : in->size;
+            char* buf;
+            while (size < total + count)
+                size *= 2;
+            buf = memNew(h, size);
+            if (total > 0)
+                memcpy(buf, in->buf, total);
+            memFree(h, in->buf);
+            in->buf = buf;
+            in->size = size;
+        }
+        memcpy(in->buf + total, ptr, count);
+        total += count;
+    }
+    in->next = in->buf;
+    in->left = total;
+    in->preloaded = true;
+    return in;
+}
+
+/* 64-bit FNV-1a hash of glif file data. */
+static uint64_t hashGlifData(const char* data, size_t length) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    size_t i;
+    for (i = 0; i < length; i++) {
+        hash ^= (unsigned char)data[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/* Match glif file path with cache file entry. */
+static int CTL_CDECL matchGlifDiskRec(const void* key, const void* value,
+                                      void* ctx) {
+    return strcmp((char*)key, ((GlifDiskRec*)value)->path);
+}
+
+/* Compare cache file entries by glif file path. */
+static int CTL_CDECL cmpGlifDiskRecs(const void* first, const void* second,
+                                     void* ctx) {
+    return strcmp(((GlifDiskRec*)first)->path, ((GlifDiskRec*)second)->path);
+}
+
+/* Note the size and hash of a glif file preloaded into "in" and, if they
+   match its cache file entry, set the glyph up from that entry instead of
+   pre-parsing it. Returns true if the glyph was set up from the cache. */
+static bool preParseCachedGLIF(ufoCtx h, GLIF_Rec* glifRec, int tag, GlifInput* in) {
+    GlifFileRec* file = dnaMAX(h->glif.disk.files, tag);
+    size_t index;
+
+    file->size = (uint32_t)in->left;
+    file->hash = hashGlifData(in->buf, in->left);
+    file->entry = -1;
+
+    if (ctuLookup(glifRec->glifFilePath, h->glif.disk.entries.array,
+                  h->glif.disk.entries.cnt, sizeof(GlifDiskRec),
+                  matchGlifDiskRec, &index, h)) {
+        GlifDiskRec* entry = &h->glif.disk.entries.array[index];
+        if (entry->size == file->size && entry->hash == file->hash) {
+            file->entry = (long)index;
+            in->preloaded = false;
+            setWidth(h, tag, entry->width);
+            addCharFromGLIF(h, tag, glifRec, glifRec->glyphName, 0, 0, entry->unicode);
+            h->parseState.GLIFInfo.currentCID = -1;
+            h->parseState.GLIFInfo.currentiFD = -1;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Copy the outline events of glyphs set up from the cache file into the
+   decoded outline cache so that parseGLIF() replays them. Component base
+   glyphs are stored by name and are looked up again here. */
+static void resolveGlifCache(ufoCtx h) {
+    long i;
+
+    growGlifCache(h);
+    for (i = 0; i < h->chars.index.cnt; i++) {
+        long tag = h->chars.index.array[i].tag;
+        long first = h->glif.cache.events.cnt;
+        GlifDiskRec* entry;
+        long j;
+
+        if (tag >= h->glif.disk.files.cnt || h->glif.disk.files.array[tag].entry < 0)
+            continue;
+        entry = &h->glif.disk.entries.array[h->glif.disk.files.array[tag].entry];
+
+        for (j = 0; j < entry->cnt; j++) {
+            GlifEvent* src = &h->glif.disk.events.array[entry->first + j];
+            GlifEvent* ev = dnaNEXT(h->glif.cache.events);
+            *ev = *src;
+            ev->pointName = NULL;
+            if (src->type == glifEvtComponent) {
+                size_t index;
+                if (!ctuLookup(src->pointName, h->chars.byName.array, h->chars.byName.cnt,
+                               sizeof(h->chars.byName.array[0]), postMatchChar, &index, h))
+                    break;
+                ev->base = h->chars.byName.array[index];
+            } else if (src->pointName != NULL) {
+                ev->pointName = copyStr(h, src->pointName);
             }
-        } else if (xmlKeyEqual(cur, "unicode")) {
-            if (xmlAttrEqual(attr, "hex"))
-                *unicode = strtoulCheck(h, getXmlAttrValue(attr), false, NULL, 16);
         }
-    } else if (h->parseState.UFOFile == parsingGLIF) {  /* called from parseGLIF */
-        if (xmlKeyEqual(cur, "outline"))
-            parseXMLOutline(h, cur, glifRec, glyph_cb);
-        else if (xmlKeyEqual(cur, "anchor"))
-            parseXMLAnchor(h, cur, glifRec);
-        else if (xmlKeyEqual(cur, "guideline"))
-            parseXMLGuideline(h, cur, tag, glyph_cb, glifRec);
+        if (j < entry->cnt) {
+            /* Base glyph has gone; read the glif file instead */
+            for (j = first; j < h->glif.cache.events.cnt; j++) {
+                if (h->glif.cache.events.array[j].pointName != NULL)
+                    memFree(h, h->glif.cache.events.array[j].pointName);
+            }
+            h->glif.cache.events.cnt = first;
+            continue;
+        }
+        h->glif.cache.glyphs.array[i].state = glifCacheDone;
+        h->glif.cache.glyphs.array[i].first = first;
+        h->glif.cache.glyphs.array[i].cnt = entry->cnt;
     }
-    if (xmlKeyEqual(cur, "lib")) {
-        /* so nice it's parsed twice.
-         (parsed in both preParseGLIF and parseGLIF until these two are merged in the future.) */
-        parseXMLLib(h, cur);
+}
+
+/* Cache file data is stored big-endian. Strings are stored as a 16-bit byte
+   count followed by the bytes and a terminating null; a NULL string has a
+   count of 0xFFFF. */
+typedef struct
+{
+    const unsigned char* next;
+    const unsigned char* end;
+    bool ok;
+} CacheCursor;
+
+static unsigned long getCacheN(CacheCursor* c, int n) {
+    unsigned long value = 0;
+    if (c->end - c->next < n) {
+        c->ok = false;
+        return 0;
     }
+    while (n--)
+        value = value << 8 | *c->next++;
+    return value;
+}
+
+static float getCacheReal(CacheCursor* c) {
+    uint32_t bits = (uint32_t)getCacheN(c, 4);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static char* getCacheStr(CacheCursor* c) {
+    unsigned long length = getCacheN(c, 2);
+    char* str = (char*)c->next;
+    if (length == 0xFFFF || !c->ok)
+        return NULL;
+    if ((unsigned long)(c->end - c->next) < length + 1 || str[length] != '\0') {
+        c->ok = false;
+        return NULL;
+    }
+    c->next += length + 1;
+    return str;
+}
+
+static void putCacheN(ufoCtx h, unsigned long value, int n) {
+    char* p = dnaEXTEND(h->glif.disk.out, n);
+    while (n--) {
+        p[n] = (char)(value & 0xFF);
+        value >>= 8;
+    }
+}
+
+static void putCacheReal(ufoCtx h, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    putCacheN(h, bits, 4);
+}
+
+static void putCacheStr(ufoCtx h, const char* str) {
+    size_t length;
+    if (str == NULL) {
+        putCacheN(h, 0xFFFF, 2);
+        return;
+    }
+    length = strlen(str);
+    if (length >= 0xFFFF)
+        length = 0xFFFE;
+    putCacheN(h, (unsigned long)length, 2);
+    memcpy(dnaEXTEND(h->glif.disk.out, length), str, length);
+    *dnaNEXT(h->glif.disk.out) = '\0';
+}
+
+/* Read the cache file, if any. A missing, outdated or damaged cache file is
+   ignored; all glyphs are then parsed and the file is rewritten. */
+static void readGlifCacheFile(ufoCtx h) {
+    CacheCursor c;
+    unsigned long cnt;
+    unsigned long i;
+    void* stm;
+
+    h->glif.disk.data.cnt = 0;
+    h->glif.disk.entries.cnt = 0;
+    h->glif.disk.events.cnt = 0;
+
+    h->cb.stm.clientFileName = NULL; /* Client picks the cache file */
+    stm = h->cb.stm.open(&h->cb.stm, UFO_CACHE_SRC_STREAM_ID, 0);
+    if (stm == NULL)
+        return;
+    for (;;) {
+        char* ptr;
+        size_t count = h->cb.stm.read(&h->cb.stm, stm, &ptr);
+        if (count == 0)
+            break;
+        memcpy(dnaEXTEND(h->glif.disk.data, (long)count), ptr, count);
+    }
+    h->cb.stm.close(&h->cb.stm, stm);
+
+    c.next = (unsigned char*)h->glif.disk.data.array;
+    c.end = c.next + h->glif.disk.data.cnt;
+    c.ok = true;
+    if (getCacheN(&c, 4) != GLIF_CACHE_MAGIC || getCacheN(&c, 4) != GLIF_CACHE_VERSION)
+        return;
+
+    cnt = getCacheN(&c, 4);
+    for (i = 0; i < cnt && c.ok; i++) {
+        GlifDiskRec* entry = dnaNEXT(h->glif.disk.entries);
+        long j;
+
+        entry->path = getCacheStr(&c);
+        entry->size = (uint32_t)getCacheN(&c, 4);
+        entry->hash = (uint64_t)getCacheN(&c, 4) << 32;
+        entry->hash |= getCacheN(&c, 4);
+        entry->width = (int32_t)getCacheN(&c, 4);
+        entry->unicode = getCacheN(&c, 4);
+        entry->cnt = getCacheN(&c, 4);
+        entry->first = h->glif.disk.events.cnt;
+        if (entry->path == NULL)
+            c.ok = false;
+
+        for (j = 0; j < entry->cnt && c.ok; j++) {
+            GlifEvent* ev = dnaNEXT(h->glif.disk.events);
+            ev->type = (int)getCacheN(&c, 1);
+            ev->pointName = NULL;
+            ev->base = -1;
+            switch (ev->type) {
+                case glifEvtContourBeg:
+                case glifEvtContourEnd:
+                    break;
+                case glifEvtPoint:
+                    ev->pointType = (int)getCacheN(&c, 1);
+                    ev->x = getCacheReal(&c);
+                    ev->y = getCacheReal(&c);
+                    ev->pointName = getCacheStr(&c);
+                    break;
+                case glifEvtComponent: {
+                    int k;
+                    ev->pointName = getCacheStr(&c);
+                    for (k = 0; k < 6; k++)
+                        ev->transform.mtx[k] = getCacheReal(&c);
+                    ev->transform.isDefault = (int)getCacheN(&c, 1);
+                    ev->transform.isOffsetOnly = (int)getCacheN(&c, 1);
+                    if (ev->pointName == NULL)
+                        c.ok = false;
+                    break;
+                }
+                default:
+                    c.ok = false;
+                    break;
+            }
+        }
+    }
+
+    if (!c.ok || c.next != c.end) {
+        h->glif.disk.entries.cnt = 0;
+        h->glif.disk.events.cnt = 0;
+        return;
+    }
+    ctuQSort(h->glif.disk.entries.array, h->glif.disk.entries.cnt,
+             sizeof(GlifDiskRec), cmpGlifDiskRecs, h);
+}
+
+/* Write the cache file from the decoded outlines of all glyphs that could be
+   recorded. Failure to write the file is not an error. */
+static void writeGlifCacheFile(ufoCtx h) {
+    unsigned long cnt = 0;
+    long i;
+    void* stm;
+
+    h->glif.disk.out.cnt = 0;
+    putCacheN(h, GLIF_CACHE_MAGIC, 4);
+    putCacheN(h, GLIF_CACHE_VERSION, 4);
+    putCacheN(h, 0, 4); /* Entry count; set below */
+
+    for (i = 0; i < h->chars.index.cnt && i < h->glif.cache.glyphs.cnt; i++) {
+        abfGlyphInfo* chr = &h->chars.index.array[i];
+        GlifCacheRec* rec = &h->glif.cache.glyphs.array[i];
+        GlifFileRec* file;
+        long j;
+
+        if (rec->state != glifCacheDone || chr->tag >= h->glif.disk.files.cnt)
+            continue;
+        file = &h->glif.disk.files.array[chr->tag];
+
+        putCacheStr(h, h->data.glifRecs.array[chr->tag].glifFilePath);
+        putCacheN(h, file->size, 4);
+        putCacheN(h, (unsigned long)(file->hash >> 32), 4);
+        putCacheN(h, (unsigned long)(file->hash & 0xFFFFFFFF), 4);
+        putCacheN(h, (unsigned long)getWidth(h, (STI)chr->tag) & 0xFFFFFFFF, 4);
+        putCacheN(h, (chr->flags & ABF_GLYPH_UNICODE) ? chr->encoding.code : ABF_GLYPH_UNENC, 4);
+        putCacheN(h, (unsigned long)rec->cnt, 4);
+
+        for (j = rec->first; j < rec->first + rec->cnt; j++) {
+            GlifEvent* ev = &h->glif.cache.events.array[j];
+            putCacheN(h, (unsigned long)ev->type, 1);
+            if (ev->type == glifEvtPoint) {
+                putCacheN(h, (unsigned long)ev->pointType, 1);
+                putCacheReal(h, ev->x);
+                putCacheReal(h, ev->y);
+                putCacheStr(h, ev->pointName);
+            } else if (ev->type == glifEvtComponent) {
+                int k;
+                putCacheStr(h, getString(h, (STI)h->chars.index.array[ev->base].tag));
+                for (k = 0; k < 6; k++)
+                    putCacheReal(h, ev->transform.mtx[k]);
+                putCacheN(h, (unsigned long)ev->transform.isDefault, 1);
+                putCacheN(h, (unsigned long)ev->transform.isOffsetOnly, 1);
+            }
+        }
+        cnt++;
+    }
+    for (i = 0; i < 4; i++)
+        h->glif.disk.out.array[8 + i] = (char)(cnt >> (24 - 8 * i));
+
+    h->cb.stm.clientFileName = NULL; /* Client picks the cache file */
+    stm = h->cb.stm.open(&h->cb.stm, UFO_CACHE_DST_STREAM_ID, h->glif.disk.out.cnt);
+    if (stm == NULL)
+        return;
+    if (h->cb.stm.write(&h->cb.stm, stm, h->glif.disk.out.cnt, h->glif.disk.out.array) ==
+        (size_t)h->glif.disk.out.cnt)
+        h->glif.disk.dirty = false;
+    h->cb.stm.close(&h->cb.stm, stm);
+}
+
+/* Skip the rest of the current element; returns the xmlTextReaderNext()
+   result. */
+static int skipGlifElement(xmlTextReaderPtr reader) {
+    return xmlTextReaderNext(reader);
 }
 
 /* ToDo: add extra warnings for verbose-output*/
@@ -1824,12 +2403,105 @@ static int parseXMLPlistFile(ufoCtx h, xmlNodePtr cur) {
     return ufoSuccess;
 }
 
-static int parseXMLGlifFile(ufoCtx h, xmlNodePtr cur, int tag, unsigned long *unicode, abfGlyphCallbacks* glyph_cb, GLIF_Rec* glifRec) {
-    char* keyName;
-    while (cur != NULL) {
-        parseXMLGLIFKey(h, cur, unicode, tag, glyph_cb);
-        cur = cur->next;
+/* Read the open glif stream h->stm.src in a single streaming pass, sending
+   outline data to glyph_cb as it is seen. Only the <lib> element, which holds
+   plist data, is expanded into a (small) tree. */
+static int parseXMLGlifFile(ufoCtx h, int tag, unsigned long *unicode, abfGlyphCallbacks* glyph_cb, GLIF_Rec* glifRec) {
+    char* filename = h->cb.stm.clientFileName;
+    GlifInput* in = beginGlifInput(h, filename);
+    xmlTextReaderPtr reader = in->reader;
+    bool seenRoot = false;
+    long contourStartOpIndex = -1;  /* -1 if not in a contour */
+    int ret = xmlTextReaderRead(reader);
+
+    while (ret == 1) {
+        int type = xmlTextReaderNodeType(reader);
+        int depth = xmlTextReaderDepth(reader);
+
+        if (type == XML_READER_TYPE_END_ELEMENT) {
+            if (depth == 2 && contourStartOpIndex >= 0) {
+                newGlifEvent(h, glifEvtContourEnd);
+                endXMLContour(h, contourStartOpIndex, glyph_cb);
+                contourStartOpIndex = -1;
+            }
+            ret = xmlTextReaderRead(reader);
+            continue;
+        } else if (type != XML_READER_TYPE_ELEMENT) {
+            ret = xmlTextReaderRead(reader);
+            continue;
+        }
+
+        if (depth == 0) {
+            if (!readerAttrEqual(reader, "glyph"))
+                fatal(h, ufoErrSrcStream, "File %s is of the wrong type, root node != %s.\n", filename, "glyph");
+            seenRoot = true;
+        } else if (depth == 1) {
+            if (readerAttrEqual(reader, "lib")) {
+                /* so nice it's parsed twice.
+                 (parsed in both preParseGLIF and parseGLIF until these two are merged in the future.) */
+                xmlNodePtr cur = xmlTextReaderExpand(reader);
+                if (cur != NULL)
+                    parseXMLLib(h, cur);
+                in->record = false;
+                freeGlifEvents(h, in);
+                ret = skipGlifElement(reader);
+                continue;
+            } else if (h->parseState.UFOFile == preParsingGLIF) {  /* called from preParseGLIF */
+                if (readerAttrEqual(reader, "advance")) {
+                    while (xmlTextReaderMoveToNextAttribute(reader) == 1) {
+                        if (readerAttrEqual(reader, "width") || readerAttrEqual(reader, "advance"))
+                            setWidth(h, tag, strtolCheck(h, getReaderAttrValue(reader), false, NULL, 10));
+                    }
+                } else if (readerAttrEqual(reader, "unicode")) {
+                    if (xmlTextReaderMoveToFirstAttribute(reader) == 1 && readerAttrEqual(reader, "hex"))
+                        *unicode = strtoulCheck(h, getReaderAttrValue(reader), false, NULL, 16);
+                }
+            } else if (h->parseState.UFOFile == parsingGLIF) {  /* called from parseGLIF */
+                if (readerAttrEqual(reader, "outline")) {
+                    ret = xmlTextReaderRead(reader);  /* descend */
+                    continue;
+                } else if (readerAttrEqual(reader, "anchor")) {
+                    parseXMLAnchor(h, reader, glifRec);
+                } else if (readerAttrEqual(reader, "guideline")) {
+                    parseXMLGuideline(h, reader, tag, glyph_cb, glifRec);
+                }
+            }
+            /* Everything else at this level (including the outline when
+               pre-parsing) is skipped without being read into memory. */
+            xmlTextReaderMoveToElement(reader);
+            ret = skipGlifElement(reader);
+            continue;
+        } else if (depth == 2) {  /* <outline> children */
+            if (readerAttrEqual(reader, "contour")) {
+                int isEmpty = xmlTextReaderIsEmptyElement(reader);
+                contourStartOpIndex = h->data.opList.cnt;
+                newGlifEvent(h, glifEvtContourBeg);
+                beginXMLContour(h);
+                if (isEmpty) {
+                    newGlifEvent(h, glifEvtContourEnd);
+                    endXMLContour(h, contourStartOpIndex, glyph_cb);
+                    contourStartOpIndex = -1;
+                }
+            } else if (readerAttrEqual(reader, "component")) {
+                parseXMLComponent(h, reader, glifRec, glyph_cb);
+                xmlTextReaderMoveToElement(reader);
+                ret = skipGlifElement(reader);
+                continue;
+            } else {
+                ret = skipGlifElement(reader);
+                continue;
+            }
+        } else if (depth == 3 && contourStartOpIndex >= 0 && readerAttrEqual(reader, "point")) {
+            parseXMLPoint(h, reader, glyph_cb, glifRec, 2);
+        }
+        ret = xmlTextReaderRead(reader);
     }
+
+    if (ret < 0)
+        fatal(h, ufoErrParse, "Unable to read '%s'.\n", filename);
+    if (!seenRoot)
+        fatal(h, ufoErrParse, "The %s file is empty.\n", filename);
+
     if (h->parseState.UFOFile == preParsingGLIF) {
         addCharFromGLIF(h, tag, glifRec, glifRec->glyphName, 0, 0, *unicode);
         h->parseState.GLIFInfo.currentCID = -1;
@@ -2343,38 +3015,35 @@ static int parseUFO(ufoCtx h) {
         retVal = parseGlyphList(h, true); /* parse alternate layer */
     if (retVal == ufoSuccess)
         retVal = preParseGLIFS(h);
+    if (retVal == ufoSuccess && h->glif.disk.active)
+        resolveGlifCache(h);
     return retVal;
 }
 
-static int parseXMLGuideline(ufoCtx h, xmlNodePtr cur, int tag, abfGlyphCallbacks* glyph_cb, GLIF_Rec* glifRec) {
-    token* tk;
-    char* end;
-    int prevState = outlineStart;
+static int parseXMLGuideline(ufoCtx h, xmlTextReaderPtr reader, int tag, abfGlyphCallbacks* glyph_cb, GLIF_Rec* glifRec) {
     int result = ufoSuccess;
     guidelineRec* guideline;
 
     guideline = memNew(h, sizeof(guidelineRec));
     memset(guideline, 0, sizeof(guidelineRec));
 
-    xmlAttr *attr = cur->properties;
-    while (attr != NULL) {
-        if (xmlAttrEqual(attr, "x"))
-            guideline->x = (float)strtodCheck(h, getXmlAttrValue(attr), false, NULL);
-        else if (xmlAttrEqual(attr, "y"))
-            guideline->y = (float)strtodCheck(h, getXmlAttrValue(attr), false, NULL);
-        else if (xmlAttrEqual(attr, "angle"))
-            guideline->angle = (float)strtodCheck(h, getXmlAttrValue(attr), false, NULL);
-        else if (xmlAttrEqual(attr, "name")) {
-            char* temp = getXmlAttrValue(attr);
+    while (xmlTextReaderMoveToNextAttribute(reader) == 1) {
+        if (readerAttrEqual(reader, "x"))
+            guideline->x = (float)strtodCheck(h, getReaderAttrValue(reader), false, NULL);
+        else if (readerAttrEqual(reader, "y"))
+            guideline->y = (float)strtodCheck(h, getReaderAttrValue(reader), false, NULL);
+        else if (readerAttrEqual(reader, "angle"))
+            guideline->angle = (float)strtodCheck(h, getReaderAttrValue(reader), false, NULL);
+        else if (readerAttrEqual(reader, "name")) {
+            char* temp = getReaderAttrValue(reader);
             guideline->name = copyStr(h, temp);
-        } else if (xmlAttrEqual(attr, "color")) {
-            char* temp = getXmlAttrValue(attr);
+        } else if (readerAttrEqual(reader, "color")) {
+            char* temp = getReaderAttrValue(reader);
             guideline->color = copyStr(h, temp);
-        } else if (xmlAttrEqual(attr, "identifier")) {
-            char* temp = getXmlAttrValue(attr);
+        } else if (readerAttrEqual(reader, "identifier")) {
+            char* temp = getReaderAttrValue(reader);
             guideline->identifier = copyStr(h, temp);
         }
-        attr = attr->next;
     }
     memFree(h, guideline);
     /* ToDo: instead of freeing it, append the guideline record to a
@@ -2382,30 +3051,28 @@ static int parseXMLGuideline(ufoCtx h, xmlNodePtr cur, int tag, abfGlyphCallback
     return result;
 }
 
-static int parseXMLAnchor(ufoCtx h, xmlNodePtr cur, GLIF_Rec* glifRec) {
+static int parseXMLAnchor(ufoCtx h, xmlTextReaderPtr reader, GLIF_Rec* glifRec) {
     int result = ufoSuccess;
     anchorRec* anchor;
 
     anchor = memNew(h, sizeof(anchorRec));
     memset(anchor, 0, sizeof(anchorRec));
 
-    xmlAttr *attr = cur->properties;
-    while (attr != NULL) {
-        if (xmlAttrEqual(attr, "x"))
-            anchor->x = (float)atof(getXmlAttrValue(attr));
-        else if (xmlAttrEqual(attr, "y"))
-            anchor->y = (float)atof(getXmlAttrValue(attr));
-        else if (xmlAttrEqual(attr, "name")) {
-            char* temp = getXmlAttrValue(attr);
+    while (xmlTextReaderMoveToNextAttribute(reader) == 1) {
+        if (readerAttrEqual(reader, "x"))
+            anchor->x = (float)atof(getReaderAttrValue(reader));
+        else if (readerAttrEqual(reader, "y"))
+            anchor->y = (float)atof(getReaderAttrValue(reader));
+        else if (readerAttrEqual(reader, "name")) {
+            char* temp = getReaderAttrValue(reader);
             anchor->name = copyStr(h, temp);
-        } else if (xmlAttrEqual(attr, "color")) {
-            char* temp = getXmlAttrValue(attr);
+        } else if (readerAttrEqual(reader, "color")) {
+            char* temp = getReaderAttrValue(reader);
             anchor->color = copyStr(h, temp);
-        } else if (xmlAttrEqual(attr, "identifier")) {
-            char* temp = getXmlAttrValue(attr);
+        } else if (readerAttrEqual(reader, "identifier")) {
+            char* temp = getReaderAttrValue(reader);
             anchor->identifier = copyStr(h, temp);
         }
-        attr = attr->next;
     }
     memFree(h, anchor);
     /* ToDo: instead of freeing it, append the anchor record to a
@@ -2476,24 +3143,23 @@ static int setPointKeyValue(ufoCtx h, abfGlyphCallbacks* glyph_cb, float x, floa
     return result;
 }
 
-static int parseXMLPoint(ufoCtx h, xmlNodePtr cur, abfGlyphCallbacks* glyph_cb, GLIF_Rec* glifRec, int state) {
+static int parseXMLPoint(ufoCtx h, xmlTextReaderPtr reader, abfGlyphCallbacks* glyph_cb, GLIF_Rec* glifRec, int state) {
     float x = 0;
     float y = 0;
     int type = 0;
     char* pointName = NULL;
     int result = ufoSuccess;
 
-    xmlAttr *attr = cur->properties;
-    while (attr != NULL) {
-        if (xmlAttrEqual(attr, "x"))
-            x = (float)strtodCheck(h, getXmlAttrValue(attr), false, NULL);
-        else if (xmlAttrEqual(attr, "y"))
-            y = (float)strtodCheck(h, getXmlAttrValue(attr), false, NULL);
-        else if (xmlAttrEqual(attr, "name")) {  // needs testing
-            char* temp = getXmlAttrValue(attr);
+    while (xmlTextReaderMoveToNextAttribute(reader) == 1) {
+        if (readerAttrEqual(reader, "x"))
+            x = (float)strtodCheck(h, getReaderAttrValue(reader), false, NULL);
+        else if (readerAttrEqual(reader, "y"))
+            y = (float)strtodCheck(h, getReaderAttrValue(reader), false, NULL);
+        else if (readerAttrEqual(reader, "name")) {  // needs testing
+            char* temp = getReaderAttrValue(reader);
             pointName = copyStr(h, temp);
-        } else if (xmlAttrEqual(attr, "type")) {
-            char* strType = getXmlAttrValue(attr);
+        } else if (readerAttrEqual(reader, "type")) {
+            char* strType = getReaderAttrValue(reader);
             if (strEqual(strType, "move"))
                 type = 1;
             else if (strEqual(strType, "line"))
@@ -2501,14 +3167,23 @@ static int parseXMLPoint(ufoCtx h, xmlNodePtr cur, abfGlyphCallbacks* glyph_cb,
             else if (strEqual(strType, "curve"))
                 type = 3;
             else if (strEqual(strType, "offcurve"))
-                continue;  // type is already set to 0. x and y will get pushed on the stack, and no other operation will happen.
+                type = 0;  // x and y will get pushed on the stack, and no other operation will happen.
             else {
                 fatal(h, ufoErrParse, "Encountered unsupported point type '%s' in glyph '%s'.\n", strType, glifRec->glyphName);
                 result = ufoErrParse;
                 break;
             }
         }
-        attr = attr->next;
+    }
+    {
+        GlifEvent* ev = newGlifEvent(h, glifEvtPoint);
+        if (ev != NULL) {
+            ev->pointType = type;
+            ev->x = x;
+            ev->y = y;
+            if (pointName != NULL)
+                ev->pointName = copyStr(h, pointName);
+        }
     }
     result = setPointKeyValue(h, glyph_cb, x, y, type, pointName);
     return result;
@@ -2541,25 +3216,23 @@ static int setParseXMLComponentValue(ufoCtx h, abfGlyphInfo* gi, abfGlyphCallbac
             concatTransform.isDefault = 0;
         }
     }
+    /* The component is read on the next nesting level's reader, while this
+       glyph's reader is left where it is. */
+    h->glif.depth++;
     result = parseGLIF(h, gi, glyph_cb, newTransform);
-    h->cb.stm.seek(&h->cb.stm, h->stm.src, 0);
-    fillbuf(h, 0);
+    h->glif.depth--;
     h->stack.flags &= ~PARSE_END;
     return result;
 }
 
-static int parseXMLContour(ufoCtx h, xmlNodePtr cur, GLIF_Rec* glifRec, abfGlyphCallbacks* glyph_cb){
-    long contourStartOpIndex = h->data.opList.cnt;
+static void beginXMLContour(ufoCtx h) {
     h->stack.flags |= PARSE_PATH;
     h->stack.flags &= ~((unsigned long)PARSE_SEEN_MOVETO);
-    xmlNodePtr curChild = cur->xmlChildrenNode;
+}
+
+/* Called at </contour>, after the contour's points have been parsed */
+static int endXMLContour(ufoCtx h, long contourStartOpIndex, abfGlyphCallbacks* glyph_cb) {
     int result = ufoSuccess;
-    while (curChild != NULL){
-        if (xmlKeyEqual(curChild, "point")){
-            result = parseXMLPoint(h, curChild, glyph_cb, glifRec, 2);
-        }
-        curChild = curChild->next;
-    }
     if (h->data.opList.cnt > 1) {
         OpRec* firstOpRec = &h->data.opList.array[contourStartOpIndex];
         /* Now we need to fix up the OpList. In GLIF, there is usually no explicit start point, as the format expresses
@@ -2594,7 +3267,7 @@ static int parseXMLContour(ufoCtx h, xmlNodePtr cur, GLIF_Rec* glifRec, abfGlyph
 }
 
 
-static int parseXMLComponent(ufoCtx h, xmlNodePtr cur, GLIF_Rec* glifRec, abfGlyphCallbacks* glyph_cb) {
+static int parseXMLComponent(ufoCtx h, xmlTextReaderPtr reader, GLIF_Rec* glifRec, abfGlyphCallbacks* glyph_cb) {
     Transform* transform = h->parseState.GLIFInfo.transform;
     int result = ufoSuccess;
     abfGlyphInfo* gi = NULL;
@@ -2604,32 +3277,37 @@ static int parseXMLComponent(ufoCtx h, xmlNodePtr cur, GLIF_Rec* glifRec, abfGly
 
     setTransformMtx(&localTransform, 1.0, 0, 0, 1.0, 0, 0, 1, 1);
 
-    xmlAttr *attr = cur->properties;
-    while (attr != NULL) {
-        if (xmlAttrEqual(attr, "base")){
+    while (xmlTextReaderMoveToNextAttribute(reader) == 1) {
+        if (readerAttrEqual(reader, "base")){
             size_t index;
-            char* glyphName = getXmlAttrValue(attr);
+            char* glyphName = getReaderAttrValue(reader);
             if (!ctuLookup(glyphName, h->chars.byName.array, h->chars.byName.cnt,
                            sizeof(h->chars.byName.array[0]), postMatchChar, &index, h)) {
                 fatal(h,  ufoErrNoGlyph, "Encountered glyph component reference '%s' with an empty file path.", glifRec->glifFilePath);
             }
             gi = &h->chars.index.array[h->chars.byName.array[index]];
         } else {
-            val = (float)atof(getXmlAttrValue(attr));
-            if (xmlAttrEqual(attr, "xScale"))
+            val = (float)atof(getReaderAttrValue(reader));
+            if (readerAttrEqual(reader, "xScale"))
                 setTransformValue(&localTransform, val, 0);
-            else if (xmlAttrEqual(attr, "yScale"))
+            else if (readerAttrEqual(reader, "yScale"))
                 setTransformValue(&localTransform, val, 3);
-            else if (xmlAttrEqual(attr, "xyScale"))
+            else if (readerAttrEqual(reader, "xyScale"))
                 setTransformValue(&localTransform, val, 1);
-            else if (xmlAttrEqual(attr, "yxScale"))
+            else if (readerAttrEqual(reader, "yxScale"))
                 setTransformValue(&localTransform, val, 2);
-            else if (xmlAttrEqual(attr, "xOffset"))
+            else if (readerAttrEqual(reader, "xOffset"))
                 setTransformValue(&localTransform, val, 4);
-            else if (xmlAttrEqual(attr, "yOffset"))
+            else if (readerAttrEqual(reader, "yOffset"))
                 setTransformValue(&localTransform, val, 5);
         }
-        attr = attr->next;
+    }
+    if (gi != NULL) {
+        GlifEvent* ev = newGlifEvent(h, glifEvtComponent);
+        if (ev != NULL) {
+            ev->base = gi - h->chars.index.array;
+            ev->transform = localTransform;
+        }
     }
     result = setParseXMLComponentValue(h, gi, glyph_cb, glifRec, transform, localTransform, newTransform, result);
     return result;
@@ -3027,14 +3705,49 @@ static void skipData(ufoCtx h, GLIF_Rec* glifRec) {
     } while (!(h->stack.flags & PARSE_END));
 }
 
+/* Send a component glyph's recorded outline events as if its glif file had
+   been read again. */
+static void replayGLIF(ufoCtx h, long iChar, GLIF_Rec* glifRec, abfGlyphCallbacks* glyph_cb) {
+    GlifCacheRec rec = h->glif.cache.glyphs.array[iChar];
+    long contourStartOpIndex = -1;
+    long i;
+
+    for (i = rec.first; i < rec.first + rec.cnt; i++) {
+        /* Nested replays can add events and move the array; index each time */
+        GlifEvent* ev = &h->glif.cache.events.array[i];
+        switch (ev->type) {
+            case glifEvtContourBeg:
+                contourStartOpIndex = h->data.opList.cnt;
+                beginXMLContour(h);
+                break;
+            case glifEvtContourEnd:
+                endXMLContour(h, contourStartOpIndex, glyph_cb);
+                contourStartOpIndex = -1;
+                break;
+            case glifEvtPoint:
+                setPointKeyValue(h, glyph_cb, ev->x, ev->y, ev->pointType,
+                                 ev->pointName != NULL ? copyStr(h, ev->pointName) : NULL);
+                break;
+            case glifEvtComponent: {
+                Transform localTransform = ev->transform;
+                abfGlyphInfo* base = &h->chars.index.array[ev->base];
+                setParseXMLComponentValue(h, base, glyph_cb, glifRec, h->parseState.GLIFInfo.transform,
+                                          localTransform, NULL, ufoSuccess);
+                break;
+            }
+        }
+    }
+}
+
 static int parseGLIF(ufoCtx h, abfGlyphInfo* gi, abfGlyphCallbacks* glyph_cb, Transform* transform) {
     /* The first point in a GLIF outline serves two purposes: it is the start point, but also the end-point.
      We need to convert it to the initial move-to, but we also need to
      re-issue it as the original point type at the end of the path.
      */
     Transform *currentTransform;
+    void* currentSrc = h->stm.src;
+    GLIF_Rec* currentGlifRec = h->parseState.GLIFInfo.glifRec;
 
-    const char* filetype = "glyph";
     h->parseState.UFOFile = parsingGLIF;
     currentTransform = h->parseState.GLIFInfo.transform;
     h->parseState.GLIFInfo.transform = transform;
@@ -3045,8 +3758,22 @@ static int parseGLIF(ufoCtx h, abfGlyphInfo* gi, abfGlyphCallbacks* glyph_cb, Tr
 
     STI sti = (STI)gi->tag;
     GLIF_Rec* glifRec = &h->data.glifRecs.array[sti];
+    long iChar = gi - h->chars.index.array;
     h->parseState.GLIFInfo.glifRec = glifRec;
 
+    /* Replay the outline if already decoded */
+    growGlifCache(h);
+    if (h->glif.cache.glyphs.array[iChar].state == glifCacheDone) {
+        h->stack.cnt = 0;
+        h->stack.hintflags = 0;
+        h->stack.flags = 0;
+        h->hints.pointName = NULL;
+        replayGLIF(h, iChar, glifRec, glyph_cb);
+        h->parseState.GLIFInfo.glifRec = currentGlifRec;
+        h->parseState.GLIFInfo.transform = currentTransform;
+        return result;
+    }
+
     /* open the file */
     h->src.next = h->mark = NULL;
     h->flags &= ~((unsigned long)SEEN_END);
@@ -3063,11 +3790,29 @@ static int parseGLIF(ufoCtx h, abfGlyphInfo* gi, abfGlyphCallbacks* glyph_cb, Tr
     h->stack.flags = 0;
     h->hints.pointName = NULL;
 
-    xmlNodePtr cur = parseXMLFile(h, h->cb.stm.clientFileName, filetype);
-    int parsingSuccess = parseXMLGlifFile(h, cur, gi->tag, NULL, glyph_cb, glifRec);
+    result = parseXMLGlifFile(h, gi->tag, NULL, glyph_cb, glifRec);
+
+    if (h->glif.depth > 0 || h->glif.disk.active) {
+        /* Keep the decoded outline for later references */
+        GlifInput* in = h->glif.inputs.array[h->glif.depth];
+        GlifCacheRec* rec = &h->glif.cache.glyphs.array[iChar];
+        if (in->record) {
+            rec->state = glifCacheDone;
+            rec->first = h->glif.cache.events.cnt;
+            rec->cnt = in->events.cnt;
+            memcpy(dnaEXTEND(h->glif.cache.events, in->events.cnt),
+                   in->events.array, in->events.cnt * sizeof(GlifEvent));
+            in->events.cnt = 0;  /* point names now owned by the cache */
+            h->glif.disk.dirty = h->glif.disk.active;
+        } else {
+            rec->state = glifCacheNone;
+            freeGlifEvents(h, in);
+        }
+    }
 
-    /* An odd exit - didn't see  "</glyph>"  */
     h->cb.stm.close(&h->cb.stm, h->stm.src);
+    h->stm.src = currentSrc;
+    h->parseState.GLIFInfo.glifRec = currentGlifRec;
     h->parseState.GLIFInfo.transform = currentTransform;
     return result;
 }
@@ -3286,6 +4031,11 @@ int ufoBegFont(ufoCtx h, long flags, abfTopDict** top, char* altLayerDir) {
     h->chars.index.cnt = 0;
     h->data.glifRecs.cnt = 0;
     h->data.opList.cnt = 0;
+    h->glif.depth = 0;
+    freeGlifCache(h);
+    h->glif.disk.active = (flags & UFO_USE_CACHE) != 0;
+    h->glif.disk.dirty = false;
+    h->glif.disk.files.cnt = 0;
     h->hints.hintMasks.cnt = 0;
 
     h->aggregatebounds.left = FLT_MAX;
@@ -3302,6 +4052,9 @@ int ufoBegFont(ufoCtx h, long flags, abfTopDict** top, char* altLayerDir) {
 
     dnaGROW(h->valueArray, 14);
 
+    if (h->glif.disk.active)
+        readGlifCacheFile(h);
+
     result = parseUFO(h);
     if (result)
         fatal(h, result, NULL);
@@ -3330,6 +4083,17 @@ int ufoBegFont(ufoCtx h, long flags, abfTopDict** top, char* altLayerDir) {
 int ufoEndFont(ufoCtx h) {
     if (h->stm.src)
         h->cb.stm.close(&h->cb.stm, h->stm.src);
+
+    if (h->glif.disk.dirty) {
+        /* Set error handler */
+        DURING_EX(h->err.env)
+
+        writeGlifCacheFile(h);
+
+        HANDLER
+        return Exception.Code;
+        END_HANDLER
+    }
     return ufoSuccess;
 }
 
@@ -48,6 +48,8 @@ typedef struct
     char *pointName;
 } OpRec;
 
+typedef dnaDCL(char, OutBuf); /* Whole-file output buffer */
+
 struct ufwCtx_ {
     int state;             /* 0 == writing to tmp; 1 == writing to dst */
     abfTopDict *top;       /* Top Dict data */
@@ -58,16 +60,8 @@ struct ufwCtx_ {
         long flags; /* See ufowrite.h for flags */
         char *glyphLayer;
     } arg;
-    struct /* Destination stream */
-    {
-        char buf[BUFSIZ];
-        size_t cnt; /* Bytes in buf */
-    } dst;
-    struct /* Temporary stream */
-    {
-        char buf[BUFSIZ];
-        size_t cnt; /* Bytes in buf */
-    } tmp;
+    OutBuf dst;            /* Destination stream buffer */
+    OutBuf tmp;            /* Temporary stream buffer */
     struct /* Glyph path */
     {
         float x;
@@ -109,114 +103,55 @@ static void fatal(ufwCtx h, int err_code) {
 
 /* --------------------------- Destination Stream -------------------------- */
 
-/* Flush dst/tmp stream buffer. */
+/* Flush dst/tmp stream buffer. Each file is accumulated in memory and handed
+   to the client in a single write call when it is complete. */
 static void flushBuf(ufwCtx h) {
     void *stm;
-    char *buf;
-    size_t *cnt;
+    OutBuf *buf;
     int err;
     if (h->state == 0) {
         stm = h->stm.tmp;
-        buf = h->tmp.buf;
-        cnt = &h->tmp.cnt;
+        buf = &h->tmp;
         err = ufwErrTmpStream;
     } else /* h->state == 1 */
     {
         stm = h->stm.dst;
-        buf = h->dst.buf;
-        cnt = &h->dst.cnt;
+        buf = &h->dst;
         err = ufwErrDstStream;
     }
 
-    if (*cnt == 0)
+    if (buf->cnt == 0)
         return; /* Nothing to do */
 
     DURING_EX(h->err.env)
 
     /* Write buffered bytes */
-    if (h->cb.stm.write(&h->cb.stm, stm, *cnt, buf) != *cnt)
+    if (h->cb.stm.write(&h->cb.stm, stm, buf->cnt, buf->array) != (size_t)buf->cnt)
         fatal(h, err);
 
     HANDLER
     END_HANDLER
 
-    *cnt = 0;
+    buf->cnt = 0;
+}
+
+/* Reserve writeCnt bytes at the end of the dst/tmp stream buffer and return
+   their address. */
+static char *extendBuf(ufwCtx h, size_t writeCnt) {
+    OutBuf *buf = (h->state == 0) ? &h->tmp : &h->dst;
+    return dnaEXTEND(*buf, (long)writeCnt);
 }
 
 /* Write to dst/tmp stream buffer. */
 static void writeBuf(ufwCtx h, size_t writeCnt, const char *ptr) {
-    char *buf;
-    size_t *cnt;
-    size_t left;
-    if (h->state == 0) {
-        buf = h->tmp.buf;
-        cnt = &h->tmp.cnt;
-    } else /* h->state == 1 */
-    {
-        buf = h->dst.buf;
-        cnt = &h->dst.cnt;
-    }
-
-    left = BUFSIZ - *cnt; /* Bytes left in buffer */
-    while (writeCnt >= left) {
-        memcpy(&buf[*cnt], ptr, left);
-        *cnt += left;
-        flushBuf(h);
-        ptr += left;
-        writeCnt -= left;
-        left = BUFSIZ;
-    }
-    if (writeCnt > 0) {
-        memcpy(&buf[*cnt], ptr, writeCnt);
-        *cnt += writeCnt;
-    }
+    if (writeCnt > 0)
+        memcpy(extendBuf(h, writeCnt), ptr, writeCnt);
 }
 
 /* Write integer value as ASCII to dst stream. */
 static void writeInt(ufwCtx h, long value) {
-    char buf[50];
-    sprintf(buf, "%ld", value);
-    writeBuf(h, strlen(buf), buf);
-}
-
-/* Convert a long into a string */
-static void ufw_ltoa(char *buf, long val) {
-    static char ascii_digit[] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9'};
-    char *position = buf;
-    char *start = buf;
-
-    int isneg = val < 0;
-    if (isneg)
-        val = -val;
-
-    /* extract char's */
-    do {
-        int digit;
-        digit = val % 10;
-        val /= 10;
-        *position = ascii_digit[digit];
-        position++;
-    } while (val);
-
-    /* store sign */
-    if (isneg) {
-        *position = '-';
-        position++;
-    }
-
-    /* terminate */
-    *position = '\0';
-    position--;
-
-    /* reverse string */
-    while (start < position) {
-        char tmp;
-        tmp = *position;
-        *position = *start;
-        *start = tmp;
-        position--;
-        start++;
-    }
+    char buf[24];
+    writeBuf(h, ctuLtostr(buf, value), buf);
 }
 
 /* Write real number in ASCII to dst stream. */
@@ -226,10 +161,9 @@ static void writeReal(ufwCtx h, float value) {
     char buf[50];
     /* if no decimal component, perform a faster to string conversion */
     if ((fabs(value - roundf(value)) < TX_EPSILON) && value > LONG_MIN && value < LONG_MAX)
-        ufw_ltoa(buf, (long)roundf(value));
+        writeBuf(h, ctuLtostr(buf, (long)roundf(value)), buf);
     else
-        ctuDtostr(buf, sizeof(buf), value, 0, 2);
-    writeBuf(h, strlen(buf), buf);
+        writeBuf(h, ctuFtostr(buf, sizeof(buf), value, 2, 1), buf);
 }
 
 /* Write null-terminated string to dst steam. */
@@ -264,6 +198,8 @@ ufwCtx ufwNew(ctlMemoryCallbacks *mem_cb, ctlStreamCallbacks *stm_cb,
     h->top = NULL;
     h->glyphs.size = 0;
     h->path.opList.size = 0;
+    h->dst.size = 0;
+    h->tmp.size = 0;
 
     h->dna = NULL;
     h->stm.dst = NULL;
@@ -284,6 +220,8 @@ ufwCtx ufwNew(ctlMemoryCallbacks *mem_cb, ctlStreamCallbacks *stm_cb,
 
     dnaINIT(h->dna, h->glyphs, 256, 750);
     dnaINIT(h->dna, h->path.opList, 256, 750);
+    dnaINIT(h->dna, h->dst, 16384, 65536);
+    dnaINIT(h->dna, h->tmp, 16384, 65536);
 
     /* Open debug stream */
     h->stm.dbg = h->cb.stm.open(&h->cb.stm, UFW_DBG_STREAM_ID, 0);
@@ -308,6 +246,8 @@ void ufwFree(ufwCtx h) {
     }
     dnaFREE(h->glyphs);
     dnaFREE(h->path.opList);
+    dnaFREE(h->dst);
+    dnaFREE(h->tmp);
     dnaFree(h->dna);
 
     /* Free library context */
@@ -118,6 +118,7 @@ typedef struct
     Card16 CoverageFormat; /* =1 */
     Card16 GlyphCount;
     GlyphId *GlyphArray; /* [GlyphCount] */
+    void *_Index;        /* Lookup accelerator, built on first query */
 } CoverageFormat1;
 
 typedef struct
@@ -132,6 +133,7 @@ typedef struct
     Card16 CoverageFormat; /* =2 */
     Card16 RangeCount;
     RangeRecord *RangeRecord; /* [RangeCount] */
+    void *_Index;             /* Lookup accelerator, built on first query */
 } CoverageFormat2;
 
 /* --- ClassDef --- */
@@ -3956,42 +3956,27 @@ void GSUBDump(IntX level, LongN start) {
 static void evalSingle(void *fmt,
                        IntX numinputglyphs, GlyphId *inputglyphs,
                        IntX *numoutputglyphs, GlyphId *outputglyphs) {
-    SingleSubstFormat1 *fmt1;
-    SingleSubstFormat2 *fmt2;
-    ttoEnumRec CovList;
-    Card32 nitems = 0;
-    IntX i, at;
+    SingleSubstFormat1 *fmt1 = (SingleSubstFormat1 *)fmt;
+    SingleSubstFormat2 *fmt2 = (SingleSubstFormat2 *)fmt;
+    IntX at = (-1);
     GlyphId inputglyphId;
     IntX formattype = ((SingleSubstFormat1 *)fmt)->SubstFormat;
 
-    memset((void*)&CovList, 0, sizeof(CovList));
-
     if (numinputglyphs > 1) {
         warning(SPOT_MSG_GSUBEVALCNT);
         goto foo;
     }
 
+    /* find the position of the input glyph in the Coverage list */
+    inputglyphId = inputglyphs[0];
     switch (formattype) {
         case 1:
-            fmt1 = (SingleSubstFormat1 *)fmt;
-            ttoEnumerateCoverage(fmt1->Coverage, fmt1->_Coverage, &CovList, &nitems);
+            ttoGlyphIsInCoverage(fmt1->Coverage, fmt1->_Coverage, inputglyphId, &at);
             break;
         case 2:
-            fmt2 = (SingleSubstFormat2 *)fmt;
-            ttoEnumerateCoverage(fmt2->Coverage, fmt2->_Coverage, &CovList, &nitems);
-            break;
-    }
-    /* find the position of the input glyph in the Coverage list */
-    at = (-1);
-    inputglyphId = inputglyphs[0];
-    for (i = 0; i < (IntX)nitems; i++) {
-        if (inputglyphId == *da_INDEX(CovList.glyphidlist, i)) {
-            at = i;
+            ttoGlyphIsInCoverage(fmt2->Coverage, fmt2->_Coverage, inputglyphId, &at);
             break;
-        }
     }
-    if (CovList.glyphidlist.size > 0)
-        da_FREE(CovList.glyphidlist);
     if (at < 0) {
         warning(SPOT_MSG_GSUBNOCOVG, inputglyphId, getGlyphName(inputglyphId, 0));
         goto foo;
@@ -4017,8 +4002,6 @@ foo:
 static void evalMultiple(MultipleSubstFormat1 *fmt,
                          IntX numinputglyphs, GlyphId *inputglyphs,
                          IntX *numoutputglyphs, GlyphId *outputglyphs) {
-    ttoEnumRec CovList;
-    Card32 nitems;
     IntX i, at;
     GlyphId inputglyphId;
 
@@ -4027,19 +4010,9 @@ static void evalMultiple(MultipleSubstFormat1 *fmt,
         goto foo;
     }
 
-    ttoEnumerateCoverage(fmt->Coverage, fmt->_Coverage, &CovList, &nitems);
     /* find the position of the input glyph in the Coverage list */
-    at = (-1);
     inputglyphId = inputglyphs[0];
-    for (i = 0; i < (IntX)nitems; i++) {
-        if (inputglyphId == *da_INDEX(CovList.glyphidlist, i)) {
-            at = i;
-            break;
-        }
-    }
-    if (CovList.glyphidlist.size > 0)
-        da_FREE(CovList.glyphidlist);
-    if (at < 0) {
+    if (!ttoGlyphIsInCoverage(fmt->Coverage, fmt->_Coverage, inputglyphId, &at)) {
         warning(SPOT_MSG_GSUBNOCOVG, inputglyphId, getGlyphName(inputglyphId, 0));
         goto foo;
     }
@@ -4129,38 +4102,23 @@ static void evalLigature(void *fmt,
                          IntX numinputglyphs, GlyphId *inputglyphs,
                          IntX *numoutputglyphs, GlyphId *outputglyphs) {
     LigatureSubstFormat1 *fmt1;
-    ttoEnumRec CovList;
-    Card32 nitems;
     IntX i, at, inputcount;
     GlyphId inputglyphId, glyphId2;
     IntX ligId;
     IntX formattype = ((LigatureSubstFormat1 *)fmt)->SubstFormat;
     LigatureSet *ligatureSet;
 
-    switch (formattype) {
-        case 1:
-            fmt1 = (LigatureSubstFormat1 *)fmt;
-            ttoEnumerateCoverage(fmt1->Coverage, fmt1->_Coverage, &CovList, &nitems);
-            break;
-        default:
-            goto foo;
-            break;
-    }
-    /* find the positions of the input glyphs in the Coverage list */
-    inputcount = 0;
-    at = (-1);
-    inputglyphId = inputglyphs[inputcount];
-    for (i = 0; i < (IntX)nitems; i++) {
-        if (inputglyphId == *da_INDEX(CovList.glyphidlist, i)) {
-            at = i;
-            inputcount++;
-            break;
-        }
-    }
-    if (at < 0) {
+    if (formattype != 1)
+        goto foo;
+    fmt1 = (LigatureSubstFormat1 *)fmt;
+
+    /* find the position of the first input glyph in the Coverage list */
+    inputglyphId = inputglyphs[0];
+    if (!ttoGlyphIsInCoverage(fmt1->Coverage, fmt1->_Coverage, inputglyphId, &at)) {
         warning(SPOT_MSG_GSUBNOCOVG, inputglyphId, getGlyphName(inputglyphId, 0));
         goto foo;
     }
+    inputcount = 1;
 
     ligatureSet = &fmt1->_LigatureSet[at];
     ligId = (-1);
@@ -4187,8 +4145,6 @@ static void evalLigature(void *fmt,
     if (ligId < 0)
         goto foo;
 
-    if (CovList.glyphidlist.size > 0)
-        da_FREE(CovList.glyphidlist);
     outputglyphs[0] = ligId;
     *numoutputglyphs = 1;
     return;
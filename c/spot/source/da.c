@@ -54,9 +54,15 @@ void da_Grow(void *object, size_t element, unsigned long index) {
     da->size = newSize;
 }
 
-/* Free dynamic array */
+/* Free dynamic array and leave it empty, so that freeing it again is
+   harmless */
 void da_Free(void *object) {
-    dealloc(((DA *)object)->array);
+    DA *da = object;
+
+    dealloc(da->array);
+    da->array = NULL;
+    da->cnt = 0;
+    da->size = 0;
 }
 
 /* Initialize memory management functions */
@@ -10,9 +10,15 @@
  * This code assumes that 32 bits is large enough to hold a file offset. This
  * seems a safe assumption since other code would break long before
  * fonts/resource files reached this size. 
+ *
+ * The table readers seek constantly, so a regular file is read into memory
+ * in one go when it is opened and all seeks and reads are then served from
+ * that image. Mac resource files, and files larger than MAX_IMAGE_LENGTH or
+ * that can't be loaded, are still read through the buffer.
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #if USE_STDARG
 #include <stdarg.h>
 #endif
@@ -28,12 +34,49 @@ static struct
     Card8 buf[BUFSIZ]; /* Input buffer */
     Card8 *next;       /* Next character to read */
     Card8 *end;        /* One past end of filled buffer */
+    Card8 *image;      /* Whole file data; NULL if reading through buf */
+    Card32 length;     /* Length of image */
 } file = {(-1), NULL};
 
 #if MACINTOSH
 static Byte8 gMacfilename[256] = {0};
 #endif
 
+/* Largest file read into memory; bigger files are read through buf */
+#define MAX_IMAGE_LENGTH (64L * 1024 * 1024)
+
+/* Read the whole of the open file into memory. If the file is too large, the
+   allocation fails, or the file can't be read in full, the image is dropped
+   and reads go through the buffer as before. */
+static void loadImage(void) {
+    Int32 length = sysFileLen(file.id);
+    Int32 count = 0;
+
+    if (length < 0)
+        return;
+    sysSeek(file.id, 0, 0, file.name); /* Undo sysFileLen's seek to the end */
+    if (length == 0 || length > MAX_IMAGE_LENGTH)
+        return;
+    file.image = malloc(length);
+    if (file.image == NULL)
+        return;
+    while (count < length) {
+        IntX n = sysRead(file.id, file.image + count, length - count, file.name);
+        if (n <= 0)
+            break;
+        count += n;
+    }
+    if (count < length) {
+        memFree(file.image);
+        file.image = NULL;
+        sysSeek(file.id, 0, 0, file.name);
+        return;
+    }
+    file.length = count;
+    file.next = file.image;
+    file.end = file.image + file.length;
+}
+
 IntX fileExists(Byte8 *filename) {
     return (sysFileExists(filename));
 }
@@ -62,6 +105,8 @@ void fileOpen(Byte8 *filename) {
         file.id = sysOpenSearchpath(filename);
         file.name = filename;
         file.end = file.next = file.buf;
+        if (file.id > 0)
+            loadImage();
     }
 }
 
@@ -82,6 +127,11 @@ IntX fileIsOpened(void) {
 void fileClose(void) {
     if (file.id > 0)
         sysClose(file.id, file.name);
+    if (file.image != NULL) {
+        memFree(file.image);
+        file.image = NULL;
+        file.length = 0;
+    }
     file.id = (-1);
     /* don't mess with the name field */
     file.next = NULL;
@@ -90,13 +140,24 @@ void fileClose(void) {
 
 /* Return file position */
 Card32 fileTell(void) {
+    if (file.image != NULL)
+        return file.next - file.image;
     return sysTell(file.id, file.name) - (file.end - file.next);
 }
 
 /* Seek to absolute or relative offset */
 void fileSeek(Card32 offset, int relative) {
-    Card32 at = sysTell(file.id, file.name);
-    Card32 to = relative ? at + offset : offset;
+    Card32 at;
+    Card32 to;
+
+    if (file.image != NULL) {
+        to = relative ? (Card32)(file.next - file.image) + offset : offset;
+        file.next = (to < file.length) ? file.image + to : file.end;
+        return;
+    }
+
+    at = sysTell(file.id, file.name);
+    to = relative ? at + offset : offset;
 
 #if OLD
     if (to >= at - (file.end - file.buf) && to < at)
@@ -125,7 +186,10 @@ void fileSeekAbsNotBuffered(Card32 offset) {
 
 /* Fill buffer */
 static void fillBuf(void) {
-    IntX count = sysRead(file.id, file.buf, BUFSIZ, file.name);
+    IntX count;
+    if (file.image != NULL)
+        fatal(SPOT_MSG_EARLYEOF, file.name); /* Read past end of image */
+    count = sysRead(file.id, file.buf, BUFSIZ, file.name);
     if (count == 0)
         fatal(SPOT_MSG_EARLYEOF, file.name);
     file.end = file.buf + count;
@@ -274,6 +338,18 @@ Byte8 *fileName(void) {
 Card32 fileSniff(void) {
     IntX count = 0;
     Card32 value;
+
+    if (file.image != NULL) {
+        file.next = file.image;
+        if (file.length < 4)
+            return 0xBADBAD;
+        value = *file.next++;
+        value = value << 8 | *file.next++;
+        value = value << 8 | *file.next++;
+        value = value << 8 | *file.next++;
+        return value;
+    }
+
     count = sysRead(file.id, file.buf, 4, file.name);
     file.end = file.buf + 4;
     if (count == 0)
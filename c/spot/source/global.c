@@ -42,6 +42,8 @@ void fatal(IntX msgfmtID, ...) {
     vfprintf(stderr, fmt, ap);
     va_end(ap);
     /* longjmp(mark, -1); */
+    if (global.recover)
+        longjmp(global.env, 1); /* Abandon this font and go on to the next */
     exit(1);
 }
 
@@ -22,6 +22,7 @@ typedef struct _Global {
     jmp_buf env; /* Termination environment */
     char *progname;
     volatile int doingScripting;
+    volatile int recover; /* fatal() returns to env instead of exiting */
     unsigned long gTag;
     unsigned long flags;
 } Global;
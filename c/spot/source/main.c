@@ -169,6 +169,16 @@ static int readFile(char *filename) {
     return 0;
 }
 
+/* Release a font abandoned by fatal() during a multi-font run. Errors during
+   the cleanup itself are not recoverable. */
+static void abandonFont(char *filename) {
+    global.recover = 0;
+    warning(SPOT_MSG_FONTFAILED, filename);
+    sfntFree(1);
+    fileClose();
+    global.recover = 1;
+}
+
 /* Print usage information */
 static void printUsage(void) {
     fprintf(OUTPUTBUFF,
@@ -1080,9 +1090,11 @@ IntN main(IntN argc, Byte8 *argv[]) {
         {"-of", opt_String, &outputfilebase},
     };
 
-    IntX files, goodFileCount = 0;
-    IntN argi;
-    Byte8 *filename = NULL;
+    IntX files;
+    volatile IntX goodFileCount = 0;
+    volatile IntX failedFileCount = 0;
+    volatile IntN argi;
+    Byte8 *volatile filename = NULL;
     volatile IntX i = 0;
 #if AUTOSCRIPT
     cmdlinetype *cmdl;
@@ -1156,6 +1168,10 @@ IntN main(IntN argc, Byte8 *argv[]) {
 
         files = argc - argi;
 
+        /* When dumping several fonts, a fatal error abandons only the font
+           that caused it */
+        global.recover = files > 1;
+
         for (; argi < argc; argi++) {
             filename = argv[argi];
 
@@ -1164,6 +1180,12 @@ IntN main(IntN argc, Byte8 *argv[]) {
                 fflush(stderr);
             }
 
+            if (setjmp(global.env)) {
+                abandonFont(filename);
+                failedFileCount++;
+                continue;
+            }
+
             if (outputfilebase == NULL)
                 outputfilebase = filename;
             fileOpen(filename);
@@ -1204,12 +1226,20 @@ IntN main(IntN argc, Byte8 *argv[]) {
         }
     }
 
+        global.recover = 1;
+
         for (i = 0; i < script.cmdline.cnt; i++) {
             char *tempfilename;
 
             cmdl = da_INDEX(script.cmdline, i);
             if (cmdl->args.cnt < 2) continue;
 
+            if (setjmp(global.env)) {
+                abandonFont(filename != NULL ? filename : "");
+                failedFileCount++;
+                continue;
+            }
+
             proofResetPolicies();
 
             {
@@ -1277,7 +1307,7 @@ IntN main(IntN argc, Byte8 *argv[]) {
 #endif /* AUTOSCRIPT */
 
     /* fprintf(stderr, "\nDone.\n"); */
-    if (goodFileCount <= 0)
+    if (goodFileCount <= 0 || failedFileCount > 0)
         exit(1);
 
     quit(0);
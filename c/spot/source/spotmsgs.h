@@ -112,6 +112,7 @@ extern const Byte8 *spotMsg(IntX msgId);
 #define SPOT_MSG_CNTX_RECURSION     102
 #define SPOT_MSG_DUP_IN_COV         103
 #define SPOT_MSG_GSUBMULTIPLEINPUTS 104
+#define SPOT_MSG_FONTFAILED         105
 
-#define SPOT_MSG_ENDSENTINEL SPOT_MSG_GSUBMULTIPLEINPUTS
+#define SPOT_MSG_ENDSENTINEL SPOT_MSG_FONTFAILED
 #endif
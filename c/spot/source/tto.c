@@ -1020,9 +1020,97 @@ void ttoEnumerateCoverage(Offset offset, void *coverage,
     }
 }
 
+/* Coverage lookup accelerator. Shaping simulation asks the same coverages
+   about many glyphs, most of which are not covered, so a membership bitset
+   rejects those without a scan. Well-formed (ascending) coverages are then
+   binary searched; anything else falls back to the original linear scan so
+   that malformed fonts report exactly what they did before. */
+typedef struct {
+    GlyphId first;  /* Lowest covered glyph */
+    GlyphId last;   /* Highest covered glyph */
+    Card8 *bits;    /* [last - first + 1 bits] Membership */
+    IntX sorted;    /* Flags entries strictly ascending and non-overlapping */
+    IntX *base;     /* [RangeCount] Format 2 coverage index of range starts */
+} CoverageIndex;
+
+#define COV_BIT(x, gid)   ((x)->bits[((gid) - (x)->first) >> 3])
+#define COV_MASK(x, gid)  (1 << (((gid) - (x)->first) & 7))
+
+static CoverageIndex *makeCoverageIndex(void *coverage) {
+    CoverageIndex *x = memNew(sizeof(CoverageIndex));
+    Card16 format = ((CoverageFormat1 *)coverage)->CoverageFormat;
+    IntX i, n;
+    Card32 gid;
+
+    x->first = 65535;
+    x->last = 0;
+    x->sorted = 1;
+    if (format == 1) {
+        CoverageFormat1 *fmt1 = (CoverageFormat1 *)coverage;
+
+        for (i = 0; i < fmt1->GlyphCount; i++) {
+            GlyphId g = fmt1->GlyphArray[i];
+            if (g < x->first)
+                x->first = g;
+            if (g > x->last)
+                x->last = g;
+            if (i > 0 && g <= fmt1->GlyphArray[i - 1])
+                x->sorted = 0;
+        }
+        if (x->first > x->last)
+            return x; /* Empty */
+        x->bits = memNew((x->last - x->first) / 8 + 1);
+        for (i = 0; i < fmt1->GlyphCount; i++)
+            COV_BIT(x, fmt1->GlyphArray[i]) |= COV_MASK(x, fmt1->GlyphArray[i]);
+    } else {
+        CoverageFormat2 *fmt2 = (CoverageFormat2 *)coverage;
+
+        x->base = memNew(sizeof(x->base[0]) * (fmt2->RangeCount + 1));
+        n = 0;
+        for (i = 0; i < fmt2->RangeCount; i++) {
+            RangeRecord *rec = &fmt2->RangeRecord[i];
+            x->base[i] = n;
+            n += (rec->End - rec->Start) + 1;
+            if (rec->Start > rec->End) {
+                x->sorted = 0;
+                continue;
+            }
+            if (i > 0 && rec->Start <= fmt2->RangeRecord[i - 1].End)
+                x->sorted = 0;
+            if (rec->Start < x->first)
+                x->first = rec->Start;
+            if (rec->End > x->last)
+                x->last = rec->End;
+        }
+        if (x->first > x->last)
+            return x; /* Empty */
+        x->bits = memNew((x->last - x->first) / 8 + 1);
+        for (i = 0; i < fmt2->RangeCount; i++) {
+            RangeRecord *rec = &fmt2->RangeRecord[i];
+            for (gid = rec->Start; gid <= rec->End; gid++)
+                COV_BIT(x, gid) |= COV_MASK(x, gid);
+        }
+    }
+    return x;
+}
+
+static void freeCoverageIndex(void *index) {
+    CoverageIndex *x = (CoverageIndex *)index;
+
+    if (x == NULL)
+        return;
+    if (x->bits != NULL)
+        memFree(x->bits);
+    if (x->base != NULL)
+        memFree(x->base);
+    memFree(x);
+}
+
 IntX ttoGlyphIsInCoverage(Offset offset, void *coverage, GlyphId gid, IntX *where) {
     IntX i, n;
     Card16 format;
+    void **index;
+    CoverageIndex *x;
 
     if (((CoverageFormat1 *)coverage) == NULL) {
         *where = (-1);
@@ -1030,27 +1118,78 @@ IntX ttoGlyphIsInCoverage(Offset offset, void *coverage, GlyphId gid, IntX *wher
     }
 
     format = ((CoverageFormat1 *)coverage)->CoverageFormat;
+    if (format == 1)
+        index = &((CoverageFormat1 *)coverage)->_Index;
+    else if (format == 2)
+        index = &((CoverageFormat2 *)coverage)->_Index;
+    else {
+        *where = (-1);
+        return 0;
+    }
+    if (*index == NULL)
+        *index = makeCoverageIndex(coverage);
+    x = (CoverageIndex *)*index;
+
+    if (x->bits == NULL || gid < x->first || gid > x->last ||
+        !(COV_BIT(x, gid) & COV_MASK(x, gid))) {
+        *where = (-1);
+        return 0;
+    }
+
     if (format == 1) {
         CoverageFormat1 *fmt1 = (CoverageFormat1 *)coverage;
 
-        for (i = 0; i < fmt1->GlyphCount; i++)
-            if (gid == fmt1->GlyphArray[i]) {
-                *where = i;
-                return 1;
+        if (x->sorted) {
+            IntX lo = 0;
+            IntX hi = fmt1->GlyphCount - 1;
+            while (lo <= hi) {
+                i = (lo + hi) / 2;
+                if (gid < fmt1->GlyphArray[i])
+                    hi = i - 1;
+                else if (gid > fmt1->GlyphArray[i])
+                    lo = i + 1;
+                else {
+                    *where = i;
+                    return 1;
+                }
             }
-    } else if (format == 2) {
+        } else {
+            for (i = 0; i < fmt1->GlyphCount; i++)
+                if (gid == fmt1->GlyphArray[i]) {
+                    *where = i;
+                    return 1;
+                }
+        }
+    } else {
         CoverageFormat2 *fmt2 = (CoverageFormat2 *)coverage;
         RangeRecord *rec;
 
-        n = 0;
-        for (i = 0; i < fmt2->RangeCount; i++) {
-            rec = &(fmt2->RangeRecord[i]);
-            if ((rec->Start <= gid) && (gid <= rec->End)) {
-                n += (gid - rec->Start);
-                *where = n;
-                return 1;
-            } else
-                n += (rec->End - rec->Start) + 1;
+        if (x->sorted) {
+            IntX lo = 0;
+            IntX hi = fmt2->RangeCount - 1;
+            while (lo <= hi) {
+                i = (lo + hi) / 2;
+                rec = &(fmt2->RangeRecord[i]);
+                if (gid < rec->Start)
+                    hi = i - 1;
+                else if (gid > rec->End)
+                    lo = i + 1;
+                else {
+                    *where = x->base[i] + (gid - rec->Start);
+                    return 1;
+                }
+            }
+        } else {
+            n = 0;
+            for (i = 0; i < fmt2->RangeCount; i++) {
+                rec = &(fmt2->RangeRecord[i]);
+                if ((rec->Start <= gid) && (gid <= rec->End)) {
+                    n += (gid - rec->Start);
+                    *where = n;
+                    return 1;
+                } else
+                    n += (rec->End - rec->Start) + 1;
+            }
         }
     }
 
@@ -1060,10 +1199,12 @@ IntX ttoGlyphIsInCoverage(Offset offset, void *coverage, GlyphId gid, IntX *wher
 
 static void freeCoverage1(CoverageFormat1 *fmt) {
     memFree(fmt->GlyphArray);
+    freeCoverageIndex(fmt->_Index);
 }
 
 static void freeCoverage2(CoverageFormat2 *fmt) {
     memFree(fmt->RangeRecord);
+    freeCoverageIndex(fmt->_Index);
 }
 
 void ttoFreeCoverage(void *coverage) {
@@ -3,6 +3,7 @@ This software is licensed as OpenSource, under the Apache License, Version 2.0.
 
 DCL_OPT("+E", opt__E)
 DCL_OPT("+F", opt__F)
+DCL_OPT("+K", opt__K)
 DCL_OPT("+O", opt__O)
 DCL_OPT("+S", opt__S)
 DCL_OPT("+T", opt__T)
@@ -22,6 +23,7 @@ DCL_OPT("-6", opt_6)
 DCL_OPT("-A", opt_A)
 DCL_OPT("-E", opt_E)
 DCL_OPT("-F", opt_F)
+DCL_OPT("-K", opt_K)
 DCL_OPT("-LWFN", opt_LWFN)
 DCL_OPT("-N", opt_N)
 DCL_OPT("-O", opt_O)
@@ -42,6 +44,7 @@ DCL_OPT("-b", opt_b)
 DCL_OPT("-bc", opt_bc)
 DCL_OPT("-c", opt_c)
 DCL_OPT("-cef", opt_cef)
+DCL_OPT("-cefpre", opt_cefpre)
 DCL_OPT("-cefsvg", opt_cefsvg)
 DCL_OPT("-cff", opt_cff)
 DCL_OPT("-cff2", opt_cff2)
@@ -58,6 +61,7 @@ DCL_OPT("-f", opt_f)
 DCL_OPT("-fd", opt_fd)
 DCL_OPT("-fdx", opt_fdx)
 DCL_OPT("-g", opt_g)
+DCL_OPT("-glifCache", opt_glifCache)
 DCL_OPT("-gn0", opt_gn0)
 DCL_OPT("-gn1", opt_gn1)
 DCL_OPT("-gn2", opt_gn2)
@@ -126,6 +126,48 @@ static void ufo_Help(txCtx h) {
 
 /* ---------------------------- cffread Library ---------------------------- */
 
+/* Read source font data for cffwrite. */
+static int cfrReadSubrSource(cfwSubrSource *src, long offset, size_t count,
+                             char *ptr) {
+    txCtx h = src->ctx;
+    return cfrReadSrc(h->cfr.ctx, offset, count, ptr);
+}
+
+/* Let cffwrite keep the source font's subrs (+K option). */
+static void cfrSetSubrSource(txCtx h) {
+    const cfrSingleRegions *regions = cfrGetSingleRegions(h->cfr.ctx);
+    cfwSubrSource src;
+    char major;
+    long i;
+
+    if (h->flags & (PATH_REMOVE_OVERLAP | PATH_SUPRESS_HINTS))
+        return; /* Glyph data won't match source charstrings */
+    if (cfrReadSrc(h->cfr.ctx, regions->Header.begin, 1, &major) || major != 1)
+        return; /* Not CFF (version 1) charstrings */
+    for (i = 0; i < h->top->FDArray.cnt; i++)
+        if (h->top->FDArray.array[i].FontMatrix.cnt != ABF_EMPTY_ARRAY)
+            return; /* Charstrings will be transformed */
+
+    dnaSET_CNT(h->cfw.FDArray, h->top->FDArray.cnt);
+    for (i = 0; i < h->top->FDArray.cnt; i++) {
+        cfwSubrSourceFD *fd = &h->cfw.FDArray.array[i];
+        fd->LocalSubrINDEX =
+            cfrGetRepeatRegions(h->cfr.ctx, i)->LocalSubrINDEX;
+        if (cfrGetWidths(h->cfr.ctx, i,
+                         &fd->defaultWidthX, &fd->nominalWidthX))
+            return;
+    }
+
+    src.ctx = h;
+    src.read = cfrReadSubrSource;
+    src.CharStringsINDEX = regions->CharStringsINDEX;
+    src.GlobalSubrINDEX = regions->GlobalSubrINDEX;
+    src.nFDs = h->cfw.FDArray.cnt;
+    src.FDArray = h->cfw.FDArray.array;
+    if (cfwSetSubrSource(h->cfw.ctx, &src))
+        fatal(h, NULL);
+}
+
 /* Read font with cffread library. */
 static void cfrReadFont(txCtx h, long origin, int ttcIndex) {
     float *uv;
@@ -148,6 +190,9 @@ static void cfrReadFont(txCtx h, long origin, int ttcIndex) {
 
     h->dst.begfont(h, h->top);
 
+    if (h->mode == mode_cff && (h->flags & KEEP_SUBRS))
+        cfrSetSubrSource(h);
+
     if (h->mode != mode_cef && h->mode != mode_dcf) {
         if (h->cfr.flags & CFR_NO_ENCODING)
             /* OTF font */
@@ -598,6 +643,11 @@ static void parseArgs(txCtx h, int argc, char *argv[]) {
                     goto wrongmode;
                 h->arg.cef.flags |= CEF_WRITE_SVG;
                 break;
+            case opt_cefpre: /* Undocumented; tests the cefembed prepared font */
+                if (h->mode != mode_cef)
+                    goto wrongmode;
+                h->arg.cef.prepared = 1;
+                break;
             case opt_pdf:
                 setMode(h, mode_pdf);
                 break;
@@ -621,6 +671,12 @@ static void parseArgs(txCtx h, int argc, char *argv[]) {
             case opt_altLayer:
                 h->ufr.altLayerDir = argv[++i];
                 break;
+            case opt_glifCache:
+                if (!argsleft)
+                    goto noarg;
+                h->ufr.cachePath = argv[++i];
+                h->ufr.flags |= UFO_USE_CACHE;
+                break;
             case opt_l:
                 switch (h->mode) {
                     case mode_t1:
@@ -811,6 +867,30 @@ static void parseArgs(txCtx h, int argc, char *argv[]) {
                     goto wrongmode;
                 h->cfw.flags &= ~CFW_NO_FAMILY_OPT;
                 break;
+            case opt__K:
+                switch (h->mode) {
+                    case mode_cff:
+                        h->flags |= KEEP_SUBRS;
+                        break;
+                    case mode_cef:
+                        h->arg.cef.flags |= CEF_KEEP_SUBRS;
+                        break;
+                    default:
+                        goto wrongmode;
+                }
+                break;
+            case opt_K:
+                switch (h->mode) {
+                    case mode_cff:
+                        h->flags &= ~KEEP_SUBRS;
+                        break;
+                    case mode_cef:
+                        h->arg.cef.flags &= ~CEF_KEEP_SUBRS;
+                        break;
+                    default:
+                        goto wrongmode;
+                }
+                break;
             case opt__O:
                 if (h->mode != mode_cff)
                     goto wrongmode;
@@ -914,6 +994,17 @@ static void parseArgs(txCtx h, int argc, char *argv[]) {
                     case mode_cff:
                         h->cfw.flags &= ~CFW_WARN_DUP_HINTSUBS;
                         break;
+                    case mode_svg:
+                        if (!argsleft)
+                            goto noarg;
+                        else {
+                            char *p;
+                            long precision = strtol(argv[++i], &p, 10);
+                            if (p == argv[i] || *p != '\0' || precision < 0 || precision > 4)
+                                goto badarg;
+                            h->svw.precision = (int)precision;
+                        }
+                        break;
                     default:
                         goto wrongmode;
                 }
@@ -1029,8 +1120,11 @@ static void parseArgs(txCtx h, int argc, char *argv[]) {
                 h->t1w.lenIV = 4;
                 h->t1w.options |= T1W_REFORMAT;
                 break;
-            case opt_z: /* bc mode options */
-                goto bc_gone;
+            case opt_z:
+                if (h->mode == mode_pdf)
+                    h->pdw.flags |= PDW_COMPRESS;
+                else
+                    goto bc_gone; /* bc mode option */
                 break;
             case opt_sha1:
                 goto bc_gone;
@@ -1044,6 +1138,9 @@ static void parseArgs(txCtx h, int argc, char *argv[]) {
                         h->t1w.flags &= ~T1W_ENCODE_MASK;
                         h->t1w.flags |= T1W_ENCODE_ASCII85;
                         break;
+                    case mode_svg:
+                        h->svw.flags |= SVW_COMPACT;
+                        break;
                     default:
                         goto wrongmode;
                 }
@@ -1431,6 +1528,7 @@ static void txNew(txCtx h, char *progname) {
     h->t1w.ctx = NULL;
     h->svw.ctx = NULL;
     h->svw.flags = 0;
+    h->svw.precision = 2;
     h->svr.ctx = NULL;
     h->svr.flags = 0;
     h->ufr.ctx = NULL;
@@ -1438,6 +1536,7 @@ static void txNew(txCtx h, char *progname) {
     h->ufow.ctx = NULL;
     h->ufow.flags = 0;
     h->ufr.altLayerDir = NULL;
+    h->ufr.cachePath = NULL;
     h->ctx.sfr = NULL;
 
     memInit(h);
@@ -1475,6 +1574,7 @@ static void txNew(txCtx h, char *progname) {
     dnaINIT(h->ctx.dna, h->fd.fdIndices, 16, 16);
     dnaINIT(h->ctx.dna, h->cmap.segment, 1, 1);
     dnaINIT(h->ctx.dna, h->dcf.glyph, 256, 768);
+    dnaINIT(h->ctx.dna, h->cfw.FDArray, 1, 15);
 
     setMode(h, mode_dump);
 
@@ -1508,6 +1608,7 @@ static void txFree(txCtx h) {
     dnaFREE(h->dcf.local);
     dnaFREE(h->dcf.varRegionInfo);
     dnaFREE(h->dcf.glyph);
+    dnaFREE(h->cfw.FDArray);
     dnaFREE(h->cmap.encoding);
     dnaFREE(h->fd.fdIndices);
     dnaFREE(h->cmap.segment);
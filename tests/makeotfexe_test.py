@@ -1,4 +1,5 @@
 import glob
+import json
 import os
 import pytest
 import subprocess
@@ -774,3 +775,40 @@ def test_heap_after_free_bug1349():
     output_dump = generate_ttx_dump(output_filename, ['name'])
     assert differ([output_dump, get_expected_path("bug1349.ttx"),
                    '-s', '<ttFont sfntVersion='])
+
+
+def test_family_mode():
+    formats = ['bypos', 'byindex', 'mixed']
+    actual_paths = [get_temp_file_path() for _ in formats]
+    family_path = get_temp_file_path()
+    with open(family_path, 'w') as fp:
+        fp.write('# one font per line\n')
+        for fmt, path in zip(formats, actual_paths):
+            fp.write(f'-f "{get_input_path("bug155/font.pfa")}" '
+                     f'-ff "{get_input_path(f"bug155/caret-{fmt}.fea")}" '
+                     f'-o "{path}"\n')
+    runner(CMD + ['-o', 'family', f'_{family_path}'])
+    for fmt, path in zip(formats, actual_paths):
+        actual_ttx = generate_ttx_dump(path, ['GDEF'])
+        expected_ttx = get_expected_path(f'bug155/caret-{fmt}.ttx')
+        assert differ([expected_ttx, actual_ttx, '-l', '2'])
+
+
+def test_profile_json():
+    actual_path = get_temp_file_path()
+    runner(CMD + ['-o', 'f', f'_{get_input_path("bug155/font.pfa")}',
+                  'ff', f'_{get_input_path("bug155/caret-mixed.fea")}',
+                  'o', f'_{actual_path}', 'profile', '_json'])
+    with open(f'{actual_path}.profile.json') as fp:
+        profile = json.load(fp)
+    entries = profile['entries']
+    assert entries[0]['name'] == 'hotConvert'
+    assert entries[0]['parent'] == -1
+    phases = [e['name'] for e in entries if e['kind'] == 'phase']
+    assert phases == ['hotConvert', 'setBounds', 'mapFill', 'featFill',
+                      'prepWinData', 'setVBounds', 'sfntFill', 'sfntWrite']
+    tables = [e['name'] for e in entries if e['kind'] == 'table']
+    assert 'GDEF' in tables and 'CFF ' in tables
+    for e in entries:
+        assert e['wall_ms'] >= 0 and e['allocs'] >= 0
+        assert e['peak_bytes'] >= 0
@@ -83,3 +83,17 @@ def test_camel_case():
     expected_path = generate_ps_dump(expected_path)
 
     assert differ([expected_path, actual_path, '-s', r'%ADOt1write:'])
+
+
+def test_merge_duplicate_glyphs():
+    # merging a font with itself adds no glyphs
+    font_filename = 'font1.pfa'
+    expected_path = get_temp_file_path()
+    actual_path = get_temp_file_path()
+    runner(CMD + ['-f', expected_path, font_filename])
+    runner(CMD + ['-f', actual_path, font_filename, font_filename])
+
+    expected_path = generate_ps_dump(expected_path)
+    actual_path = generate_ps_dump(actual_path)
+
+    assert differ([expected_path, actual_path, '-s', r'%ADOt1write:'])
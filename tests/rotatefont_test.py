@@ -122,3 +122,21 @@ def test_glyph_limit_error_bug1338():
     with pytest.raises(subprocess.CalledProcessError) as err:
         runner(cmd)
     assert err.value.returncode == 35
+
+
+def test_rotate_font_collection():
+    """
+    Rotating every font of a collection must apply the transform once per
+    font; installing the rotation callbacks again for the second font used
+    to make them call themselves and never return.
+    """
+    font_path = get_input_path('RgBd.ttc')
+    rt_args = ['-rt', '90', '0', '800']
+    all_fonts = subprocess.check_output(
+        [TOOL, '-dump', '-y'] + rt_args + [font_path], timeout=60)
+    dumps = all_fonts.split(b'## Filename')[1:]
+    assert len(dumps) == 2
+    for i, dump in enumerate(dumps):
+        one_font = subprocess.check_output(
+            [TOOL, '-dump', '-i', str(i)] + rt_args + [font_path])
+        assert b'## Filename' + dump == one_font
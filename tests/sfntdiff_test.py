@@ -1,10 +1,12 @@
 import os
+import re
 import subprocess
 import time
 
 import pytest
 from differ import main as differ
 from runner import main as runner
+from afdko.fdkutils import get_temp_file_path
 from test_utils import get_expected_path, get_input_path
 
 TOOL = 'sfntdiff'
@@ -54,6 +56,105 @@ def test_diff_otf_vs_ttf_bug626():
     assert differ([expected_path, actual_path, '-l', '1-4'])
 
 
+def test_diff_cmap_by_code():
+    actual_path = runner(CMD + ['-s', '-f', 'regular.otf', 'cmap_changed.otf',
+                                '-o', 'd', '_3', 'i', '_cmap'])
+    expected_path = get_expected_path('cmap.txt')
+    assert differ([expected_path, actual_path, '-l', '1-4'])
+
+
+def test_diff_cmap_format0():
+    # the fonts' (1,0) format 0 subtables only differ at 0x41
+    actual_path = runner(CMD + ['-s', '-f', 'cmap_format0.otf',
+                                'cmap_format0_changed.otf',
+                                '-o', 'd', '_3', 'i', '_cmap'])
+    expected_path = get_expected_path('cmap_format0.txt')
+    assert differ([expected_path, actual_path, '-l', '1-4'])
+
+
+def test_diff_hmtx_padding():
+    # hmtx_padded.otf only adds 4 bytes of padding to regular.otf's hmtx;
+    # the glyph count comes from maxp, so no metrics differ
+    output = subprocess.check_output(
+        [TOOL, '-d', '3', get_input_path('regular.otf'),
+         get_input_path('hmtx_padded.otf')])
+    assert b"'hmtx' table length" in output
+    assert b'hmtx nGlyphs' not in output
+    assert b'hmtx[' not in output
+
+
+def test_diff_hmtx_without_hhea():
+    # without hhea the metrics can't be decoded; compare the bytes instead
+    output = subprocess.check_output(
+        [TOOL, '-d', '3', get_input_path('no_hhea.otf'),
+         get_input_path('no_hhea_changed.otf')])
+    assert b"'hmtx' differs." in output
+
+
+def _quick_diff_lines(output):
+    # drop the per-font timing lines
+    return [line for line in output.splitlines()[4:]
+            if b' hashed in ' not in line and b' read index in ' not in line]
+
+
+def test_quick_diff():
+    actual_path = runner(CMD + ['-s', '-f', 'regular.otf', 'bold.otf',
+                                '-o', 'q'])
+    expected_path = get_expected_path('quick.txt')
+    assert differ([expected_path, actual_path, '-l', '1-4',
+                   '-r', r'^[<>]\ hashed\ in\ '])
+    with open(actual_path, 'rb') as f:
+        output = f.read()
+    assert re.search(rb'^< hashed in \d+\.\d ms$', output, re.M)
+    assert re.search(rb'^> hashed in \d+\.\d ms$', output, re.M)
+
+
+def test_quick_diff_ignores_volatile_head_fields():
+    # regular_rebuilt.otf only differs from regular.otf in
+    # head.modified and head.checkSumAdjustment
+    output = subprocess.check_output(
+        [TOOL, '-q', get_input_path('regular.otf'),
+         get_input_path('regular_rebuilt.otf')])
+    assert b'differs' not in output
+    output = subprocess.check_output(
+        [TOOL, get_input_path('regular.otf'),
+         get_input_path('regular_rebuilt.otf')])
+    assert b"'head' differs." in output
+
+
+def test_quick_diff_hash_index():
+    index_path = get_temp_file_path()
+    regular_path = get_input_path('regular.otf')
+    bold_path = get_input_path('bold.otf')
+    direct = subprocess.check_output(
+        [TOOL, '-q', '-w', index_path, regular_path, bold_path])
+    indexed = subprocess.check_output([TOOL, '-q', index_path, bold_path])
+    assert _quick_diff_lines(direct) == _quick_diff_lines(indexed)
+    assert b"'CFF ' differs." in indexed
+    assert b'< read index in ' in indexed
+    same = subprocess.check_output([TOOL, '-q', index_path, regular_path])
+    assert _quick_diff_lines(same) == []
+
+
+@pytest.mark.parametrize('quick, use_dirs', [
+    (False, False),  # -w needs -q
+    (True, True),  # the index holds a single font's hashes
+])
+def test_hash_index_usage_errors(quick, use_dirs):
+    index_path = get_temp_file_path()
+    os.remove(index_path)
+    if use_dirs:
+        input_dir = os.path.dirname(get_input_path('regular.otf'))
+        inputs = [input_dir, input_dir]
+    else:
+        inputs = [get_input_path('regular.otf'), get_input_path('bold.otf')]
+    args = (['-q'] if quick else []) + ['-w', index_path] + inputs
+    result = subprocess.run([TOOL] + args, stdout=subprocess.PIPE)
+    assert result.returncode == 1
+    assert b"ERROR: '-w' switch" in result.stdout
+    assert not os.path.exists(index_path)
+
+
 def test_not_font_files():
     stderr_path = runner(CMD + ['-s', '-e', '-f', 'not_a_font_1.otf',
                                                   'not_a_font_2.otf'])
@@ -1,10 +1,14 @@
+import os
 import pytest
+import shutil
+import struct
 import subprocess
 
 from runner import main as runner
 from differ import main as differ
 from test_utils import (get_input_path, get_expected_path, get_temp_file_path,
-                        generate_ttx_dump, font_has_table)
+                        generate_ttx_dump, font_has_table,
+                        make_truncated_font)
 
 TOOL = 'sfntedit'
 CMD = ['-t', TOOL]
@@ -13,6 +17,30 @@ LIGHT = 'light.otf'
 ITALIC = 'italic.otf'
 
 
+def _checksum(data):
+    data += b'\0' * (-len(data) % 4)
+    return sum(struct.unpack(f'>{len(data) // 4}L', data)) & 0xFFFFFFFF
+
+
+def _read_tables(path):
+    """Returns the font's tables by tag, checking each directory checksum
+    and the head table's checkSumAdjustment on the way."""
+    with open(path, 'rb') as f:
+        data = f.read()
+    num_tables = struct.unpack('>H', data[4:6])[0]
+    tables = {}
+    for i in range(num_tables):
+        tag, checksum, offset, length = struct.unpack(
+            '>4sLLL', data[12 + 16 * i:28 + 16 * i])
+        table = data[offset:offset + length]
+        if tag == b'head':
+            table = table[:8] + b'\0\0\0\0' + table[12:]
+        assert _checksum(table) == checksum, tag
+        tables[tag] = table
+    assert _checksum(data) == 0xB1B0AFBA
+    return tables
+
+
 # -----
 # Tests
 # -----
@@ -108,3 +136,85 @@ def test_missing_file_add_bug_1658():
     with open(stderr_path, 'rb') as f:
         output = f.read()
     assert b'[FATAL]: file error <No such file or directory> [non_existing_GDEF_file]' in output  # noqa: E501
+
+
+def test_script_fatal_error_skips_command_line():
+    font_path = get_input_path(LIGHT)
+    # truncated inside the table directory
+    bad_path = make_truncated_font(font_path, 100)
+    out_path = get_temp_file_path()
+    os.remove(out_path)  # script mode never overwrites an existing file
+    script_path = get_temp_file_path()
+    with open(script_path, 'w') as f:
+        f.write(f'-d DSIG {bad_path}\n-d GPOS {font_path} {out_path}\n')
+    result = subprocess.run([TOOL, '-X', script_path],
+                            stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+    assert result.returncode == 1
+    assert b'command-line abandoned after fatal error' in result.stderr
+    assert font_has_table(font_path, 'GPOS')
+    assert not font_has_table(out_path, 'GPOS')
+
+
+def test_script_collection_fatal_error_removes_output():
+    font_path = get_input_path(LIGHT)
+    core_path = get_input_path('core.otf')
+    # truncated inside the table data
+    bad_path = make_truncated_font(font_path, 3000)
+    bad_ttc_path = get_temp_file_path()
+    os.remove(bad_ttc_path)  # script mode never overwrites an existing file
+    ttc_path = get_temp_file_path()
+    os.remove(ttc_path)
+    script_path = get_temp_file_path()
+    with open(script_path, 'w') as f:
+        f.write(f'-C {bad_ttc_path} {bad_path} {core_path}\n'
+                f'-C {ttc_path} {font_path} {core_path}\n')
+    result = subprocess.run([TOOL, '-X', script_path],
+                            stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+    assert result.returncode == 1
+    assert b'command-line abandoned after fatal error' in result.stderr
+    assert not os.path.exists(bad_ttc_path)
+    assert os.path.exists(ttc_path)
+
+
+@pytest.mark.parametrize('font_filenames, ttc_filename', [
+    (['SourceSansPro-Regular.otf', 'SourceSansPro-It.otf',
+      'SourceSansPro-Bold.otf'], 'RgItBd.ttc'),
+    (['font.ttc', 'font2.ttf'], 'ttc_input.ttc'),
+    (['font0.ttf', 'font0.ttf'], 'all_shared.ttc'),
+])
+def test_build_collection(font_filenames, ttc_filename):
+    # the collection matches the one written by otf2otc
+    otc_data = os.path.join(os.path.dirname(__file__), 'otf2otc_data')
+    font_paths = [os.path.join(otc_data, 'input', name)
+                  for name in font_filenames]
+    expected_path = os.path.join(otc_data, 'expected_output', ttc_filename)
+    actual_path = get_temp_file_path()
+    runner(CMD + ['-o', 'C', f'_{actual_path}', '-f'] + font_paths)
+    assert differ([expected_path, actual_path, '-m', 'bin'])
+
+
+@pytest.mark.parametrize('in_place', [False, True])
+def test_delete_add_round_trip(in_place):
+    work_dir = os.path.dirname(get_temp_file_path())
+    font_path = os.path.join(work_dir, 'round_trip.otf')
+    shutil.copyfile(get_input_path(LIGHT), font_path)
+    orig_tables = _read_tables(font_path)
+    table_path = os.path.join(work_dir, 'round_trip.GDEF')
+    subprocess.run([TOOL, '-x', f'GDEF={table_path}', font_path], check=True)
+
+    deleted_path = font_path if in_place else get_temp_file_path()
+    # in-place edits go through sfntedit.tmp in the working directory
+    subprocess.run([TOOL, '-d', 'GDEF', font_path] +
+                   ([] if in_place else [deleted_path]),
+                   cwd=work_dir, check=True)
+    tables = _read_tables(deleted_path)
+    assert b'GDEF' not in tables
+
+    added_path = deleted_path if in_place else get_temp_file_path()
+    subprocess.run([TOOL, '-a', f'GDEF={table_path}', deleted_path] +
+                   ([] if in_place else [added_path]),
+                   cwd=work_dir, check=True)
+    tables = _read_tables(added_path)
+    assert tables == orig_tables
+    assert not os.path.exists(os.path.join(work_dir, 'sfntedit.tmp'))
+    assert not os.path.exists(os.path.join(work_dir, 'sfntedit.BAK'))
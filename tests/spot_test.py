@@ -1,11 +1,13 @@
 import pytest
 import re
+import struct
 import subprocess
 import time
 
 from runner import main as runner
 from differ import main as differ, SPLIT_MARKER
-from test_utils import get_expected_path
+from test_utils import (get_expected_path, get_input_path,
+                        get_temp_file_path, make_truncated_font)
 
 TOOL = 'spot'
 CMD = ['-t', TOOL]
@@ -162,3 +164,61 @@ def test_date_and_time(args, input_filename):
     # Make sure we actually found a date and checked it.
     # (This is to catch the case of an empty or incomplete output file.)
     assert found_date
+
+
+def test_multiple_fonts_fatal_error_skips_font():
+    font_path = get_input_path('black.otf')
+    # truncated inside the table directory
+    bad_path = make_truncated_font(font_path, 100)
+    single = subprocess.run([TOOL, '-t', 'head,name', font_path],
+                            stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+    multi = subprocess.run([TOOL, '-t', 'head,name', font_path, bad_path,
+                            font_path],
+                           stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+    assert multi.returncode == 1
+    assert b'font abandoned after fatal error' in multi.stderr
+    assert multi.stdout == single.stdout * 2
+
+
+def _table_data(path, tag):
+    with open(path, 'rb') as f:
+        data = f.read()
+    num_tables = struct.unpack('>H', data[4:6])[0]
+    for i in range(num_tables):
+        entry = data[12 + 16 * i:28 + 16 * i]
+        if entry[:4] == tag:
+            offset, length = struct.unpack('>II', entry[8:16])
+            return data[offset:offset + length]
+    return None
+
+
+def test_dump_tables_at_end_of_font():
+    """SVG and hmtx are the last tables dumped from SourceCodePro-Regular.otf.
+    Dump them from the font as is, which spot reads into memory, and from a
+    copy padded past spot's in-memory limit, which is read through the
+    buffer, and check both against the table data."""
+    font_path = get_input_path('SourceCodePro-Regular.otf')
+    padded_path = get_temp_file_path()
+    with open(font_path, 'rb') as f:
+        font_data = f.read()
+    with open(padded_path, 'wb') as f:
+        f.write(font_data)
+        f.write(b'\0' * (65 * 1024 * 1024))
+
+    outputs = []
+    for path in (font_path, padded_path):
+        result = subprocess.run([TOOL, '-t', 'SVG_,hmtx', path],
+                                stdout=subprocess.PIPE, check=True)
+        outputs.append(result.stdout)
+    assert outputs[0] == outputs[1]
+
+    dump = outputs[0].decode('latin-1').split('### [hmtx]')[0]
+    svg_data = bytes.fromhex(''.join(
+        line[10:].split('  |')[0] for line in dump.splitlines()[1:]))
+    assert svg_data == _table_data(font_path, b'SVG ')
+
+    hmtx_data = _table_data(font_path, b'hmtx')
+    lsbs = re.findall(r'\[\d+\]=(-?\d+)', outputs[0].decode('latin-1').split(
+        'leftSideBearing[index]=value')[1])
+    assert len(lsbs) == (len(hmtx_data) - 4) // 2
+    assert lsbs[-1] == str(struct.unpack('>h', hmtx_data[-2:])[0])
@@ -56,6 +56,17 @@ def get_bad_input_path(file_name):
     return os.path.join(get_data_dir(), 'input', 'bad', file_name)
 
 
+def make_truncated_font(font_path, size):
+    """Writes the first 'size' bytes of the font to a temporary file, to make
+    a damaged font for the fatal error tests, and returns its path."""
+    truncated_path = get_temp_file_path()
+    with open(font_path, 'rb') as f:
+        data = f.read(size)
+    with open(truncated_path, 'wb') as f:
+        f.write(data)
+    return truncated_path
+
+
 def generate_ttx_dump(font_path, tables=None):
     try:
         font = TTFont(font_path)
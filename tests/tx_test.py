@@ -1,8 +1,11 @@
 import os
 import pytest
 import re
+import shutil
+import struct
 import subprocess
 import time
+import zlib
 
 from afdko.fdkutils import (
     get_temp_file_path,
@@ -115,7 +118,7 @@ def test_option_error_type1_clash(arg):
     ['-cff', '-pfb'], ['-cff', '-usefd'], ['-cff', '-decid'],
     ['-cff', '-lf'], ['-cff', '-cr'], ['-cff', '-crlf'], ['-cff', '-LWFN'],
     ['-t1', '-gn0'], ['-t1', '-gn1'], ['-t1', '-gn2'], ['-t1', '-sa'],
-    ['-t1', '-abs'], ['-t1', '-cefsvg'],
+    ['-t1', '-abs'], ['-t1', '-cefsvg'], ['-t1', '-cefpre'],
     ['-t1', '-no_futile'], ['-t1', '-no_opt'], ['-t1', '-d'], ['-t1', '+d'],
     ['-dcf', '-n'], ['-dcf', '-c'],
     ['-dump', '-E'], ['-dump', '+E'], ['-dump', '-F'], ['-dump', '+F'],
@@ -170,8 +173,8 @@ def test_gone_options_bc(arg):
     ('-h', b'tx (Type eXchange) is a test harness'),
     ('-u', b'tx {[mode][mode options][shared options][files]}*'),
     ('-afm', b'[-afm options: default none]'),
-    ('-cef', b'[-cef options: default none]'),
-    ('-cff', b'[-cff options: defaults -E, -F, -O, -S, +T, -V, -Z, -b, -d]'),
+    ('-cef', b'[-cef options: defaults -K]'),
+    ('-cff', b'[-cff options: defaults -E, -F, -K, -O, -S, +T, -V, -Z, -b, -d]'),
     ('-cff2', b'[-cff2 options: defaults -S, -b]'),
     ('-dcf', b'[-dcf options: defaults -T all, -5]'),
     ('-dump', b'[-dump options: default -1]'),
@@ -373,6 +376,59 @@ def test_cef_cefsvg():
     assert differ([expected_path, output_path])
 
 
+@pytest.mark.parametrize('font_filename', [
+    'type1.pfa', 'font.ttf', 'font.cff', 'cid.otf'])
+@pytest.mark.parametrize('args', [[], ['cefsvg']])
+def test_cef_prepared_font(font_filename, args):
+    # -cefpre makes a whole font subset from a prepared font before the
+    # requested subset; the result must match a single subset of the font
+    font_path = get_input_path(font_filename)
+    expected_path = get_temp_file_path()
+    output_path = get_temp_file_path()
+    runner(CMD + ['-a', '-o', 'cef', 'F', '_Subset', 'g', '_2,3'] + args +
+           ['-f', font_path, expected_path])
+    runner(CMD + ['-a', '-o', 'cef', 'cefpre', 'F', '_Subset', 'g', '_2,3'] +
+           args + ['-f', font_path, output_path])
+    assert differ([expected_path, output_path, '-m', 'bin'])
+
+
+def _sfnt_checksum(data):
+    data += b'\0' * (-len(data) % 4)
+    return sum(struct.unpack(f'>{len(data) // 4}L', data)) & 0xFFFFFFFF
+
+
+@pytest.mark.parametrize('font_filename', [
+    'type1.pfa', 'font.ttf', 'font.cff', 'cid.otf'])
+def test_cef_checksums(font_filename):
+    # cfembed sums the tables as it writes them; recompute the checksums
+    font_path = get_input_path(font_filename)
+    output_path = get_temp_file_path()
+    runner(CMD + ['-a', '-o', 'cef', 'F', '_Subset', 'g', '_2,3',
+                  '-f', font_path, output_path])
+    with open(output_path, 'rb') as f:
+        data = f.read()
+    num_tables = struct.unpack('>H', data[4:6])[0]
+    dir_end = 12 + 16 * num_tables
+    font_sum = _sfnt_checksum(data[:dir_end])
+    tags = []
+    for i in range(num_tables):
+        tag, checksum, offset, length = struct.unpack(
+            '>4sLLL', data[12 + 16 * i:28 + 16 * i])
+        table = data[offset:offset + length]
+        if tag == b'head':
+            table = table[:8] + b'\0\0\0\0' + table[12:]
+        assert _sfnt_checksum(table) == checksum, tag
+        font_sum += checksum
+        tags.append(tag)
+    if b'head' in tags:
+        assert _sfnt_checksum(data) == 0xB1B0AFBA
+    else:
+        # no checkSumAdjustment is written without a head table, but the
+        # file must still sum to the header and table checksums it is
+        # derived from
+        assert _sfnt_checksum(data) == font_sum & 0xFFFFFFFF
+
+
 @pytest.mark.parametrize('file_ext', [
     'pfa', 'pfabin', 'pfb', 'lwfn', 'bidf'])  # TODO: 'bidf85'
 def test_type1_inputs(file_ext):
@@ -771,6 +827,16 @@ def test_ufo_self_closing_dict_element_bug701():
     assert differ([expected_path, actual_path, '-s', '## Filename'])
 
 
+def test_ufo_component_lib_after_outline():
+    """ A component glyph whose <lib> element follows its outline is read
+        without being recorded for replay; both references must still be
+        drawn in full. """
+    actual_path = runner(CMD + ['-s', '-o', 'dump', '6', 'g', '_base,comp',
+                                '-f', 'component-lib-after-outline.ufo'])
+    expected_path = get_expected_path('component-lib-after-outline.txt')
+    assert differ([expected_path, actual_path, '-s', '## Filename'])
+
+
 def test_ufo3_guideline_bug705():
     actual_path = runner(CMD + ['-s', '-o', 't1', '-f', 'bug705.ufo'])
     expected_path = get_expected_path('bug705.pfa')
@@ -827,6 +893,27 @@ def test_svg_with_cid_font_bug822():
     assert differ([expected_path, cid_path])
 
 
+@pytest.mark.parametrize('font_filename, args, exp_filename', [
+    ('cid.otf', ['c'], 'cid_compact.svg'),
+    ('pfa-start-pt-with-float.pfa', ['c'], 'float_compact.svg'),
+    ('pfa-start-pt-with-float.pfa', ['c', 'd', '_0'], 'float_compact_d0.svg'),
+])
+def test_svg_compact(font_filename, args, exp_filename):
+    font_path = get_input_path(font_filename)
+    svg_path = get_temp_file_path()
+    runner(CMD + ['-a', '-o', 'svg'] + args + ['-f', font_path, svg_path])
+    expected_path = get_expected_path(exp_filename)
+    assert differ([expected_path, svg_path,
+                   '-s', '<!-- Copyright: Copyright'])
+
+
+@pytest.mark.parametrize('precision', [
+    '-1', '5', 'x', '', '0x2', '010', '4294967296'])
+def test_svg_bad_precision(precision):
+    font_path = get_input_path('cid.otf')
+    assert subprocess.call([TOOL, '-svg', '-d', precision, font_path]) == 1
+
+
 @pytest.mark.parametrize('filename',
                          ['type1-noPSname.pfa', 'cidfont-noPSname.ps'])
 def test_svg_missing_fontname_bug883(filename):
@@ -1094,6 +1181,42 @@ def test_pdf_single_glyph():
     assert differ([expected_path, output_path] + skip)
 
 
+@pytest.mark.parametrize('font_filename', ['font.otf', 'cid.otf'])
+def test_pdf_compressed(font_filename):
+    input_path = get_input_path(font_filename)
+    output_dir = get_temp_dir_path()
+    plain_path = os.path.join(output_dir, 'plain.pdf')
+    flate_path = os.path.join(output_dir, 'flate.pdf')
+
+    runner(CMD + ['-a', '-o', 'pdf', '1', '-f', input_path, plain_path])
+    runner(CMD + ['-a', '-o', 'pdf', '1', 'z', '-f', input_path, flate_path])
+
+    with open(plain_path, 'rb') as f:
+        plain = f.read()
+    with open(flate_path, 'rb') as f:
+        flate = f.read()
+    assert len(flate) < len(plain)
+
+    # same pages, and every stream inflates to its stated length
+    count = re.compile(rb'/Count (\d+)')
+    assert count.search(flate).group(1) == count.search(plain).group(1)
+    streams = list(re.finditer(
+        rb'/Length (\d+) /Filter /FlateDecode >>\nstream\n', flate))
+    assert len(streams) > 0
+    for match in streams:
+        end = match.end() + int(match.group(1))
+        zlib.decompress(flate[match.end():end])
+        assert flate[end:end + 10] == b'\nendstream'
+
+    # xref offsets point at their objects
+    startxref = int(re.search(rb'startxref\n(\d+)', flate).group(1))
+    xref = re.match(rb'xref\n0 (\d+)\n', flate[startxref:])
+    entries = startxref + xref.end()
+    for i in range(1, int(xref.group(1))):
+        offset = int(flate[entries + 20 * i:entries + 20 * i + 10])
+        assert flate[offset:].startswith(b'%d 0 obj' % i)
+
+
 def test_cffread_bug1343():
     """
     Check FontBBox values
@@ -1201,6 +1324,30 @@ def test_pfa_to_ufo_float_points():
     assert differ([expected_path, output_path])
 
 
+@pytest.mark.parametrize('fmt', ['pfa', 'pfb'])
+def test_t1_many_glyphs_roundtrip(fmt):
+    """ Converts a font with more glyphs than the initial size of t1read's
+        glyph name table to Type 1 and reads it back; every glyph must keep
+        its name, width and bounds, in the original order.
+    """
+    input_path = get_input_path('SourceCodeVariable-Roman.otf')
+    t1_path = get_temp_file_path()
+    args = ['-t1', input_path, t1_path]
+    if fmt == 'pfb':
+        args.insert(1, '-pfb')
+    subprocess.check_call([TOOL] + args)
+
+    def glyph_metrics(path):
+        mtx = subprocess.check_output([TOOL, '-mtx', path]).decode()
+        # drop the encoding field; the Type 1 font uses StandardEncoding
+        return [re.sub(r'^(glyph\[\d+\] \{[^,]+),[^,]+,', r'\1,', line)
+                for line in mtx.splitlines() if line.startswith('glyph[')]
+
+    expected = glyph_metrics(input_path)
+    assert len(expected) > 1024
+    assert glyph_metrics(t1_path) == expected
+
+
 @pytest.mark.parametrize('input, expected, output', [
     ('line.pfa', 'line.ufo', 'tmp1.ufo'),
     ('curve-diff-sides.pfa', 'curve-diff-sides.ufo', 'tmp2.ufo'),
@@ -1691,3 +1838,74 @@ def test_parsing_attrs_bug1673():
     expected_path = generate_ps_dump(expected_path)
     output_path = generate_ps_dump(output_path)
     assert differ([expected_path, output_path, '-s', PFA_SKIP[0]])
+
+
+def test_ufo_glif_cache():
+    """
+    Reading a UFO with -glifCache gives the same result as without it, both
+    when the cache file is created and when it is used, and picks up changes
+    to glif files (including ones used as components). The cache file is
+    kept outside the UFO, which isn't modified.
+    """
+    ufo_path = get_temp_dir_path('overlaps.ufo')
+    shutil.copytree(get_input_path('overlaps.ufo'), ufo_path)
+    cache_path = get_temp_file_path()
+    os.remove(cache_path)
+
+    def dump(*args):
+        return subprocess.check_output([TOOL, '-dump', '-6'] + list(args) +
+                                       [ufo_path])
+
+    def ufo_files():
+        return sorted(os.path.join(root, name)
+                      for root, _, names in os.walk(ufo_path)
+                      for name in names)
+
+    ufo_contents = ufo_files()
+    expected = dump()
+    assert dump('-glifCache', cache_path) == expected
+    assert os.path.isfile(cache_path)
+    assert dump('-glifCache', cache_path) == expected
+    assert ufo_files() == ufo_contents
+
+    glif_path = os.path.join(ufo_path, 'glyphs', 'C_.glif')
+    with open(glif_path) as f:
+        glif = f.read()
+    edited = re.sub(r'<point x="(-?\d+)"',
+                    lambda m: f'<point x="{int(m.group(1)) + 5}"', glif,
+                    count=1)
+    assert edited != glif
+    with open(glif_path, 'w') as f:
+        f.write(edited)
+
+    expected = dump()
+    assert dump('-glifCache', cache_path) == expected
+    assert dump('-glifCache', cache_path) == expected
+
+    # a cache file that can't be written is not an error
+    unwritable_path = os.path.join(cache_path, 'no_such_dir', 'cache')
+    assert dump('-glifCache', unwritable_path) == expected
+    assert ufo_files() == ufo_contents
+
+
+@pytest.mark.parametrize('subset', [[], ['g', '_0-60']])
+def test_cff_keep_subrs(subset):
+    """
+    With +K the source font's subrs are kept, pruned to the glyph subset and
+    renumbered, and the glyphs are unchanged.
+    """
+    font_path = get_input_path('SourceCodeVariable-Roman.otf')
+    src_path = get_temp_file_path()
+    flat_path = get_temp_file_path()
+    keep_path = get_temp_file_path()
+    runner(CMD + ['-a', '-o', 'cff', '*S', '-f', font_path, src_path])
+    runner(CMD + ['-a', '-o', 'cff'] + subset + ['-f', src_path, flat_path])
+    runner(CMD + ['-a', '-o', 'cff', '*K'] + subset +
+           ['-f', src_path, keep_path])
+
+    def dump(path):
+        return subprocess.check_output([TOOL, '-dump', '-6', path],
+                                       stderr=subprocess.DEVNULL)
+
+    assert dump(keep_path) == dump(flat_path)
+    assert os.path.getsize(keep_path) < os.path.getsize(flat_path)